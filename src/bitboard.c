@@ -0,0 +1,163 @@
+/**@file
+ * Implementation of bitboards of small gamma game boards.
+ *
+ * @author Antoni Koszowski <a.koszowski@students.mimuw.edu.pl>
+ * @copyright
+ * @date 17.06.2020
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "bitboard.h"
+
+bitboard_t *alloc_bitboard(uint32_t width, uint32_t height,
+                           uint32_t players_num) {
+    uint32_t y;
+
+    if (width > BITBOARD_SIDE || height > BITBOARD_SIDE) {
+        return NULL;
+    }
+
+    bitboard_t *bb = malloc(sizeof(struct bitboard));
+    if (bb == NULL) {
+        return NULL;
+    }
+
+    bb->owned = calloc((uint64_t) players_num + 1, sizeof(uint64_t *));
+    if (bb->owned == NULL) {
+        free(bb);
+
+        return NULL;
+    }
+
+    bb->width = width;
+    bb->height = height;
+    bb->players_num = players_num;
+    bb->row_mask = width == BITBOARD_SIDE ? UINT64_MAX :
+                   ((uint64_t) 1 << width) - 1;
+
+    // Rows beyond the board are kept empty, so that they can be read.
+    for (y = 0; y < BITBOARD_SIDE; ++y) {
+        bb->free[y] = y < height ? bb->row_mask : 0;
+    }
+
+    return bb;
+}
+
+bitboard_t *clone_bitboard(const bitboard_t *bb) {
+    uint64_t i;
+
+    bitboard_t *copy = malloc(sizeof(struct bitboard));
+    if (copy == NULL) {
+        return NULL;
+    }
+
+    *copy = *bb;
+    copy->owned = calloc((uint64_t) bb->players_num + 1, sizeof(uint64_t *));
+    if (copy->owned == NULL) {
+        free(copy);
+
+        return NULL;
+    }
+
+    for (i = 1; i <= bb->players_num; ++i) {
+        if (bb->owned[i] == NULL) {
+            continue;
+        }
+
+        copy->owned[i] = malloc(sizeof(uint64_t) * BITBOARD_SIDE);
+        if (copy->owned[i] == NULL) {
+            delete_bitboard(copy);
+
+            return NULL;
+        }
+
+        memcpy(copy->owned[i], bb->owned[i], sizeof(uint64_t) * BITBOARD_SIDE);
+    }
+
+    return copy;
+}
+
+void delete_bitboard(bitboard_t *bb) {
+    uint64_t i;
+
+    if (bb == NULL) {
+        return;
+    }
+
+    for (i = 0; i <= bb->players_num; ++i) {
+        free(bb->owned[i]);
+    }
+
+    free(bb->owned);
+    free(bb);
+}
+
+/**@brief Gives rows of player's fields.
+ * Gives rows of fields of player @p player_id in bitboards pointed
+ * by @p bb, allocating them if player has not placed a piece yet.
+ * Terminates the program if memory could not be allocated.
+ * @param[in,out] bb      – pointer to the bitboards,
+ * @param[in] player_id   – player identifier.
+ * @return Pointer to the rows.
+ */
+static uint64_t *player_rows(bitboard_t *bb, uint32_t player_id) {
+    if (bb->owned[player_id] == NULL) {
+        bb->owned[player_id] = calloc(BITBOARD_SIDE, sizeof(uint64_t));
+        if (bb->owned[player_id] == NULL) {
+            exit(1);
+        }
+    }
+
+    return bb->owned[player_id];
+}
+
+void move_bit(bitboard_t *bb, uint32_t x, uint32_t y, uint32_t old_owner,
+              uint32_t new_owner) {
+    uint64_t bit = (uint64_t) 1 << x;
+
+    if (old_owner == 0) {
+        bb->free[y] &= ~bit;
+    } else {
+        player_rows(bb, old_owner)[y] &= ~bit;
+    }
+
+    if (new_owner == 0) {
+        bb->free[y] |= bit;
+    } else {
+        player_rows(bb, new_owner)[y] |= bit;
+    }
+}
+
+uint64_t adjacent_row(const bitboard_t *bb, uint32_t player_id, uint32_t y) {
+    const uint64_t *rows = bb->owned[player_id];
+    uint64_t bits;
+
+    if (rows == NULL) {
+        return 0;
+    }
+
+    bits = (rows[y] << 1) | (rows[y] >> 1);
+    if (y > 0) {
+        bits |= rows[y - 1];
+    }
+    if (y + 1 < BITBOARD_SIDE) {
+        bits |= rows[y + 1];
+    }
+
+    return bits & ~rows[y] & bb->row_mask;
+}
+
+uint64_t rivals_row(const bitboard_t *bb, uint32_t player_id, uint32_t y) {
+    uint64_t bits = ~bb->free[y] & bb->row_mask;
+
+    if (bb->owned[player_id] != NULL) {
+        bits &= ~bb->owned[player_id][y];
+    }
+
+    return y < bb->height ? bits : 0;
+}
+
+uint32_t lowest_bit(uint64_t bits) {
+    return (uint32_t) __builtin_ctzll(bits);
+}
@@ -0,0 +1,108 @@
+/**@file
+ * Interface of bitboards of small gamma game boards.
+ *
+ * Boards not wider and not higher than @ref BITBOARD_SIDE are additionally
+ * stored as bitboards, one word per row, for free fields and for fields
+ * of every player who has placed a piece. Fields adjacent to player's areas
+ * are then given for a whole row by a few bitwise operations.
+ * A board has at most @ref BITBOARD_SIDE rows, so fields adjacent to a
+ * player on the whole board take at most a few hundred word operations.
+ * What is left of a scan is checking candidates for golden move one by one,
+ * which is why only set bits of rivals' fields are visited.
+ *
+ * @author Antoni Koszowski <a.koszowski@students.mimuw.edu.pl>
+ * @copyright
+ * @date 17.06.2020
+ */
+
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <stdint.h>
+
+/**
+ * Maximal width and height of board stored as bitboards.
+ */
+#define BITBOARD_SIDE 64
+
+/**
+ * Structure storing bitboards of gamma game board.
+ */
+typedef struct bitboard {
+    uint32_t width;             ///< width of the board
+    uint32_t height;            ///< height of the board
+    uint32_t players_num;       ///< number of players
+    uint64_t row_mask;          ///< bits of fields in a row
+    uint64_t free[BITBOARD_SIDE]; ///< rows of free fields
+    uint64_t **owned;           ///< rows of fields of players, NULL if none
+} bitboard_t;
+
+/**@brief Creates bitboards of an empty board.
+ * Allocates memory for bitboards of an empty board of width @p width
+ * and height @p height, for @p players_num players.
+ * @param[in] width       – width of the board,
+ * @param[in] height      – height of the board,
+ * @param[in] players_num – number of players.
+ * @return Pointer to the newly created structure or NULL in case of
+ * memory was not allocated or the board is too large.
+ */
+bitboard_t *alloc_bitboard(uint32_t width, uint32_t height,
+                           uint32_t players_num);
+
+/**@brief Copies bitboards.
+ * Allocates memory for a copy of bitboards pointed by @p bb.
+ * @param[in] bb          – pointer to the copied structure.
+ * @return Pointer to the newly created structure or NULL in case of
+ * memory was not allocated.
+ */
+bitboard_t *clone_bitboard(const bitboard_t *bb);
+
+/**@brief Deletes bitboards.
+ * Deletes from memory bitboards pointed by @p bb.
+ * Nothing happens if the pointer's value is NULL.
+ * @param[in] bb          – pointer to structure that will be removed.
+ */
+void delete_bitboard(bitboard_t *bb);
+
+/**@brief Changes owner of the field.
+ * Moves field with coordinates @p x, @p y in bitboards pointed by @p bb
+ * from owner @p old_owner to owner @p new_owner, where zero stands
+ * for free fields.
+ * Terminates the program if memory could not be allocated.
+ * @param[in,out] bb      – pointer to the bitboards,
+ * @param[in] x           – field x-coordinate,
+ * @param[in] y           – field y-coordinate,
+ * @param[in] old_owner   – previous owner of the field,
+ * @param[in] new_owner   – new owner of the field.
+ */
+void move_bit(bitboard_t *bb, uint32_t x, uint32_t y, uint32_t old_owner,
+              uint32_t new_owner);
+
+/**@brief Gives fields adjacent to player's areas in a row.
+ * Gives bits of fields in row @p y, which are adjacent to fields
+ * of player @p player_id in bitboards pointed by @p bb.
+ * @param[in] bb          – pointer to the bitboards,
+ * @param[in] player_id   – player identifier,
+ * @param[in] y           – number of the row.
+ * @return Bits of adjacent fields.
+ */
+uint64_t adjacent_row(const bitboard_t *bb, uint32_t player_id, uint32_t y);
+
+/**@brief Gives fields of other players in a row.
+ * Gives bits of fields in row @p y, which are occupied by players other
+ * than player @p player_id in bitboards pointed by @p bb.
+ * @param[in] bb          – pointer to the bitboards,
+ * @param[in] player_id   – player identifier,
+ * @param[in] y           – number of the row.
+ * @return Bits of fields of other players.
+ */
+uint64_t rivals_row(const bitboard_t *bb, uint32_t player_id, uint32_t y);
+
+/**@brief Gives number of the lowest set bit.
+ * Gives number of the least significant bit set in @p bits.
+ * @param[in] bits        – non-zero word.
+ * @return Number of the lowest set bit.
+ */
+uint32_t lowest_bit(uint64_t bits);
+
+#endif /* BITBOARD_H */
@@ -8,64 +8,424 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include "board_utilities.h"
 
 /**
- * Number of directions.
+ * Structure storing scratch space used when areas are searched.
+ * Every search marks visited fields with its own number, so marks of
+ * previous searches never have to be cleared.
  */
-#define DIR 4
+struct search {
+    uint32_t last;              ///< number of the last search
+    uint32_t *visits;           ///< numbers of searches which visited fields
+    uint32_t visits_num;        ///< number of marked fields
+    uint32_t *queues[DIR];      ///< fields visited from adjacent fields
+    uint32_t queues_cap[DIR];   ///< sizes of queues
+    uint32_t group[DIR];        ///< searches that met, linked together
+    uint32_t head[DIR];         ///< first unprocessed positions in queues
+    uint32_t tail[DIR];         ///< first free positions in queues
+    uint32_t searches;          ///< number of searches started from a field
+};
 
 /**
- * Array representing x-coordinate vectors.
+ * Rank which marks roots of find&union nodes during their compaction.
  */
-static const int dirx[DIR] = {-1, 0, 0, 1};
+#define COMPACTED UINT8_MAX
+
 /**
- * Array representing y-coordinate vectors.
+ * Maximal number of find&union nodes, a multiple of size of tile.
  */
-static const int diry[DIR] = {0, 1, -1, 0};
+#define MAX_NODES (UINT32_MAX - TILE_MASK)
 
-field_t **alloc_board(uint32_t width, uint32_t height) {
-    uint32_t i;
+/**@brief Gives number of tiles.
+ * Gives number of tiles needed to store @p n elements.
+ * @param[in] n           – number of elements.
+ * @return Number of tiles.
+ */
+static uint32_t tiles_num(uint64_t n) {
+    return (uint32_t) ((n + TILE_MASK) >> TILE_BITS);
+}
+
+/**@brief Gives number of bytes storing owners.
+ * Gives the smallest number of bytes, in which identifiers of @p players_num
+ * players can be stored, leaving the largest value for the border.
+ * @param[in] players_num – number of players.
+ * @return Number of bytes storing owner of a field.
+ */
+static uint32_t owner_size(uint32_t players_num) {
+    if (players_num < UINT8_MAX) {
+        return sizeof(uint8_t);
+    } else if (players_num < UINT16_MAX) {
+        return sizeof(uint16_t);
+    }
+
+    return sizeof(uint32_t);
+}
+
+/**
+ * Accessors of owners of fields stored on a fixed number of bytes.
+ * The accessors matching width of owners are chosen once, when the board
+ * is created, so that owners are accessed without checking the width.
+ */
+struct owner_access {
+    uint32_t (*get)(const board_t *b, uint32_t f);      ///< reads an owner
+    void (*get_adj)(const board_t *b, uint32_t f,
+                    uint32_t owners[DIR]);              ///< reads neighbours
+    void (*get_around)(const board_t *b, uint32_t f,
+                       near_t *n);                      ///< reads surroundings
+    void (*set)(void *data, uint32_t i, uint32_t owner_id); ///< writes one
+    void (*get_row)(const void *data, uint32_t i, uint32_t len,
+                    uint32_t *owners);                  ///< reads a row
+    void (*set_row)(void *data, uint32_t i, uint32_t len,
+                    const uint32_t *owners);            ///< writes a row
+};
+
+/**@brief Defines accessors of owners stored in type @p type.
+ * Defines functions reading and writing owners stored in type @p type,
+ * single, of adjacent fields, around a field and a row at a time, and
+ * structure @p name of these accessors. Owner of the border is stored
+ * as value @p border, the largest one.
+ * Fields around neighbours of a field are read at indices which do not
+ * depend on read owners, so that all reads are issued at once. Index beyond
+ * the array, which can only be reached next to the border, is replaced
+ * by the field.
+ * @param name        - name of the structure of accessors,
+ * @param type        - type storing owner of a field,
+ * @param border      - stored value of owner of the border.
+ */
+#define OWNER_ACCESS(name, type, border)                                      \
+static uint32_t name##_value(const void *data, uint32_t i) {                  \
+    uint32_t owner_id = ((const type *) data)[i];                             \
+                                                                              \
+    return owner_id == (border) ? BORDER_OWNER : owner_id;                    \
+}                                                                             \
+                                                                              \
+static uint32_t name##_get(const board_t *b, uint32_t f) {                    \
+    return name##_value(b->owners[f >> TILE_BITS]->data, f & TILE_MASK);     \
+}                                                                             \
+                                                                              \
+static void name##_get_adj(const board_t *b, uint32_t f,                      \
+                           uint32_t owners[DIR]) {                            \
+    uint32_t i;                                                               \
+                                                                              \
+    for (i = 0; i < DIR; ++i) {                                               \
+        owners[i] = name##_get(b, f + b->shift[i]);                           \
+    }                                                                         \
+}                                                                             \
+                                                                              \
+static void name##_get_around(const board_t *b, uint32_t f, near_t *n) {      \
+    uint32_t i, j, g;                                                         \
+                                                                              \
+    for (i = 0; i < DIR; ++i) {                                               \
+        for (j = 0; j < DIR; ++j) {                                           \
+            g = f + b->shift[i] + b->shift[j];                                \
+            n->around[i][j] = name##_get(b, g < b->fields_num ? g : f);       \
+        }                                                                     \
+    }                                                                         \
+}                                                                             \
+                                                                              \
+static void name##_set(void *data, uint32_t i, uint32_t owner_id) {           \
+    ((type *) data)[i] = (type) owner_id;                                     \
+}                                                                             \
+                                                                              \
+static void name##_get_row(const void *data, uint32_t i, uint32_t len,        \
+                           uint32_t *owners) {                                \
+    uint32_t k;                                                               \
+                                                                              \
+    for (k = 0; k < len; ++k) {                                               \
+        owners[k] = name##_value(data, i + k);                                \
+    }                                                                         \
+}                                                                             \
+                                                                              \
+static void name##_set_row(void *data, uint32_t i, uint32_t len,              \
+                           const uint32_t *owners) {                          \
+    uint32_t k;                                                               \
+                                                                              \
+    for (k = 0; k < len; ++k) {                                               \
+        ((type *) data)[i + k] = (type) owners[k];                            \
+    }                                                                         \
+}                                                                             \
+                                                                              \
+static const owner_access_t name = {                                          \
+    name##_get, name##_get_adj, name##_get_around, name##_set, name##_get_row,  \
+    name##_set_row                                                            \
+};
+
+OWNER_ACCESS(owners8, uint8_t, UINT8_MAX)
+OWNER_ACCESS(owners16, uint16_t, UINT16_MAX)
+OWNER_ACCESS(owners32, uint32_t, UINT32_MAX)
+
+/**@brief Gives accessors of owners.
+ * Gives accessors of owners stored on @p size bytes.
+ * @param[in] size        – number of bytes storing owner of a field.
+ * @return Pointer to the accessors.
+ */
+static const owner_access_t *owner_access(uint32_t size) {
+    if (size == sizeof(uint8_t)) {
+        return &owners8;
+    } else if (size == sizeof(uint16_t)) {
+        return &owners16;
+    }
+
+    return &owners32;
+}
+
+/**@brief Gives elements of the tile that can be changed.
+ * Gives elements of size @p elem_size of tile pointed by @p *t of board
+ * pointed by @p b, like @ref own_tile. Tiles of a board without copies
+ * are not shared, so their references are not checked.
+ * Terminates the program if memory could not be allocated.
+ * @param[in] b           – pointer to the board,
+ * @param[in,out] t       – pointer to pointer to the tile,
+ * @param[in] elem_size   – size of an element.
+ * @return Pointer to elements of the tile.
+ */
+static void *own_board_tile(const board_t *b, tile_t **t, size_t elem_size) {
+    if (atomic_load_explicit(b->boards, memory_order_acquire) == 1) {
+        return (*t)->data;
+    }
+
+    return own_tile(t, elem_size);
+}
+
+/**@brief Gives owner of the field as it is stored.
+ * Gives owner of field with index @p f on board pointed by @p b,
+ * where owner of the border is given by the largest stored value.
+ * @param[in] b           – pointer to the board,
+ * @param[in] f           – index of the field.
+ * @return Identifier of the owner.
+ */
+static uint32_t read_owner(const board_t *b, uint32_t f) {
+    return b->access->get(b, f);
+}
+
+/**@brief Stores owner of the field.
+ * Stores owner @p owner_id of field with index @p f on board pointed
+ * by @p b, copying its tile first if it is shared with another board.
+ * Owner of the border is stored as the largest value.
+ * Terminates the program if memory could not be allocated.
+ * @param[in,out] b       – pointer to the board,
+ * @param[in] f           – index of the field,
+ * @param[in] owner_id    – identifier of the owner.
+ */
+static void store_owner(board_t *b, uint32_t f, uint32_t owner_id) {
+    b->access->set(own_board_tile(b, &b->owners[f >> TILE_BITS],
+                                  b->owner_size),
+                   f & TILE_MASK, owner_id);
+}
+
+/**@brief Gives the element of tiled array.
+ * Gives address of element with index @p i of array split into tiles
+ * @p t, storing elements of @p elem_size bytes.
+ * @param[in] t           – array of tiles,
+ * @param[in] i           – index of the element,
+ * @param[in] elem_size   – size of an element.
+ * @return Address of the element.
+ */
+static const void *tile_item(tile_t *const *t, uint32_t i, size_t elem_size) {
+    return t[i >> TILE_BITS]->data + (size_t) (i & TILE_MASK) * elem_size;
+}
+
+/**@brief Gives find&union node of the field.
+ * Gives node, which field with index @p f on board pointed by @p b
+ * is attached to.
+ * @param[in] b           – pointer to the board,
+ * @param[in] f           – index of the field.
+ * @return Number of the node.
+ */
+static uint32_t read_node(const board_t *b, uint32_t f) {
+    return ((uint32_t *) b->nodes[f >> TILE_BITS]->data)[f & TILE_MASK];
+}
+
+/**@brief Stores find&union node of the field.
+ * Attaches field with index @p f on board pointed by @p b to node @p node,
+ * copying its tile first if it is shared with another board.
+ * Terminates the program if memory could not be allocated.
+ * @param[in,out] b       – pointer to the board,
+ * @param[in] f           – index of the field,
+ * @param[in] node        – number of the node.
+ */
+static void write_node(board_t *b, uint32_t f, uint32_t node) {
+    uint32_t *nodes = own_board_tile(b, &b->nodes[f >> TILE_BITS],
+                                     sizeof(uint32_t));
+
+    nodes[f & TILE_MASK] = node;
+}
+
+/**@brief Gives representative of find&union node.
+ * Gives representative of node @p node on board pointed by @p b.
+ * @param[in] b           – pointer to the board,
+ * @param[in] node        – number of the node.
+ * @return Number of the representative.
+ */
+static uint32_t read_rep(const board_t *b, uint32_t node) {
+    return ((uint32_t *) b->reps[node >> TILE_BITS]->data)[node & TILE_MASK];
+}
 
-    field_t **b = malloc(sizeof(struct field *) * height);
+/**@brief Stores representative of find&union node.
+ * Stores representative @p rep of node @p node on board pointed by @p b,
+ * copying its tile first if it is shared with another board.
+ * Terminates the program if memory could not be allocated.
+ * @param[in,out] b       – pointer to the board,
+ * @param[in] node        – number of the node,
+ * @param[in] rep         – number of the representative.
+ */
+static void write_rep(board_t *b, uint32_t node, uint32_t rep) {
+    uint32_t *reps = own_board_tile(b, &b->reps[node >> TILE_BITS],
+                                    sizeof(uint32_t));
+
+    reps[node & TILE_MASK] = rep;
+}
+
+/**@brief Gives rank of find&union node.
+ * Gives rank of node @p node on board pointed by @p b.
+ * @param[in] b           – pointer to the board,
+ * @param[in] node        – number of the node.
+ * @return Rank of the node.
+ */
+static uint8_t read_rank(const board_t *b, uint32_t node) {
+    return b->ranks[node >> TILE_BITS]->data[node & TILE_MASK];
+}
+
+/**@brief Stores rank of find&union node.
+ * Stores rank @p rank of node @p node on board pointed by @p b,
+ * copying its tile first if it is shared with another board.
+ * Terminates the program if memory could not be allocated.
+ * @param[in,out] b       – pointer to the board,
+ * @param[in] node        – number of the node,
+ * @param[in] rank        – new rank.
+ */
+static void write_rank(board_t *b, uint32_t node, uint8_t rank) {
+    uint8_t *ranks = own_board_tile(b, &b->ranks[node >> TILE_BITS],
+                                    sizeof(uint8_t));
+
+    ranks[node & TILE_MASK] = rank;
+}
+
+board_t *alloc_board(uint32_t width, uint32_t height, uint32_t players_num) {
+    uint64_t stride = (uint64_t) width + 2;
+    uint64_t fields_num = stride * ((uint64_t) height + 2);
+    uint64_t i;
+    uint32_t j, *nodes;
+
+    // Indices of fields and nodes have to fit in 32 bits.
+    if (fields_num > MAX_NODES) {
+        return NULL;
+    }
+
+    board_t *b = calloc(1, sizeof(struct board));
     if (b == NULL) {
         return NULL;
     }
 
-    for (i = 0; i < height; ++i) {
-        b[i] = calloc(width, sizeof(struct field));
-        if (b[i] == NULL) {
-            if (i == 0) {
-                free(b);
+    b->boards = malloc(sizeof(atomic_uint));
+    if (b->boards == NULL) {
+        free(b);
 
-                return NULL;
-            }
+        return NULL;
+    }
+    atomic_init(b->boards, 1);
 
-            for (--i; i > 0; --i) {
-                free(b[i]);
-            }
-            free(b[0]);
-            free(b);
+    b->fields_num = (uint32_t) fields_num;
+    b->nodes_num = (uint32_t) fields_num;
+    b->nodes_cap = tiles_num(fields_num) << TILE_BITS;
+
+    b->owner_size = owner_size(players_num);
+    b->access = owner_access(b->owner_size);
+    b->owners = alloc_tiles(tiles_num(fields_num), b->owner_size);
+    b->nodes = alloc_tiles(tiles_num(fields_num), sizeof(uint32_t));
+    b->reps = alloc_tiles(tiles_num(fields_num), sizeof(uint32_t));
+    b->ranks = alloc_tiles(tiles_num(fields_num), sizeof(uint8_t));
+    if (b->owners == NULL || b->nodes == NULL || b->reps == NULL ||
+        b->ranks == NULL) {
+        delete_board(b);
+
+        return NULL;
+    }
 
-            return NULL;
+    b->width = width;
+    b->height = height;
+    b->stride = (uint32_t) stride;
+    init_zobrist(&b->zobrist, width, height);
+
+    // Left, upper, lower and right neighbour, modulo 2^32.
+    b->shift[0] = UINT32_MAX;
+    b->shift[1] = b->stride;
+    b->shift[2] = -b->stride;
+    b->shift[3] = 1;
+
+    // Every field starts free with its own node, tiles are not shared yet.
+    for (i = 0; i < tiles_num(fields_num); ++i) {
+        memset(b->owners[i]->data, 0, (size_t) b->owner_size * TILE_SIZE);
+        nodes = (uint32_t *) b->nodes[i]->data;
+
+        for (j = 0; j < TILE_SIZE; ++j) {
+            nodes[j] = (uint32_t) (i << TILE_BITS) + j;
         }
     }
 
+    // Marking fields surrounding the board.
+    for (i = 0; i < stride; ++i) {
+        store_owner(b, i, BORDER_OWNER);
+        store_owner(b, fields_num - 1 - i, BORDER_OWNER);
+    }
+    for (i = stride; i < fields_num; i += stride) {
+        store_owner(b, i - 1, BORDER_OWNER);
+        store_owner(b, i, BORDER_OWNER);
+    }
+
     return b;
 }
 
-void delete_board(field_t **b, uint32_t height) {
+board_t *clone_board(const board_t *b) {
+    board_t *copy = malloc(sizeof(struct board));
+    if (copy == NULL) {
+        return NULL;
+    }
+
+    *copy = *b;
+    copy->search = NULL;
+    copy->journal = NULL;
+    atomic_fetch_add_explicit(copy->boards, 1, memory_order_relaxed);
+    copy->owners = share_tiles(b->owners, tiles_num(b->fields_num));
+    copy->nodes = share_tiles(b->nodes, tiles_num(b->fields_num));
+    copy->reps = share_tiles(b->reps, tiles_num(b->nodes_cap));
+    copy->ranks = share_tiles(b->ranks, tiles_num(b->nodes_cap));
+    copy->bits = b->bits == NULL ? NULL : clone_bitboard(b->bits);
+    copy->live = b->live == NULL ? NULL : clone_live_set(b->live);
+
+    if (copy->owners == NULL || copy->nodes == NULL || copy->reps == NULL ||
+        copy->ranks == NULL || (b->bits != NULL && copy->bits == NULL) ||
+        (b->live != NULL && copy->live == NULL)) {
+        delete_board(copy);
+
+        return NULL;
+    }
+
+    return copy;
+}
+
+void delete_board(board_t *b) {
     if (b == NULL) {
         return;
     }
 
-    uint32_t i = height - 1;
+    delete_search(b->search);
+    delete_journal(b->journal);
+    delete_bitboard(b->bits);
+    delete_live_set(b->live);
+    delete_tiles(b->owners, tiles_num(b->fields_num));
+    delete_tiles(b->nodes, tiles_num(b->fields_num));
+    delete_tiles(b->reps, tiles_num(b->nodes_cap));
+    delete_tiles(b->ranks, tiles_num(b->nodes_cap));
 
-    while (i > 0) {
-        free(b[i]);
-        i--;
+    // References to tiles are dropped before, so that the last board
+    // does not change tiles of the deleted one.
+    if (b->boards != NULL &&
+        atomic_fetch_sub_explicit(b->boards, 1, memory_order_acq_rel) == 1) {
+        free(b->boards);
     }
-    free(b[0]);
     free(b);
 }
 
@@ -77,170 +437,936 @@ bool params_ok(uint32_t width, uint32_t height, uint32_t x, uint32_t y) {
     }
 }
 
-uint32_t field_owner(field_t *f) {
-    return f->owner_id;
+uint32_t field_index(board_t *b, uint32_t x, uint32_t y) {
+    return (y + 1) * b->stride + x + 1;
+}
+
+uint32_t field_owner(board_t *b, uint32_t f) {
+    return read_owner(b, f);
 }
 
-bool adjacent_field(field_t **b, uint32_t player_id,
-                    uint32_t width, uint32_t height, uint32_t x, uint32_t y) {
-    uint32_t i, cordx, cordy;
+bool adjacent_field(board_t *b, uint32_t player_id, uint32_t f) {
+    uint32_t i, owners[DIR];
 
+    b->access->get_adj(b, f, owners);
     for (i = 0; i < DIR; ++i) {
-        cordx = x + dirx[i];
-        cordy = y + diry[i];
+        if (owners[i] == player_id) {
+            return true;
+        }
+    }
 
-        if (params_ok(width, height, cordx, cordy)) {
-            if (field_owner(&b[cordy][cordx]) == player_id) {
-                return true;
-            }
+    return false;
+}
+
+void read_near(const board_t *b, uint32_t f, near_t *n) {
+    n->owner = b->access->get(b, f);
+    b->access->get_adj(b, f, n->adj);
+}
+
+void read_around(const board_t *b, uint32_t f, near_t *n) {
+    // Nodes of the field and of its neighbours, representative and rank
+    // of its node are needed by the move next, so they are fetched along
+    // with owners.
+    __builtin_prefetch(tile_item(b->nodes, f, sizeof(uint32_t)));
+    __builtin_prefetch(tile_item(b->nodes, f - b->stride, sizeof(uint32_t)));
+    __builtin_prefetch(tile_item(b->nodes, f + b->stride, sizeof(uint32_t)));
+    __builtin_prefetch(tile_item(b->reps, f, sizeof(uint32_t)));
+    __builtin_prefetch(tile_item(b->ranks, f, sizeof(uint8_t)));
+
+    b->access->get_around(b, f, n);
+}
+
+bool near_owner(const near_t *n, uint32_t player_id) {
+    uint32_t i;
+
+    for (i = 0; i < DIR; ++i) {
+        if (n->adj[i] == player_id) {
+            return true;
         }
     }
 
     return false;
 }
 
-void set_up_field(field_t *f, uint32_t player_id) {
-    f->owner_id = player_id;
-    f->rep = f;
-    f->rank = 0;
+uint64_t canonical_hash(board_t *b) {
+    uint64_t hashes[SYMMETRIES] = {0};
+    uint32_t x, y, f, owner_id;
+
+    for (y = 0; y < b->height; ++y) {
+        f = field_index(b, 0, y);
+
+        for (x = 0; x < b->width; ++x, ++f) {
+            owner_id = read_owner(b, f);
+            if (owner_id != 0) {
+                add_symmetric(&b->zobrist, hashes, x, y, owner_id);
+            }
+        }
+    }
+
+    return canonical_zobrist(&b->zobrist, hashes);
 }
 
-field_t *find_rep(field_t *f) {
-    if (f->rep == NULL || f->rep == f) {
-        return f;
-    } else {
-        return f->rep = find_rep(f->rep);
+/**@brief Writes owner of the field.
+ * Writes owner @p owner_id of field with index @p f on board pointed
+ * by @p b, updating hashes and bitboards of the board.
+ * @param[in,out] b       – pointer to the board,
+ * @param[in] f           – index of the field,
+ * @param[in] owner_id    – new owner.
+ */
+static void write_owner(board_t *b, uint32_t f, uint32_t owner_id) {
+    uint32_t x = f % b->stride - 1, y = f / b->stride - 1;
+
+    change_field(&b->zobrist, x, y, field_owner(b, f), owner_id);
+
+    if (b->bits != NULL) {
+        move_bit(b->bits, x, y, field_owner(b, f), owner_id);
     }
+
+    store_owner(b, f, owner_id);
 }
 
-uint32_t union_adj(field_t **b, uint32_t player_id,
-                   uint32_t width, uint32_t height, uint32_t x, uint32_t y) {
-    uint32_t i, cordx, cordy, counter = 0;
-    field_t *field_rep = find_rep(&b[y][x]), *cur_rep;
+/**@brief Sets up owner of the field.
+ * Sets up owner @p owner_id of field with index @p f on board pointed
+ * by @p b, recording the change in journal of the board.
+ * @param[in,out] b       – pointer to the board,
+ * @param[in] f           – index of the field,
+ * @param[in] owner_id    – new owner.
+ */
+static void set_owner(board_t *b, uint32_t f, uint32_t owner_id) {
+    if (b->journal != NULL && field_owner(b, f) != owner_id) {
+        record_change(b->journal, CHANGE_OWNER, f, field_owner(b, f));
+    }
 
-    for (i = 0; i < DIR; ++i) {
-        cordx = x + dirx[i];
-        cordy = y + diry[i];
-
-        if (params_ok(width, height, cordx, cordy)) {
-            if (field_owner(&b[cordy][cordx]) == player_id) {
-                cur_rep = find_rep(&b[cordy][cordx]);
-
-                if (field_rep != cur_rep) {
-                    if (field_rep->rank > cur_rep->rank) {
-                        cur_rep->rep = field_rep;
-                    } else if (field_rep->rank < cur_rep->rank) {
-                        field_rep->rep = cur_rep;
-                        field_rep = field_rep->rep;
-                    } else {
-                        cur_rep->rep = field_rep;
-                        field_rep->rank++;
-                    }
-
-                    counter++;
-                }
+    write_owner(b, f, owner_id);
+}
+
+/**@brief Attaches the field to find&union node.
+ * Attaches field with index @p f on board pointed by @p b to node @p node,
+ * recording the change in journal of the board.
+ * @param[in,out] b       – pointer to the board,
+ * @param[in] f           – index of the field,
+ * @param[in] node        – number of the node.
+ */
+static void set_node(board_t *b, uint32_t f, uint32_t node) {
+    if (b->journal != NULL && read_node(b, f) != node) {
+        record_change(b->journal, CHANGE_NODE, f, read_node(b, f));
+    }
+
+    write_node(b, f, node);
+}
+
+/**@brief Sets up representative of find&union node.
+ * Sets up representative @p rep of node @p node on board pointed by @p b,
+ * recording the change in journal of the board.
+ * @param[in,out] b       – pointer to the board,
+ * @param[in] node        – number of the node,
+ * @param[in] rep         – number of the representative.
+ */
+static void set_rep(board_t *b, uint32_t node, uint32_t rep) {
+    if (b->journal != NULL && read_rep(b, node) != rep) {
+        record_change(b->journal, CHANGE_REP, node, read_rep(b, node));
+    }
+
+    write_rep(b, node, rep);
+}
+
+/**@brief Sets up rank of find&union node.
+ * Sets up rank @p rank of node @p node on board pointed by @p b,
+ * recording the change in journal of the board.
+ * @param[in,out] b       – pointer to the board,
+ * @param[in] node        – number of the node,
+ * @param[in] rank        – new rank.
+ */
+static void set_rank(board_t *b, uint32_t node, uint8_t rank) {
+    if (b->journal != NULL && read_rank(b, node) != rank) {
+        record_change(b->journal, CHANGE_RANK, node, read_rank(b, node));
+    }
+
+    write_rank(b, node, rank);
+}
+
+/**@brief Renumbers find&union nodes.
+ * Attaches every field on board pointed by @p b to node with the same number,
+ * so that nodes left behind by fields that changed their areas are reused.
+ * Fields of each area are linked directly to the node of its first field.
+ * @param[in] b           – pointer to the board.
+ */
+static void compact_nodes(board_t *b) {
+    uint32_t f, rep, owner_id;
+
+    for (f = 0; f < b->fields_num; ++f) {
+        owner_id = field_owner(b, f);
+
+        if (owner_id != 0 && owner_id != BORDER_OWNER) {
+            write_node(b, f, find_rep(b, f));
+        }
+    }
+
+    // Marking roots with the first field of their areas.
+    for (f = 0; f < b->fields_num; ++f) {
+        owner_id = field_owner(b, f);
+
+        if (owner_id != 0 && owner_id != BORDER_OWNER) {
+            rep = read_node(b, f);
+
+            if (read_rank(b, rep) != COMPACTED) {
+                write_rank(b, rep, COMPACTED);
+                write_rep(b, rep, f);
             }
+
+            write_node(b, f, read_rep(b, rep));
+        } else {
+            write_node(b, f, f);
         }
     }
 
-    return counter;
+    for (f = 0; f < b->fields_num; ++f) {
+        write_rep(b, f, read_node(b, f));
+        write_rank(b, f, read_node(b, f) == f ? 1 : 0);
+        write_node(b, f, f);
+    }
+
+    b->nodes_num = b->fields_num;
 }
 
-/**@brief Sets all fields attribute visited to true.
- * Sets all fields on board pointed by @p b with width @p width
- * and height @p height to true.
+/**@brief Makes room for new find&union nodes.
+ * Makes sure that @p nodes_num new nodes can be taken on board
+ * pointed by @p b, renumbering nodes or enlarging their arrays if needed.
+ * Terminates the program if memory could not be allocated.
  * @param[in] b           – pointer to the board,
- * @param[in] width       – width of the board,
- * @param[in] height      – height of the board.
+ * @param[in] nodes_num   – number of needed nodes.
+ */
+static void reserve_nodes(board_t *b, uint32_t nodes_num) {
+    uint64_t new_cap;
+    uint32_t i, old_tiles;
+    tile_t **new_reps, **new_ranks;
+
+    if (b->nodes_cap - b->nodes_num >= nodes_num) {
+        return;
+    }
+
+    // Journal refers to nodes by their numbers, so they are kept while
+    // the journal is kept.
+    if (b->journal == NULL &&
+        b->nodes_num - b->fields_num >= b->fields_num / 4) {
+        compact_nodes(b);
+
+        if (b->nodes_cap - b->nodes_num >= nodes_num) {
+            return;
+        }
+    }
+
+    new_cap = (uint64_t) b->nodes_cap + b->nodes_cap / 8 + nodes_num;
+    new_cap = (uint64_t) tiles_num(new_cap) << TILE_BITS;
+    if (new_cap > MAX_NODES) {
+        new_cap = MAX_NODES;
+    }
+
+    old_tiles = tiles_num(b->nodes_cap);
+
+    new_reps = realloc(b->reps, sizeof(tile_t *) * tiles_num(new_cap));
+    if (new_reps == NULL) {
+        exit(1);
+    }
+    b->reps = new_reps;
+
+    new_ranks = realloc(b->ranks, sizeof(tile_t *) * tiles_num(new_cap));
+    if (new_ranks == NULL) {
+        exit(1);
+    }
+    b->ranks = new_ranks;
+
+    for (i = old_tiles; i < tiles_num(new_cap); ++i) {
+        b->reps[i] = alloc_tile(sizeof(uint32_t));
+        b->ranks[i] = alloc_tile(sizeof(uint8_t));
+        if (b->reps[i] == NULL || b->ranks[i] == NULL) {
+            exit(1);
+        }
+    }
+
+    b->nodes_cap = (uint32_t) new_cap;
+}
+
+/**@brief Takes a new find&union node.
+ * Takes a new node on board pointed by @p b, forming a set on its own.
+ * Room for the node has to be reserved beforehand.
+ * @param[in] b           – pointer to the board.
+ * @return Number of the new node.
+ */
+static uint32_t new_node(board_t *b) {
+    uint32_t node = b->nodes_num;
+
+    if (b->journal != NULL) {
+        record_change(b->journal, CHANGE_NODES_NUM, 0, b->nodes_num);
+    }
+
+    b->nodes_num++;
+    set_rep(b, node, node);
+    set_rank(b, node, 0);
+
+    return node;
+}
+
+void set_up_field(board_t *b, uint32_t f, uint32_t player_id) {
+    // Node of a free field is not used by any other field.
+    uint32_t node = read_node(b, f);
+
+    set_owner(b, f, player_id);
+    set_rep(b, node, node);
+    set_rank(b, node, 0);
+}
+
+void release_field(board_t *b, uint32_t f) {
+    reserve_nodes(b, 1);
+
+    // Former node may still link other fields of the area.
+    set_owner(b, f, 0);
+    set_node(b, f, new_node(b));
+}
+
+uint32_t new_area(board_t *b) {
+    uint32_t node;
+
+    reserve_nodes(b, 1);
+    node = new_node(b);
+    set_rank(b, node, 1);
+
+    return node;
+}
+
+void join_area(board_t *b, uint32_t f, uint32_t node) {
+    set_node(b, f, node);
+}
+
+uint32_t find_rep(board_t *b, uint32_t f) {
+    uint32_t node = read_node(b, f), rep = node, next;
+
+    while (read_rep(b, rep) != rep) {
+        rep = read_rep(b, rep);
+    }
+
+    // Compressing the path, unless changes are recorded.
+    while (b->journal == NULL && node != rep) {
+        next = read_rep(b, node);
+        write_rep(b, node, rep);
+        node = next;
+    }
+
+    return rep;
+}
+
+/**@brief Joins two find&union sets.
+ * Joins sets with distinct representatives @p rep and @p other on board
+ * pointed by @p b, attaching the one of lower rank to the other.
+ * @param[in,out] b       – pointer to the board,
+ * @param[in] rep         – representative of the first set,
+ * @param[in] other       – representative of the second set.
+ * @return Representative of the joined set.
  */
-static void set_up_visited(field_t **b, uint32_t width, uint32_t height) {
-    uint32_t i, j;
+static uint32_t join_reps(board_t *b, uint32_t rep, uint32_t other) {
+    if (read_rank(b, rep) > read_rank(b, other)) {
+        set_rep(b, other, rep);
+    } else if (read_rank(b, rep) < read_rank(b, other)) {
+        set_rep(b, rep, other);
+        rep = other;
+    } else {
+        set_rep(b, other, rep);
+        set_rank(b, rep, read_rank(b, rep) + 1);
+    }
+
+    return rep;
+}
+
+uint32_t union_adj(board_t *b, uint32_t player_id, uint32_t f) {
+    uint32_t i, adj, counter = 0, owners[DIR];
+    uint32_t field_rep = find_rep(b, f), cur_rep;
+
+    b->access->get_adj(b, f, owners);
+    for (i = 0; i < DIR; ++i) {
+        adj = f + b->shift[i];
+
+        if (owners[i] == player_id) {
+            cur_rep = find_rep(b, adj);
 
-    for (i = 0; i < height; ++i) {
-        for (j = 0; j < width; ++j) {
-            if (params_ok(width, height, j, i)) {
-                b[i][j].visited = false;
+            if (field_rep != cur_rep) {
+                field_rep = join_reps(b, field_rep, cur_rep);
+                counter++;
             }
         }
     }
+
+    return counter;
+}
+
+void restore_row(board_t *b, uint32_t y, const uint32_t *owners) {
+    uint32_t x = 0, len, f = field_index(b, 0, y);
+
+    // Owners are stored a tile at a time, hashes and bitboards are updated
+    // by the labelling pass.
+    while (x < b->width) {
+        len = TILE_SIZE - (f & TILE_MASK);
+        if (len > b->width - x) {
+            len = b->width - x;
+        }
+
+        b->access->set_row(own_board_tile(b, &b->owners[f >> TILE_BITS],
+                                          b->owner_size),
+                           f & TILE_MASK, len, owners + x);
+        x += len;
+        f += len;
+    }
 }
 
-/**@brief Searches and updates all fields in the current area.
- * Searches and updates all fields belonging to the player @p player_id
- * on board pointed by @p b with width @p width and height @p height
- * in the current area represented by field @p cur_rep.
- * Making next search from current field (@p x, @p y).
+/**@brief Reads owners of a row of fields.
+ * Stores in @p row owners of fields of row @p y on board pointed by @p b,
+ * including fields of the border on both ends of the row, or owners
+ * of the border if the row is outside of the board.
  * @param[in] b           – pointer to the board,
- * @param[in] cur_rep     – pointer to field representing current area,
- * @param[in] player_id   – player owning current area,
- * @param[in] width       – width of the board,
- * @param[in] height      – height of the board,
- * @param[in] x           – number of column of the current field,
- * @param[in] y           – number of row od the current field.
+ * @param[in] y           – row number, can be one row beyond the board,
+ * @param[out] row        – array of @p b->stride owners.
  */
-static void dfs(field_t **b, field_t *cur_rep, uint32_t player_id,
-                uint32_t width, uint32_t height, uint32_t x, uint32_t y) {
-    uint32_t i, cordx, cordy;
+static void read_row(board_t *b, uint64_t y, uint32_t *row) {
+    uint32_t x, f, len;
+
+    if (y >= b->height) {
+        for (x = 0; x < b->stride; ++x) {
+            row[x] = BORDER_OWNER;
+        }
+
+        return;
+    }
 
-    b[y][x].rep = cur_rep;
-    b[y][x].visited = true;
+    // Owners are read a tile at a time.
+    f = field_index(b, 0, (uint32_t) y) - 1;
+    for (x = 0; x < b->stride; x += len, f += len) {
+        len = TILE_SIZE - (f & TILE_MASK);
+        if (len > b->stride - x) {
+            len = b->stride - x;
+        }
+
+        b->access->get_row(b->owners[f >> TILE_BITS]->data, f & TILE_MASK,
+                           len, row + x);
+    }
+}
+
+/**@brief Counts free fields adjacent to areas.
+ * Counts free field in column @p x of row @p cur once for every player
+ * owning adjacent fields in rows @p up, @p cur and @p down, in array @p p.
+ * @param[in,out] p       – pointer to array storing state of players,
+ * @param[in] up          – owners of the row above,
+ * @param[in] cur         – owners of the row,
+ * @param[in] down        – owners of the row below,
+ * @param[in] x           – column number, including the border.
+ */
+static void count_border(player_t **p, const uint32_t *up, const uint32_t *cur,
+                         const uint32_t *down, uint32_t x) {
+    uint32_t i, j, adj[DIR] = {cur[x - 1], up[x], down[x], cur[x + 1]};
 
     for (i = 0; i < DIR; ++i) {
-        cordx = x + dirx[i];
-        cordy = y + diry[i];
+        for (j = 0; j < i && adj[j] != adj[i]; ++j) {
+        }
+
+        if (adj[i] != 0 && adj[i] != BORDER_OWNER && j == i) {
+            p[adj[i]]->border_fields++;
+        }
+    }
+}
+
+void label_areas(board_t *b, player_t **p, uint32_t players_num) {
+    uint32_t x, y, i, f, rep, left_rep = 0, up_rep, owner_id;
+    uint32_t *rows, *up, *cur, *down, *swap;
+
+    rows = malloc(sizeof(uint32_t) * 3 * b->stride);
+    if (rows == NULL) {
+        exit(1);
+    }
+
+    // Every node starts as a root of rank zero.
+    for (i = 0; i < tiles_num(b->nodes_cap); ++i) {
+        memset(own_board_tile(b, &b->ranks[i], sizeof(uint8_t)), 0, TILE_SIZE);
+    }
+
+    // Owners are read once, a row ahead, for the row and its neighbours.
+    up = rows;
+    cur = rows + b->stride;
+    down = rows + 2 * b->stride;
+    for (x = 0; x < b->stride; ++x) {
+        up[x] = BORDER_OWNER;
+    }
+    read_row(b, 0, cur);
+
+    for (y = 0; y < b->height; ++y) {
+        read_row(b, (uint64_t) y + 1, down);
+        f = field_index(b, 0, y);
+
+        for (x = 1; x <= b->width; ++x, ++f) {
+            owner_id = cur[x];
+
+            if (owner_id == 0) {
+                count_border(p, up, cur, down, x);
+                continue;
+            }
+
+            p[owner_id]->busy_fields++;
+            if (b->bits != NULL) {
+                move_bit(b->bits, x - 1, y, 0, owner_id);
+            }
 
-        if (params_ok(width, height, cordx, cordy)) {
-            if (field_owner(&b[cordy][cordx]) == player_id) {
-                if (!b[cordy][cordx].visited) {
-                    dfs(b, cur_rep, player_id, width, height, cordx, cordy);
+            // Field to the left is labelled just before, so the root of its
+            // area is known.
+            if (cur[x - 1] == owner_id) {
+                rep = left_rep;
+                write_rep(b, f, rep);
+            } else {
+                rep = f;
+                write_rep(b, f, rep);
+                p[owner_id]->busy_areas++;
+            }
+
+            // Areas of the left and upper field are already joined
+            // through the upper left field, if it has the same owner.
+            if (up[x] == owner_id &&
+                (cur[x - 1] != owner_id || up[x - 1] != owner_id)) {
+                up_rep = find_rep(b, f - b->stride);
+
+                if (up_rep != rep) {
+                    rep = join_reps(b, rep, up_rep);
+                    p[owner_id]->busy_areas--;
                 }
             }
+
+            left_rep = rep;
+        }
+
+        add_row(&b->zobrist, y, cur + 1, b->width);
+        swap = up;
+        up = cur;
+        cur = down;
+        down = swap;
+    }
+
+    free(rows);
+
+    if (b->live != NULL) {
+        for (i = 1; i <= players_num; ++i) {
+            update_live_set(b->live, i, p[i]);
+        }
+    }
+}
+
+search_t *alloc_search(void) {
+    return calloc(1, sizeof(struct search));
+}
+
+void delete_search(search_t *s) {
+    uint32_t i;
+
+    if (s == NULL) {
+        return;
+    }
+
+    for (i = 0; i < DIR; ++i) {
+        free(s->queues[i]);
+    }
+    free(s->visits);
+    free(s);
+}
+
+bool prepare_search(board_t *b, search_t *s) {
+    if (s->visits_num >= b->fields_num) {
+        return true;
+    }
+
+    free(s->visits);
+    s->visits_num = 0;
+
+    // Fresh marks are older than any search.
+    s->visits = calloc(b->fields_num, sizeof(uint32_t));
+    if (s->visits == NULL) {
+        return false;
+    }
+    s->visits_num = b->fields_num;
+
+    return true;
+}
+
+/**@brief Prepares scratch space for a new search.
+ * Allocates marks of fields of board pointed by @p b in scratch space pointed
+ * by @p s if needed and gives number of a new search, reserving also
+ * @p DIR following numbers.
+ * Terminates the program if memory could not be allocated.
+ * @param[in] b           – pointer to the board,
+ * @param[in,out] s       – pointer to the scratch space.
+ * @return Number of the new search.
+ */
+static uint32_t new_search(board_t *b, search_t *s) {
+    if (!prepare_search(b, s)) {
+        exit(1);
+    }
+
+    if (s->last > UINT32_MAX - 2 * (DIR + 1)) {
+        memset(s->visits, 0, sizeof(uint32_t) * s->visits_num);
+        s->last = 0;
+    }
+
+    s->last += DIR + 1;
+
+    return s->last;
+}
+
+/**@brief Appends field to the queue of a search.
+ * Appends field with index @p f to the queue number @p q in scratch space
+ * pointed by @p s, whose first free position is @p tail.
+ * Terminates the program if memory could not be allocated.
+ * @param[in] s           – pointer to the scratch space,
+ * @param[in] q           – number of the queue,
+ * @param[in] tail        – first free position in the queue,
+ * @param[in] f           – index of the appended field.
+ */
+static void push_field(search_t *s, uint32_t q, uint32_t tail, uint32_t f) {
+    uint32_t *new_queue, new_cap;
+
+    if (tail == s->queues_cap[q]) {
+        new_cap = s->queues_cap[q] < 32 ? 32 : s->queues_cap[q];
+        new_cap += new_cap < UINT32_MAX / 2 ? new_cap : UINT32_MAX / 2;
+
+        new_queue = realloc(s->queues[q], sizeof(uint32_t) * new_cap);
+        if (new_queue == NULL) {
+            exit(1);
         }
+
+        s->queues[q] = new_queue;
+        s->queues_cap[q] = new_cap;
+    }
+
+    s->queues[q][tail] = f;
+}
+
+/**@brief Finds group of searches.
+ * Finds group of searches that search number @p q belongs to,
+ * where searches that met are joined in scratch space pointed by @p s.
+ * @param[in] s           – pointer to the scratch space,
+ * @param[in] q           – number of the search.
+ * @return Number of search representing the group.
+ */
+static uint32_t find_group(search_t *s, uint32_t q) {
+    while (s->group[q] != q) {
+        q = s->group[q];
     }
+
+    return q;
 }
 
-uint32_t divide_adj(field_t **b, uint32_t player_id,
-                    uint32_t width, uint32_t height, uint32_t x, uint32_t y) {
-    uint32_t i, cordx, cordy, counter = 0;
-    field_t *cur_rep;
+/**@brief Checks whether group of searches is finished.
+ * Checks whether all searches from the group represented by @p rep,
+ * stored in scratch space pointed by @p s, have empty queues.
+ * @param[in] s           – pointer to the scratch space,
+ * @param[in] rep         – search representing the group.
+ * @return Value @p true if the group is finished; @p false otherwise.
+ */
+static bool group_finished(search_t *s, uint32_t rep) {
+    uint32_t q;
+
+    for (q = 0; q < s->searches; ++q) {
+        if (s->head[q] != s->tail[q] && find_group(s, q) == rep) {
+            return false;
+        }
+    }
+
+    return true;
+}
 
-    set_up_visited(b, width, height);
+uint32_t count_adj(board_t *b, search_t *s, uint32_t player_id, uint32_t f) {
+    uint32_t i, q, adj, cur, visit, first = new_search(b, s);
+    uint32_t unfinished = 0, counter = 0, owners[DIR];
 
-    b[y][x].visited = true;
+    // Excluded field is marked with a number of no search.
+    s->visits[f] = first + DIR;
+    s->searches = 0;
 
+    b->access->get_adj(b, f, owners);
     for (i = 0; i < DIR; ++i) {
-        cordx = x + dirx[i];
-        cordy = y + diry[i];
+        adj = f + b->shift[i];
+
+        if (owners[i] == player_id) {
+            s->visits[adj] = first + s->searches;
+            push_field(s, s->searches, 0, adj);
+            s->group[s->searches] = s->searches;
+            s->head[s->searches] = 0;
+            s->tail[s->searches] = 1;
+            s->searches++;
+        }
+    }
+
+    // Searching breadth-first from all adjacent fields in turns, until
+    // at most one group of searches that met each other is unfinished.
+    unfinished = s->searches;
+    while (unfinished > 1) {
+        for (q = 0; q < s->searches && unfinished > 1; ++q) {
+            if (s->head[q] == s->tail[q]) {
+                continue;
+            }
+
+            cur = s->queues[q][s->head[q]++];
+            b->access->get_adj(b, cur, owners);
+
+            for (i = 0; i < DIR; ++i) {
+                adj = cur + b->shift[i];
+
+                if (owners[i] != player_id) {
+                    continue;
+                }
 
-        if (params_ok(width, height, cordx, cordy)) {
-            if (field_owner(&b[cordy][cordx]) == player_id) {
-                if (!b[cordy][cordx].visited) {
-                    cur_rep = &b[cordy][cordx];
+                visit = s->visits[adj] - first;
 
-                    dfs(b, cur_rep, player_id, width, height, cordx, cordy);
-                    counter++;
+                if (visit > DIR) {
+                    s->visits[adj] = first + q;
+                    push_field(s, q, s->tail[q]++, adj);
+                } else if (visit < DIR &&
+                           find_group(s, visit) != find_group(s, q)) {
+                    s->group[find_group(s, visit)] = find_group(s, q);
+                    unfinished--;
                 }
             }
+
+            if (s->head[q] == s->tail[q] &&
+                group_finished(s, find_group(s, q))) {
+                unfinished--;
+            }
+        }
+    }
+
+    for (q = 0; q < s->searches; ++q) {
+        if (find_group(s, q) == q) {
+            counter++;
         }
     }
 
     return counter;
 }
 
-uint64_t count_free_fields(field_t **b, uint32_t player_id,
-                           uint32_t width, uint32_t height) {
-    uint32_t i, j;
-    uint64_t counter = 0;
+uint32_t divide_adj(board_t *b, uint32_t player_id, uint32_t f) {
+    uint32_t i, q, counter, root[DIR];
+    search_t *s = b->search;
 
-    for (i = 0; i < height; ++i) {
-        for (j = 0; j < width; ++j) {
-            if (adjacent_field(b, player_id, width, height, j, i)) {
-                if (field_owner(&b[i][j]) == 0) {
-                    counter++;
-                }
+    if (s == NULL) {
+        s = b->search = alloc_search();
+        if (s == NULL) {
+            exit(1);
+        }
+    }
+
+    counter = count_adj(b, s, player_id, f);
+
+    // Every finished group forms a new area attached to a new node,
+    // the unfinished one remains attached to the former area's nodes.
+    reserve_nodes(b, s->searches);
+
+    for (q = 0; q < s->searches; ++q) {
+        root[q] = UINT32_MAX;
+
+        if (find_group(s, q) == q && group_finished(s, q)) {
+            root[q] = new_node(b);
+            set_rank(b, root[q], 1);
+        }
+    }
+
+    for (q = 0; q < s->searches; ++q) {
+        if (root[find_group(s, q)] != UINT32_MAX) {
+            for (i = 0; i < s->tail[q]; ++i) {
+                set_node(b, s->queues[q][i], root[find_group(s, q)]);
             }
         }
     }
 
     return counter;
 }
+
+uint32_t adjacent_owners(board_t *b, uint32_t f, uint32_t owners[DIR]) {
+    uint32_t i, j, cur_owner, counter = 0, adj[DIR];
+
+    b->access->get_adj(b, f, adj);
+    for (i = 0; i < DIR; ++i) {
+        cur_owner = adj[i];
+
+        for (j = 0; j < counter && owners[j] != cur_owner; ++j) {
+        }
+
+        if (cur_owner != 0 && cur_owner != BORDER_OWNER && j == counter) {
+            owners[counter++] = cur_owner;
+        }
+    }
+
+    return counter;
+}
+
+void capture_borders(board_t *b, player_t **p, uint32_t player_id,
+                     const near_t *n) {
+    uint32_t i, j, adj_owner, gained = 0;
+
+    for (i = 0; i < DIR; ++i) {
+        adj_owner = n->adj[i];
+
+        for (j = 0; j < i && n->adj[j] != adj_owner; ++j) {
+        }
+
+        // Captured field is no longer free for its neighbours.
+        if (adj_owner != 0 && adj_owner != BORDER_OWNER && j == i) {
+            change_player(b, p, adj_owner, CHANGE_BORDER_FIELDS,
+                          p[adj_owner]->border_fields - 1);
+        }
+
+        // Free neighbour becomes a border field, unless it already was one.
+        gained += adj_owner == 0 && n->around[i][0] != player_id &&
+                  n->around[i][1] != player_id &&
+                  n->around[i][2] != player_id &&
+                  n->around[i][3] != player_id;
+    }
+
+    if (gained > 0) {
+        change_player(b, p, player_id, CHANGE_BORDER_FIELDS,
+                      p[player_id]->border_fields + gained);
+    }
+}
+
+void release_borders(board_t *b, player_t **p, uint32_t player_id, uint32_t f) {
+    uint32_t i, adj, owners[DIR], owners_num, adj_owners[DIR];
+
+    b->access->get_adj(b, f, adj_owners);
+    for (i = 0; i < DIR; ++i) {
+        adj = f + b->shift[i];
+
+        if (adj_owners[i] == 0 && !adjacent_field(b, player_id, adj)) {
+            change_player(b, p, player_id, CHANGE_BORDER_FIELDS,
+                          p[player_id]->border_fields - 1);
+        }
+    }
+
+    // Released field becomes free for its neighbours.
+    owners_num = adjacent_owners(b, f, owners);
+    for (i = 0; i < owners_num; ++i) {
+        change_player(b, p, owners[i], CHANGE_BORDER_FIELDS,
+                      p[owners[i]]->border_fields + 1);
+    }
+}
+
+/**@brief Gives location of player's value.
+ * Gives pointer to value of kind @p kind of player pointed by @p player,
+ * where only one of pointers, depending on its type, is set.
+ * @param[in] player      – pointer to the player,
+ * @param[in] kind        – kind of the value,
+ * @param[out] flag       – pointer to logical value,
+ * @param[out] areas      – pointer to number of areas,
+ * @param[out] counter    – pointer to counter of fields.
+ */
+static void player_value(player_t *player, change_kind_t kind, bool **flag,
+                         uint32_t **areas, uint64_t **counter) {
+    *flag = NULL;
+    *areas = NULL;
+    *counter = NULL;
+
+    if (kind == CHANGE_IN_GAME) {
+        *flag = &player->in_game;
+    } else if (kind == CHANGE_GOLDEN_USED) {
+        *flag = &player->golden_used;
+    } else if (kind == CHANGE_BUSY_AREAS) {
+        *areas = &player->busy_areas;
+    } else if (kind == CHANGE_BUSY_FIELDS) {
+        *counter = &player->busy_fields;
+    } else if (kind == CHANGE_BORDER_FIELDS) {
+        *counter = &player->border_fields;
+    }
+}
+
+/**@brief Updates membership of the player in set of live players.
+ * Updates membership of player @p player_id in set of live players
+ * of board pointed by @p b, if value of kind @p kind, which has changed,
+ * affects it.
+ * @param[in,out] b       – pointer to the board,
+ * @param[in] p           – array of pointers to players,
+ * @param[in] player_id   – player identifier,
+ * @param[in] kind        – kind of the changed value.
+ */
+static void update_liveness(board_t *b, player_t **p, uint32_t player_id,
+                            change_kind_t kind) {
+    if (b->live != NULL && (kind == CHANGE_IN_GAME ||
+                            kind == CHANGE_GOLDEN_USED ||
+                            kind == CHANGE_BUSY_AREAS ||
+                            kind == CHANGE_BORDER_FIELDS)) {
+        update_live_set(b->live, player_id, p[player_id]);
+    }
+}
+
+void change_player(board_t *b, player_t **p, uint32_t player_id,
+                   change_kind_t kind, uint64_t value) {
+    bool *flag;
+    uint32_t *areas;
+    uint64_t *counter, old_value;
+
+    player_value(p[player_id], kind, &flag, &areas, &counter);
+    old_value = flag != NULL ? *flag : areas != NULL ? *areas : *counter;
+
+    // Status in game is refreshed from the other values, also by queries,
+    // so its changes do not forget steps that can be redone.
+    if (b->journal != NULL && old_value != value && kind == CHANGE_IN_GAME) {
+        record_derived(b->journal, kind, player_id, old_value);
+    } else if (b->journal != NULL && old_value != value) {
+        record_change(b->journal, kind, player_id, old_value);
+    }
+
+    if (kind == CHANGE_GOLDEN_USED && old_value != (value != 0)) {
+        toggle_golden(&b->zobrist, player_id);
+    }
+
+    if (flag != NULL) {
+        *flag = value != 0;
+    } else if (areas != NULL) {
+        *areas = (uint32_t) value;
+    } else {
+        *counter = value;
+    }
+
+    update_liveness(b, p, player_id, kind);
+}
+
+void restore_change(board_t *b, player_t **p, change_t *c) {
+    bool *flag;
+    uint32_t *areas;
+    uint64_t *counter, value = c->value;
+
+    if (c->kind == CHANGE_OWNER) {
+        c->value = field_owner(b, c->index);
+        write_owner(b, c->index, (uint32_t) value);
+    } else if (c->kind == CHANGE_NODE) {
+        c->value = read_node(b, c->index);
+        write_node(b, c->index, (uint32_t) value);
+    } else if (c->kind == CHANGE_REP) {
+        c->value = read_rep(b, c->index);
+        write_rep(b, c->index, (uint32_t) value);
+    } else if (c->kind == CHANGE_RANK) {
+        c->value = read_rank(b, c->index);
+        write_rank(b, c->index, (uint8_t) value);
+    } else if (c->kind == CHANGE_NODES_NUM) {
+        c->value = b->nodes_num;
+        b->nodes_num = (uint32_t) value;
+    } else {
+        player_value(p[c->index], c->kind, &flag, &areas, &counter);
+
+        if (flag != NULL) {
+            if (c->kind == CHANGE_GOLDEN_USED && *flag != (value != 0)) {
+                toggle_golden(&b->zobrist, c->index);
+            }
+
+            c->value = *flag;
+            *flag = value != 0;
+        } else if (areas != NULL) {
+            c->value = *areas;
+            *areas = (uint32_t) value;
+        } else if (counter != NULL) {
+            c->value = *counter;
+            *counter = value;
+        }
+
+        update_liveness(b, p, c->index, c->kind);
+    }
+}
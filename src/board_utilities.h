@@ -12,34 +12,111 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include "bitboard.h"
+#include "journal.h"
+#include "live_set.h"
+#include "player.h"
+#include "tiles.h"
+#include "zobrist.h"
 
 /**
- * Structure representing a field on gamma game board.
+ * Number of directions.
  */
-typedef struct field {
-    uint32_t owner_id;  ///< field owner identifier
-    uint32_t rank;      ///< rank of field necessary for find&union operations
-    struct field *rep;  ///< representative of field in terms of find&union sets
-    bool visited;       ///< attribute used by dfs algorithm
-} field_t;
+#define DIR 4
+
+/**
+ * Owner identifier of fields surrounding the board.
+ * Since players' identifiers are smaller than UINT32_MAX,
+ * such fields are neither free nor belong to any player.
+ */
+#define BORDER_OWNER UINT32_MAX
+
+/**
+ * Structure storing owners of fields around a field, read at once by a move.
+ */
+typedef struct near {
+    uint32_t owner;             ///< owner of the field
+    uint32_t adj[DIR];          ///< owners of adjacent fields
+    uint32_t around[DIR][DIR];  ///< owners of fields adjacent to them
+} near_t;
+
+/**
+ * Structure storing scratch space used when areas are searched.
+ */
+typedef struct search search_t;
+
+/**
+ * Structure storing accessors of owners of fields stored on a given width.
+ */
+typedef struct owner_access owner_access_t;
+
+/**
+ * Structure representing gamma game board.
+ * Fields are stored row by row in a single array, surrounded by one field
+ * wide border, so that every field on board has four neighbours
+ * and neighbour's index differs by a constant shift.
+ * Fields are attached to find&union nodes, which are kept apart from fields,
+ * so that a field can leave its area while other fields of the area
+ * may still be linked through its former node.
+ * Owners of fields are stored on 8, 16 or 32 bits, whichever is enough
+ * for identifiers of players and the border, and apart from nodes of fields.
+ * Arrays of fields and nodes are split into tiles shared by copies
+ * of the board, a tile is copied by the board which changes it first.
+ * Tiles of a board which has no copies are changed without checking
+ * whether they are shared.
+ */
+typedef struct board {
+    uint32_t width;         ///< width of the board
+    uint32_t height;        ///< height of the board
+    uint32_t stride;        ///< number of fields in a row, including border
+    uint32_t shift[DIR];    ///< shifts of indices of adjacent fields
+    uint32_t fields_num;    ///< number of fields, including border
+    uint32_t owner_size;    ///< number of bytes storing owner of a field
+    const owner_access_t *access; ///< accessors of owners of this width
+    tile_t **owners;        ///< tiles of owners of fields, including border
+    tile_t **nodes;         ///< tiles of find&union nodes of fields
+    uint32_t nodes_num;     ///< number of find&union nodes in use
+    uint32_t nodes_cap;     ///< number of allocated find&union nodes
+    tile_t **reps;          ///< tiles of representatives of find&union nodes
+    tile_t **ranks;         ///< tiles of ranks of find&union nodes
+    atomic_uint *boards;    ///< number of boards sharing tiles, common to them
+    search_t *search;       ///< scratch space, allocated on first split
+    journal_t *journal;     ///< journal of changes, NULL if not kept
+    zobrist_t zobrist;      ///< hashes of owners and golden moves
+    bitboard_t *bits;       ///< bitboards of small board, NULL if not kept
+    live_set_t *live;       ///< set of live players, NULL if not kept
+} board_t;
 
 /** @brief Creates a structure storing gamma game board.
- * Allocates memory for a new two-dimensional array consisting of fields
- * storing the state of gamma game board.
+ * Allocates memory for a new contiguous array consisting of fields
+ * storing the state of gamma game board, whose owners are numbered
+ * from 1 to @p players_num.
  * Initializes the structure so that is represents the initial state of board.
  * @param[in] width       – width of the board,
- * @param[in] height      – height of the board.
+ * @param[in] height      – height of the board,
+ * @param[in] players_num – number of players.
+ * @return  Pointer to the newly created structure or NULL in case of
+ * memory was not allocated or board with its border has too many fields
+ * to be indexed with 32-bit numbers.
+ */
+board_t *alloc_board(uint32_t width, uint32_t height, uint32_t players_num);
+
+/** @brief Copies a structure storing gamma game board.
+ * Allocates memory for a new board in the same state as board pointed
+ * by @p b, sharing its tiles. Takes time proportional to number of tiles.
+ * Neither scratch space nor journal of the board is copied.
+ * @param[in] b           – pointer to the copied board.
  * @return  Pointer to the newly created structure or NULL in case of
  * memory was not allocated.
  */
-field_t **alloc_board(uint32_t width, uint32_t height);
+board_t *clone_board(const board_t *b);
 
 /**@brief Deletes a structure storing gamma game board.
  * Deletes from memory structure pointed by @p b.
- * @param[in] b           – pointer to structure that will be removed,
- * @param[in] height      – height of the board to be removed.
+ * Nothing happens if the pointer's value is NULL.
+ * @param[in] b           – pointer to structure that will be removed.
  */
-void delete_board(field_t **b, uint32_t height);
+void delete_board(board_t *b);
 
 /**@brief Checks whether given field is on board.
  * Checks whether field (@p x, @p y) is on board which width is @p width
@@ -52,86 +129,269 @@ void delete_board(field_t **b, uint32_t height);
  */
 bool params_ok(uint32_t width, uint32_t height, uint32_t x, uint32_t y);
 
+/**@brief Gives index of the field.
+ * Gives index of field (@p x, @p y) on board pointed by @p b.
+ * @param[in] b           – pointer to the board,
+ * @param[in] x           – number of column, smaller than width of the board,
+ * @param[in] y           – number of row, smaller than height of the board.
+ * @return Index of the field.
+ */
+uint32_t field_index(board_t *b, uint32_t x, uint32_t y);
+
 /**@brief Gives identifier of field's owner.
- * Gives identifier of field's @p f owner.
- * @param[in] f           – pointer to the field.
+ * Gives identifier of owner of field with index @p f on board pointed by @p b.
+ * @param[in] b           – pointer to the board,
+ * @param[in] f           – index of the field.
  * @return Number which is field's owner identifier.
  */
-uint32_t field_owner(field_t *f);
+uint32_t field_owner(board_t *b, uint32_t f);
 
 /** @brief Checks if some of the adjacent fields has the same owner.
- * Checks whether some of the adjacent fields to (@p x, @p y) on board
- * pointed by @p b with width @p width and height @p height
- * has the same owner @p player_id.
+ * Checks whether some of the adjacent fields to field with index @p f
+ * on board pointed by @p b has the same owner @p player_id.
  * @param[in] b           – pointer to the board,
  * @param[in] player_id   – player owning current field,
- * @param[in] width       – width of the board,
- * @param[in] height      – height of the board,
- * @param[in] x           – number of column,
- * @param[in] y           – number of row.
+ * @param[in] f           – index of the field.
  * @return Value @p true if some of the adjacent fields has the same owner;
  * @p false otherwise.
  */
-bool adjacent_field(field_t **b, uint32_t player_id,
-                    uint32_t width, uint32_t height, uint32_t x, uint32_t y);
+bool adjacent_field(board_t *b, uint32_t player_id, uint32_t f);
+
+/**@brief Reads owners next to the field.
+ * Reads owners of field with index @p f on board pointed by @p b and
+ * of fields adjacent to it into structure pointed by @p n.
+ * @param[in] b           – pointer to the board,
+ * @param[in] f           – index of the field on board,
+ * @param[out] n          – pointer to the read owners.
+ */
+void read_near(const board_t *b, uint32_t f, near_t *n);
+
+/**@brief Reads owners around the neighbours of the field.
+ * Reads owners of fields adjacent to neighbours of field with index @p f
+ * on board pointed by @p b into structure pointed by @p n, when the field
+ * is about to be captured. Owners around a neighbour which is a part of
+ * the border are not meaningful.
+ * @param[in] b           – pointer to the board,
+ * @param[in] f           – index of the field on board,
+ * @param[in,out] n       – pointer to the read owners.
+ */
+void read_around(const board_t *b, uint32_t f, near_t *n);
+
+/** @brief Checks if some of the adjacent fields has the owner.
+ * Checks whether some of fields adjacent to field, whose surroundings
+ * are stored in structure pointed by @p n, is owned by player @p player_id.
+ * @param[in] n           – pointer to owners around the field,
+ * @param[in] player_id   – player identifier.
+ * @return Value @p true if some of the adjacent fields has the owner;
+ * @p false otherwise.
+ */
+bool near_owner(const near_t *n, uint32_t player_id);
+
+/**@brief Gives distinct owners of adjacent fields.
+ * Stores in @p owners distinct identifiers of players owning fields adjacent
+ * to field with index @p f on board pointed by @p b.
+ * @param[in] b           – pointer to the board,
+ * @param[in] f           – index of the field,
+ * @param[out] owners     – array where found owners are stored.
+ * @return Number of distinct owners stored in @p owners.
+ */
+uint32_t adjacent_owners(board_t *b, uint32_t f, uint32_t owners[DIR]);
 
-/**@brief Sets up new owner of the field.
- * Sets up new owner @p player_id of the field pointed by @p f.
- * @param[in] f           – pointer to the field to be updated,
+/**@brief Gives hash of the board not depending on its symmetries.
+ * Computes hashes of board pointed by @p b transformed by its symmetries
+ * from owners of all fields, and gives canonical hash of the board.
+ * Takes time proportional to area of the board.
+ * @param[in] b           – pointer to the board.
+ * @return Canonical hash of the board.
+ */
+uint64_t canonical_hash(board_t *b);
+
+/**@brief Sets up new owner of the free field.
+ * Sets up new owner @p player_id of the free field with index @p f
+ * on board pointed by @p b. The field forms a new area on its own.
+ * @param[in] b           – pointer to the board,
+ * @param[in] f           – index of the field to be updated,
  * @param[in] player_id   – new owner.
  */
-void set_up_field(field_t *f, uint32_t player_id);
+void set_up_field(board_t *b, uint32_t f, uint32_t player_id);
+
+/**@brief Marks the field as free.
+ * Marks field with index @p f on board pointed by @p b as free,
+ * detaching it from find&union node of its former area.
+ * @param[in] b           – pointer to the board,
+ * @param[in] f           – index of the released field.
+ */
+void release_field(board_t *b, uint32_t f);
+
+/**@brief Takes node of a new area.
+ * Takes a new find&union node on board pointed by @p b, to which fields
+ * of an area split off from another one are attached by @ref join_area.
+ * Terminates the program if memory could not be allocated.
+ * @param[in,out] b       – pointer to the board.
+ * @return Number of the new node.
+ */
+uint32_t new_area(board_t *b);
 
-/**@brief Finds representative field.
- * Finds representative field of the area which field pointed by @p f
- * is a part of.
- * @param[in] f           – pointer to the field.
- * @return Pointer to the representative field.
+/**@brief Attaches the field to the area.
+ * Attaches field with index @p f on board pointed by @p b to node @p node
+ * taken by @ref new_area.
+ * @param[in,out] b       – pointer to the board,
+ * @param[in] f           – index of the field,
+ * @param[in] node        – number of the node.
  */
-field_t *find_rep(field_t *f);
+void join_area(board_t *b, uint32_t f, uint32_t node);
+
+/**@brief Finds representative node.
+ * Finds find&union node representing the area which field with index @p f
+ * on board pointed by @p b is a part of.
+ * @param[in] b           – pointer to the board,
+ * @param[in] f           – index of the field.
+ * @return Number of the representative node.
+ */
+uint32_t find_rep(board_t *b, uint32_t f);
 
 /**@brief Joins adjacent fields. Gives number of areas that were joined.
- * Joins adjacent fields on board pointed by @p b with width @p width
- * and height @p height to field (@p x, @p y) owned by player @p player_id
- * into the same area.
+ * Joins adjacent fields on board pointed by @p b to field with index @p f
+ * owned by player @p player_id into the same area.
  * Gives number of separate areas the were joined.
  * @param[in] b           – pointer to the board,
  * @param[in] player_id   – owner of the joined area,
- * @param[in] width       – width of the board,
- * @param[in] height      – height of the board,
- * @param[in] x           – number of column of the linking field,
- * @param[in] y           – number of row of the linking field.
+ * @param[in] f           – index of the linking field.
  * @return Number of the separate areas that were joined.
  */
-uint32_t union_adj(field_t **b, uint32_t player_id,
-                   uint32_t width, uint32_t height, uint32_t x, uint32_t y);
+uint32_t union_adj(board_t *b, uint32_t player_id, uint32_t f);
+
+/**@brief Creates scratch space for searching areas.
+ * Allocates memory for a new scratch space. Marks of fields are allocated
+ * on first search, for the board being searched, and enlarged if a larger
+ * board is searched afterwards.
+ * @return Pointer to the newly created structure or NULL in case of
+ * memory was not allocated.
+ */
+search_t *alloc_search(void);
+
+/**@brief Deletes scratch space for searching areas.
+ * Deletes from memory structure pointed by @p s.
+ * Nothing happens if the pointer's value is NULL.
+ * @param[in] s           – pointer to structure that will be removed.
+ */
+void delete_search(search_t *s);
+
+/**@brief Prepares scratch space for searching the board.
+ * Allocates in scratch space pointed by @p s marks of fields of board
+ * pointed by @p b, unless they are already large enough, so that searches
+ * of the board do not allocate them.
+ * @param[in] b           – pointer to the board,
+ * @param[in,out] s       – pointer to the scratch space.
+ * @return Value @p true if marks are allocated, @p false if memory
+ * was not allocated.
+ */
+bool prepare_search(board_t *b, search_t *s);
+
+/**@brief Counts areas emerging after exclusion of the field.
+ * Gives number of areas of player @p player_id emerging after exclusion
+ * of field with index @p f on board pointed by @p b, searching them
+ * the same way as @ref divide_adj does. The board is not modified,
+ * only scratch space pointed by @p s, so that boards can be searched
+ * by many threads at once, each with its own scratch space.
+ * Terminates the program if memory for the search could not be allocated.
+ * @param[in] b           – pointer to the board,
+ * @param[in,out] s       – pointer to the scratch space,
+ * @param[in] player_id   – owner of the searched area,
+ * @param[in] f           – index of the excluded field.
+ * @return Number of areas emerging after exclusion of the field.
+ */
+uint32_t count_adj(board_t *b, search_t *s, uint32_t player_id, uint32_t f);
 
 /**@brief Splits adjacent fields. Gives a number of newly emerged areas.
- * Splits adjacent fields on board pointed by @p b with width @p width
- * and height @p height to field (@p x, @p y) owned by player @p player_id.
- * Gives a number of newly emerged areas after exclusion of field (@p x, @p y).
+ * Splits adjacent fields on board pointed by @p b to field with index @p f
+ * owned by player @p player_id.
+ * Gives a number of newly emerged areas after exclusion of the field.
+ * Areas are searched from all adjacent fields at once and the search stops
+ * as soon as at most one of them is left unexplored, so that its cost
+ * depends on smaller parts of split area only.
+ * Terminates the program if memory for the search could not be allocated.
  * @param[in] b           – pointer to the board
  * @param[in] player_id   – owner of the splited area,
- * @param[in] width       – width of the board,
- * @param[in] height      – height of the board,
- * @param[in] x           – number of column of the excluded field,
- * @param[in] y           – number of row of the excluded field.
+ * @param[in] f           – index of the excluded field.
  * @return Number of newly emerged areas.
  */
-uint32_t divide_adj(field_t **b, uint32_t player_id,
-                    uint32_t width, uint32_t height, uint32_t x, uint32_t y);
+uint32_t divide_adj(board_t *b, uint32_t player_id, uint32_t f);
+
+/**@brief Restores owners of a row of fields.
+ * Sets up owners of fields of row @p y on board pointed by @p b,
+ * given by array @p owners of width of the board, where zero stands
+ * for a free field, copying them into the tiles of the board. Neither
+ * areas nor hashes and bitboards are updated until @ref label_areas
+ * is called. Board has to be empty beforehand and its journal can not
+ * be kept.
+ * @param[in,out] b       – pointer to the board,
+ * @param[in] y           – row number,
+ * @param[in] owners      – owners of fields of the row.
+ */
+void restore_row(board_t *b, uint32_t y, const uint32_t *owners);
 
-/**@brief Gives number of free fields.
- * Gives number of free fields which player @p player_id can still capture
- * on board pointed by @p b with width @p width and height @p height.
- * @param b               – pointer to the board,
- * @param player_id       – player whose free fields will be counted,
- * @param width           – width of the board,
- * @param height          – height of the board.
- * @return Number of free fields which player can still capture.
+/**@brief Forms areas of restored fields.
+ * Joins fields restored by @ref restore_row on board pointed by @p b into
+ * areas, in a single pass over the board in which every field is joined
+ * with its upper and left neighbour, adds the fields to hashes and
+ * bitboards of the board, and counts fields, areas and free adjacent
+ * fields of each of @p players_num players in array @p p, which have
+ * to be zero beforehand. Owners are read once per field.
+ * Terminates the program if memory could not be allocated.
+ * @param[in,out] b       – pointer to the board,
+ * @param[in,out] p       – pointer to array storing state of players,
+ * @param[in] players_num – number of players.
  */
-uint64_t count_free_fields(field_t **b, uint32_t player_id,
-                           uint32_t width, uint32_t height);
+void label_areas(board_t *b, player_t **p, uint32_t players_num);
 
+/**@brief Updates border counters before the field is captured.
+ * Updates numbers of free fields adjacent to players' areas, stored in array
+ * @p p, when free field on board pointed by @p b, whose surroundings
+ * are stored in structure pointed by @p n, is about to be captured
+ * by player @p player_id. Owners are not read again.
+ * @param[in] b           – pointer to the board,
+ * @param[in,out] p       – pointer to array storing state of players,
+ * @param[in] player_id   – player capturing the field,
+ * @param[in] n           – pointer to owners around the captured field.
+ */
+void capture_borders(board_t *b, player_t **p, uint32_t player_id,
+                     const near_t *n);
+
+/**@brief Updates border counters after the field is released.
+ * Updates numbers of free fields adjacent to players' areas, stored in array
+ * @p p, when field with index @p f on board pointed by @p b is released
+ * by player @p player_id.
+ * Must be called after the field has been marked as free.
+ * @param[in] b           – pointer to the board,
+ * @param[in,out] p       – pointer to array storing state of players,
+ * @param[in] player_id   – player that has owned the field,
+ * @param[in] f           – index of the released field.
+ */
+void release_borders(board_t *b, player_t **p, uint32_t player_id, uint32_t f);
+
+/**@brief Changes value of the player.
+ * Sets up value of kind @p kind of player @p player_id, whose state
+ * is stored in array @p p, to @p value, recording the change in journal
+ * of board pointed by @p b.
+ * Terminates the program if memory could not be allocated.
+ * @param[in,out] b       – pointer to the board,
+ * @param[in,out] p       – pointer to array storing state of players,
+ * @param[in] player_id   – player identifier,
+ * @param[in] kind        – kind of the value, one of values of players,
+ * @param[in] value       – new value.
+ */
+void change_player(board_t *b, player_t **p, uint32_t player_id,
+                   change_kind_t kind, uint64_t value);
+
+/**@brief Restores recorded value.
+ * Restores value of board pointed by @p b or of player, whose state is stored
+ * in array @p p, recorded in change pointed by @p c, storing replaced value
+ * in the change. Number of free fields on board is not restored.
+ * @param[in,out] b       – pointer to the board,
+ * @param[in,out] p       – pointer to array storing state of players,
+ * @param[in,out] c       – pointer to the change.
+ */
+void restore_change(board_t *b, player_t **p, change_t *c);
 
 #endif /* BOARD_UTILITIES_H */
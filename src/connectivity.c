@@ -0,0 +1,921 @@
+/**@file
+ * Implementation of structure of dynamic connectivity of players' areas.
+ *
+ * Every field has at most four edges, so edges are numbered by fields:
+ * two per field, to its right and to its lower neighbour, and edges
+ * of a field of given level are found by checking the four of them.
+ * Nodes of splay trees are kept in arrays and numbered, a tree is given
+ * by its root. Euler tour of a tree of level i consists of a node of every
+ * field of the tree and of two nodes, called arcs, of every edge of the tree.
+ * Nodes keep numbers of fields in their subtrees and whether their subtrees
+ * hold tree edges of level i or fields with non-tree edges of level i,
+ * so that such edges are found while searching for replacements.
+ *
+ * @author Antoni Koszowski <a.koszowski@students.mimuw.edu.pl>
+ * @copyright
+ * @date 17.06.2020
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "connectivity.h"
+
+/**
+ * Node standing for an empty splay tree.
+ */
+#define NIL 0
+
+/**
+ * Level of an edge that is not in the graph.
+ */
+#define NO_EDGE UINT8_MAX
+
+/**
+ * Flag of level of an edge of spanning forest.
+ */
+#define TREE_EDGE 0x80
+
+/**
+ * Flag of node of a field, other nodes are arcs.
+ */
+#define VERTEX 1
+
+/**
+ * Flag of arc of an edge to the lower neighbour.
+ */
+#define ARC_DOWN 2
+
+/**
+ * Flag of arc of a tree edge of level of the tour, set for one of two arcs.
+ */
+#define OWN_TREE 4
+
+/**
+ * Flag of node of a field with non-tree edges of level of the tour.
+ */
+#define OWN_NONTREE 8
+
+/**
+ * Flag of subtree holding a node flagged with @ref OWN_TREE.
+ */
+#define SUB_TREE (OWN_TREE << 2)
+
+/**
+ * Flag of subtree holding a node flagged with @ref OWN_NONTREE.
+ */
+#define SUB_NONTREE (OWN_NONTREE << 2)
+
+/**
+ * Structure storing dynamic connectivity of players' areas.
+ */
+struct connectivity {
+    uint32_t fields_num;    ///< number of fields, including border
+    uint32_t stride;        ///< number of fields in a row, including border
+    uint32_t shift[DIR];    ///< shifts of indices of adjacent fields
+    uint32_t levels;        ///< number of levels of edges
+    uint8_t *edges;         ///< levels of edges, NO_EDGE if not in the graph
+    uint32_t **vertices;    ///< nodes of fields on every level, if allocated
+    uint32_t **arcs;        ///< first arcs of tree edges on every level
+    uint32_t nodes_num;     ///< number of nodes in use or freed
+    uint32_t nodes_cap;     ///< number of allocated nodes
+    uint32_t free_arcs;     ///< list of freed pairs of arcs, linked by left
+    uint32_t *left;         ///< left children of nodes
+    uint32_t *right;        ///< right children of nodes
+    uint32_t *parent;       ///< parents of nodes
+    uint32_t *size;         ///< numbers of fields in subtrees of nodes
+    uint32_t *keys;         ///< fields of nodes, lower fields for arcs
+    uint8_t *flags;         ///< flags of nodes
+    uint32_t players_num;   ///< number of players
+    bool *tracked;          ///< whether edges of player's fields are kept
+};
+
+/**@brief Gives number of the edge.
+ * Gives number of edge between field with index @p f and its neighbour
+ * in direction @p i in structure pointed by @p c.
+ * @param[in] c           – pointer to the structure,
+ * @param[in] f           – index of the field,
+ * @param[in] i           – number of the direction.
+ * @return Number of the edge.
+ */
+static uint64_t edge_of(const connectivity_t *c, uint32_t f, uint32_t i) {
+    uint32_t adj = f + c->shift[i];
+
+    if (adj - f == 1) {
+        return 2 * (uint64_t) f;
+    } else if (f - adj == 1) {
+        return 2 * (uint64_t) adj;
+    }
+
+    return 2 * (uint64_t) (f < adj ? f : adj) + 1;
+}
+
+/**@brief Gives the upper or left end of the edge.
+ * @param[in] e           – number of the edge.
+ * @return Index of the field.
+ */
+static uint32_t lower_end(uint64_t e) {
+    return (uint32_t) (e / 2);
+}
+
+/**@brief Gives the lower or right end of the edge.
+ * @param[in] c           – pointer to the structure,
+ * @param[in] e           – number of the edge.
+ * @return Index of the field.
+ */
+static uint32_t upper_end(const connectivity_t *c, uint64_t e) {
+    return lower_end(e) + (e % 2 == 1 ? c->stride : 1);
+}
+
+/**@brief Makes room for new nodes.
+ * Makes sure that @p n new nodes can be taken in structure pointed by @p c.
+ * Terminates the program if memory could not be allocated.
+ * @param[in,out] c       – pointer to the structure,
+ * @param[in] n           – number of needed nodes.
+ */
+static void reserve_nodes(connectivity_t *c, uint32_t n) {
+    uint64_t new_cap;
+
+    if (c->nodes_cap - c->nodes_num >= n) {
+        return;
+    } else if (c->nodes_num > UINT32_MAX - n) {
+        exit(1);
+    }
+
+    new_cap = (uint64_t) c->nodes_cap + c->nodes_cap / 2 + 64;
+    if (new_cap > UINT32_MAX) {
+        new_cap = UINT32_MAX;
+    }
+
+    c->left = realloc(c->left, sizeof(uint32_t) * new_cap);
+    c->right = realloc(c->right, sizeof(uint32_t) * new_cap);
+    c->parent = realloc(c->parent, sizeof(uint32_t) * new_cap);
+    c->size = realloc(c->size, sizeof(uint32_t) * new_cap);
+    c->keys = realloc(c->keys, sizeof(uint32_t) * new_cap);
+    c->flags = realloc(c->flags, sizeof(uint8_t) * new_cap);
+    if (c->left == NULL || c->right == NULL || c->parent == NULL ||
+        c->size == NULL || c->keys == NULL || c->flags == NULL) {
+        exit(1);
+    }
+
+    c->nodes_cap = (uint32_t) new_cap;
+}
+
+/**@brief Sets up a single node.
+ * Sets up node @p x in structure pointed by @p c as a tree on its own,
+ * of field or arc with key @p key and flags @p flags.
+ * @param[in,out] c       – pointer to the structure,
+ * @param[in] x           – the node,
+ * @param[in] key         – index of the field,
+ * @param[in] flags       – flags of the node.
+ */
+static void init_node(connectivity_t *c, uint32_t x, uint32_t key,
+                      uint8_t flags) {
+    c->left[x] = NIL;
+    c->right[x] = NIL;
+    c->parent[x] = NIL;
+    c->size[x] = flags & VERTEX ? 1 : 0;
+    c->keys[x] = key;
+    c->flags[x] = flags;
+}
+
+/**@brief Allocates nodes of the level.
+ * Allocates nodes of fields and arcs of edges on level @p i of structure
+ * pointed by @p c, unless they are already allocated.
+ * Terminates the program if memory could not be allocated.
+ * @param[in,out] c       – pointer to the structure,
+ * @param[in] i           – the level.
+ */
+static void reserve_level(connectivity_t *c, uint32_t i) {
+    if (i >= c->levels) {
+        exit(1);
+    } else if (c->vertices[i] != NULL) {
+        return;
+    }
+
+    c->vertices[i] = calloc(c->fields_num, sizeof(uint32_t));
+    c->arcs[i] = calloc(2 * (size_t) c->fields_num, sizeof(uint32_t));
+    if (c->vertices[i] == NULL || c->arcs[i] == NULL) {
+        exit(1);
+    }
+}
+
+/**@brief Gives node of the field.
+ * Gives node of field with index @p f on level @p i of structure
+ * pointed by @p c.
+ * @param[in] c           – pointer to the structure,
+ * @param[in] i           – the level,
+ * @param[in] f           – index of the field.
+ * @return The node or NIL if the field has no node on the level yet,
+ * that is it forms a tree on its own.
+ */
+static uint32_t vertex(const connectivity_t *c, uint32_t i, uint32_t f) {
+    return c->vertices[i] == NULL ? NIL : c->vertices[i][f];
+}
+
+/**@brief Gives node of the field, creating it if needed.
+ * Gives node of field with index @p f on level @p i of structure
+ * pointed by @p c, creating a tree of the field on its own if the field
+ * has no node.
+ * Terminates the program if memory could not be allocated.
+ * @param[in,out] c       – pointer to the structure,
+ * @param[in] i           – the level,
+ * @param[in] f           – index of the field.
+ * @return The node.
+ */
+static uint32_t make_vertex(connectivity_t *c, uint32_t i, uint32_t f) {
+    reserve_level(c, i);
+
+    if (c->vertices[i][f] == NIL) {
+        reserve_nodes(c, 1);
+        init_node(c, c->nodes_num, f, VERTEX);
+        c->vertices[i][f] = c->nodes_num++;
+    }
+
+    return c->vertices[i][f];
+}
+
+/**@brief Takes two arcs of the edge.
+ * Takes two consecutive nodes of arcs of edge @p e in structure pointed
+ * by @p c, reusing freed ones if possible.
+ * Terminates the program if memory could not be allocated.
+ * @param[in,out] c       – pointer to the structure,
+ * @param[in] e           – number of the edge.
+ * @return The first of the arcs.
+ */
+static uint32_t new_arcs(connectivity_t *c, uint64_t e) {
+    uint32_t a = c->free_arcs;
+    uint8_t flags = e % 2 == 1 ? ARC_DOWN : 0;
+
+    if (a != NIL) {
+        c->free_arcs = c->left[a];
+    } else {
+        reserve_nodes(c, 2);
+        a = c->nodes_num;
+        c->nodes_num += 2;
+    }
+
+    init_node(c, a, lower_end(e), flags);
+    init_node(c, a + 1, lower_end(e), flags);
+
+    return a;
+}
+
+/**@brief Updates the node from its children.
+ * Sets up number of fields and flags of subtree of node @p x
+ * in structure pointed by @p c.
+ * @param[in,out] c       – pointer to the structure,
+ * @param[in] x           – the node.
+ */
+static void update(connectivity_t *c, uint32_t x) {
+    uint32_t l = c->left[x], r = c->right[x];
+    uint8_t own = c->flags[x] & (OWN_TREE | OWN_NONTREE);
+
+    c->size[x] = c->size[l] + c->size[r] + (c->flags[x] & VERTEX);
+    c->flags[x] = (c->flags[x] & ~(SUB_TREE | SUB_NONTREE)) | own << 2 |
+                  ((c->flags[l] | c->flags[r]) & (SUB_TREE | SUB_NONTREE));
+}
+
+/**@brief Rotates the node over its parent.
+ * @param[in,out] c       – pointer to the structure,
+ * @param[in] x           – the node, which has a parent.
+ */
+static void rotate(connectivity_t *c, uint32_t x) {
+    uint32_t p = c->parent[x], g = c->parent[p], child;
+
+    if (c->left[p] == x) {
+        child = c->right[x];
+        c->left[p] = child;
+        c->right[x] = p;
+    } else {
+        child = c->left[x];
+        c->right[p] = child;
+        c->left[x] = p;
+    }
+
+    if (child != NIL) {
+        c->parent[child] = p;
+    }
+    c->parent[p] = x;
+    c->parent[x] = g;
+
+    if (g != NIL && c->left[g] == p) {
+        c->left[g] = x;
+    } else if (g != NIL) {
+        c->right[g] = x;
+    }
+
+    update(c, p);
+    update(c, x);
+}
+
+/**@brief Moves the node to the root of its splay tree.
+ * @param[in,out] c       – pointer to the structure,
+ * @param[in] x           – the node.
+ */
+static void splay(connectivity_t *c, uint32_t x) {
+    uint32_t p, g;
+
+    while (c->parent[x] != NIL) {
+        p = c->parent[x];
+        g = c->parent[p];
+
+        if (g != NIL) {
+            rotate(c, (c->left[g] == p) == (c->left[p] == x) ? p : x);
+        }
+        rotate(c, x);
+    }
+}
+
+/**@brief Concatenates two tours.
+ * Concatenates tours given by roots @p a and @p b in structure pointed
+ * by @p c.
+ * @param[in,out] c       – pointer to the structure,
+ * @param[in] a           – root of the first tour or NIL,
+ * @param[in] b           – root of the second tour or NIL.
+ * @return Root of the concatenated tour.
+ */
+static uint32_t join_tours(connectivity_t *c, uint32_t a, uint32_t b) {
+    if (a == NIL) {
+        return b;
+    } else if (b == NIL) {
+        return a;
+    }
+
+    while (c->right[a] != NIL) {
+        a = c->right[a];
+    }
+    splay(c, a);
+
+    c->right[a] = b;
+    c->parent[b] = a;
+    update(c, a);
+
+    return a;
+}
+
+/**@brief Detaches the child of the node.
+ * Detaches left child of node @p x if @p left is set, or its right child
+ * otherwise, in structure pointed by @p c.
+ * @param[in,out] c       – pointer to the structure,
+ * @param[in] x           – the node,
+ * @param[in] left        – whether the left child is detached.
+ * @return The detached child, root of its own tree now, or NIL.
+ */
+static uint32_t detach(connectivity_t *c, uint32_t x, bool left) {
+    uint32_t child = left ? c->left[x] : c->right[x];
+
+    if (child != NIL) {
+        c->parent[child] = NIL;
+    }
+    if (left) {
+        c->left[x] = NIL;
+    } else {
+        c->right[x] = NIL;
+    }
+    update(c, x);
+
+    return child;
+}
+
+/**@brief Starts the tour at the field.
+ * Rotates tour containing node @p v of a field in structure pointed by @p c,
+ * so that it starts at the field.
+ * @param[in,out] c       – pointer to the structure,
+ * @param[in] v           – node of the field.
+ * @return Root of the tour.
+ */
+static uint32_t reroot(connectivity_t *c, uint32_t v) {
+    splay(c, v);
+
+    return join_tours(c, v, detach(c, v, true));
+}
+
+/**@brief Checks whether the nodes are in the same tour.
+ * @param[in,out] c       – pointer to the structure,
+ * @param[in] x           – the first node,
+ * @param[in] y           – the second node.
+ * @return Value @p true if the nodes are in the same tour, @p false otherwise.
+ */
+static bool same_tour(connectivity_t *c, uint32_t x, uint32_t y) {
+    if (x == y) {
+        return true;
+    }
+
+    // If the nodes are in the same tour, splaying the second one
+    // takes the first one away from the root.
+    splay(c, x);
+    splay(c, y);
+
+    return c->parent[x] != NIL;
+}
+
+/**@brief Checks whether the fields are connected on the level.
+ * Checks whether fields with indices @p f and @p g are in the same tree
+ * of level @p i of structure pointed by @p c.
+ * @param[in,out] c       – pointer to the structure,
+ * @param[in] i           – the level,
+ * @param[in] f           – index of the first field,
+ * @param[in] g           – index of the second field.
+ * @return Value @p true if the fields are connected, @p false otherwise.
+ */
+static bool connected(connectivity_t *c, uint32_t i, uint32_t f, uint32_t g) {
+    uint32_t x = vertex(c, i, f), y = vertex(c, i, g);
+
+    if (x == NIL || y == NIL) {
+        return f == g;
+    }
+
+    return same_tour(c, x, y);
+}
+
+/**@brief Gives number of fields in tree of the field.
+ * Gives number of fields in tree of level @p i of structure pointed by @p c,
+ * containing field with index @p f.
+ * @param[in,out] c       – pointer to the structure,
+ * @param[in] i           – the level,
+ * @param[in] f           – index of the field.
+ * @return Number of fields.
+ */
+static uint32_t tree_size(connectivity_t *c, uint32_t i, uint32_t f) {
+    uint32_t x = vertex(c, i, f);
+
+    if (x == NIL) {
+        return 1;
+    }
+
+    splay(c, x);
+
+    return c->size[x];
+}
+
+/**@brief Sets up own flag of the node.
+ * Sets or clears, depending on @p on, flag @p flag of node @p x
+ * in structure pointed by @p c.
+ * @param[in,out] c       – pointer to the structure,
+ * @param[in] x           – the node,
+ * @param[in] flag        – the flag, @ref OWN_TREE or @ref OWN_NONTREE,
+ * @param[in] on          – whether the flag is set.
+ */
+static void set_flag(connectivity_t *c, uint32_t x, uint8_t flag, bool on) {
+    splay(c, x);
+
+    if (on) {
+        c->flags[x] |= flag;
+    } else {
+        c->flags[x] &= ~flag;
+    }
+    update(c, x);
+}
+
+/**@brief Finds a flagged node in the tour.
+ * Finds in tour of structure pointed by @p c, containing node @p x,
+ * a node with own flag @p flag.
+ * @param[in,out] c       – pointer to the structure,
+ * @param[in] x           – node of the tour,
+ * @param[in] flag        – the flag, @ref OWN_TREE or @ref OWN_NONTREE.
+ * @return The flagged node or NIL if there is none.
+ */
+static uint32_t find_flagged(connectivity_t *c, uint32_t x, uint8_t flag) {
+    uint8_t sub = flag << 2;
+
+    splay(c, x);
+    if (!(c->flags[x] & sub)) {
+        return NIL;
+    }
+
+    while (!(c->flags[x] & flag)) {
+        x = c->flags[c->left[x]] & sub ? c->left[x] : c->right[x];
+    }
+    splay(c, x);
+
+    return x;
+}
+
+/**@brief Links trees of ends of the edge.
+ * Joins trees of level @p i of structure pointed by @p c, containing ends
+ * of edge @p e, which are not connected on this level, with the edge.
+ * Terminates the program if memory could not be allocated.
+ * @param[in,out] c       – pointer to the structure,
+ * @param[in] i           – the level,
+ * @param[in] e           – number of the edge.
+ */
+static void link_tours(connectivity_t *c, uint32_t i, uint64_t e) {
+    uint32_t u = make_vertex(c, i, lower_end(e));
+    uint32_t w = make_vertex(c, i, upper_end(c, e));
+    uint32_t a = new_arcs(c, e), t;
+
+    c->arcs[i][e] = a;
+
+    // Tour of one tree, arc to the other one, its tour and arc back.
+    t = join_tours(c, reroot(c, u), a);
+    t = join_tours(c, t, reroot(c, w));
+    join_tours(c, t, a + 1);
+}
+
+/**@brief Cuts tree of the edge.
+ * Splits tree of level @p i of structure pointed by @p c, containing
+ * edge @p e, into two trees without the edge, freeing its arcs.
+ * @param[in,out] c       – pointer to the structure,
+ * @param[in] i           – the level,
+ * @param[in] e           – number of the edge.
+ */
+static void cut_tours(connectivity_t *c, uint32_t i, uint64_t e) {
+    uint32_t a = c->arcs[i][e], b = a + 1, l, r;
+
+    c->arcs[i][e] = NIL;
+
+    splay(c, a);
+    l = detach(c, a, true);
+    r = detach(c, a, false);
+
+    // Tour was either l a inner b outer, or outer b inner a r, where part
+    // between the arcs is the tour of one of the trees.
+    splay(c, b);
+    if (l != NIL && (l == b || c->parent[l] != NIL)) {
+        detach(c, b, false);
+        join_tours(c, detach(c, b, true), r);
+    } else {
+        detach(c, b, true);
+        join_tours(c, l, detach(c, b, false));
+    }
+
+    c->left[a] = c->free_arcs;
+    c->free_arcs = a;
+}
+
+/**@brief Updates flag of non-tree edges of the field.
+ * Sets up flag of node of field with index @p f on level @p i of structure
+ * pointed by @p c, telling whether the field has non-tree edges of the level.
+ * Terminates the program if memory could not be allocated.
+ * @param[in,out] c       – pointer to the structure,
+ * @param[in] i           – the level,
+ * @param[in] f           – index of the field.
+ */
+static void refresh_nontree(connectivity_t *c, uint32_t i, uint32_t f) {
+    uint32_t d, x;
+    bool has = false;
+
+    for (d = 0; d < DIR; ++d) {
+        has = has || c->edges[edge_of(c, f, d)] == i;
+    }
+
+    x = has ? make_vertex(c, i, f) : vertex(c, i, f);
+    if (x != NIL && ((c->flags[x] & OWN_NONTREE) != 0) != has) {
+        set_flag(c, x, OWN_NONTREE, has);
+    }
+}
+
+/**@brief Sets up level of non-tree edge.
+ * Sets up level @p level of non-tree edge @p e of structure pointed by @p c,
+ * or removes the edge if @p level is @ref NO_EDGE.
+ * Terminates the program if memory could not be allocated.
+ * @param[in,out] c       – pointer to the structure,
+ * @param[in] e           – number of the edge,
+ * @param[in] level       – new level of the edge.
+ */
+static void set_nontree(connectivity_t *c, uint64_t e, uint8_t level) {
+    uint8_t old = c->edges[e];
+
+    c->edges[e] = level;
+
+    if (old != NO_EDGE && !(old & TREE_EDGE)) {
+        refresh_nontree(c, old, lower_end(e));
+        refresh_nontree(c, old, upper_end(c, e));
+    }
+    if (level != NO_EDGE) {
+        refresh_nontree(c, level, lower_end(e));
+        refresh_nontree(c, level, upper_end(c, e));
+    }
+}
+
+/**@brief Makes the edge a tree edge.
+ * Makes edge @p e of structure pointed by @p c a tree edge of level @p i,
+ * adding it to trees of levels up to @p i, whose trees of its ends are
+ * not connected.
+ * Terminates the program if memory could not be allocated.
+ * @param[in,out] c       – pointer to the structure,
+ * @param[in] e           – number of the edge,
+ * @param[in] i           – level of the edge.
+ */
+static void add_tree_edge(connectivity_t *c, uint64_t e, uint32_t i) {
+    uint32_t j;
+
+    set_nontree(c, e, NO_EDGE);
+    c->edges[e] = TREE_EDGE | i;
+
+    for (j = 0; j <= i; ++j) {
+        link_tours(c, j, e);
+    }
+    set_flag(c, c->arcs[i][e], OWN_TREE, true);
+}
+
+/**@brief Inserts the edge.
+ * Inserts edge @p e to structure pointed by @p c, as a tree edge if its
+ * ends are not connected yet, or as a non-tree edge otherwise, of level 0.
+ * Terminates the program if memory could not be allocated.
+ * @param[in,out] c       – pointer to the structure,
+ * @param[in] e           – number of the edge.
+ */
+static void insert_edge(connectivity_t *c, uint64_t e) {
+    if (connected(c, 0, lower_end(e), upper_end(c, e))) {
+        set_nontree(c, e, 0);
+    } else {
+        add_tree_edge(c, e, 0);
+    }
+}
+
+/**@brief Looks for a replacement of deleted tree edge on the level.
+ * Looks for a non-tree edge of level @p i of structure pointed by @p c,
+ * joining trees of level @p i containing fields with indices @p u and @p w,
+ * split by a deleted tree edge. Edges of the smaller tree which are not
+ * a replacement are raised to the next level, so that they are not checked
+ * on this level again. The replacement found becomes a tree edge.
+ * Terminates the program if memory could not be allocated.
+ * @param[in,out] c       – pointer to the structure,
+ * @param[in] i           – the level,
+ * @param[in] u           – index of the first field,
+ * @param[in] w           – index of the second field.
+ * @return Value @p true if a replacement was found, @p false otherwise.
+ */
+static bool replace_edge(connectivity_t *c, uint32_t i, uint32_t u,
+                         uint32_t w) {
+    uint32_t x, y, d, f, adj;
+    uint64_t e;
+
+    if (tree_size(c, i, u) > tree_size(c, i, w)) {
+        u = w;
+    }
+    x = make_vertex(c, i, u);
+
+    // The smaller tree becomes a tree of the next level.
+    while ((y = find_flagged(c, x, OWN_TREE)) != NIL) {
+        e = 2 * (uint64_t) c->keys[y] + (c->flags[y] & ARC_DOWN ? 1 : 0);
+
+        set_flag(c, y, OWN_TREE, false);
+        c->edges[e] = TREE_EDGE | (i + 1);
+        link_tours(c, i + 1, e);
+        set_flag(c, c->arcs[i + 1][e], OWN_TREE, true);
+    }
+
+    while ((y = find_flagged(c, x, OWN_NONTREE)) != NIL) {
+        f = c->keys[y];
+
+        for (d = 0; d < DIR; ++d) {
+            e = edge_of(c, f, d);
+            adj = f + c->shift[d];
+
+            if (c->edges[e] != i) {
+                continue;
+            } else if (!connected(c, i, adj, u)) {
+                add_tree_edge(c, e, i);
+                return true;
+            }
+
+            set_nontree(c, e, i + 1);
+        }
+    }
+
+    return false;
+}
+
+/**@brief Deletes the edge.
+ * Deletes edge @p e from structure pointed by @p c. If it is a tree edge,
+ * its replacement is searched for from its level down to level 0.
+ * Terminates the program if memory could not be allocated.
+ * @param[in,out] c       – pointer to the structure,
+ * @param[in] e           – number of the edge.
+ */
+static void delete_edge(connectivity_t *c, uint64_t e) {
+    uint32_t i, level = c->edges[e] & ~TREE_EDGE;
+
+    if (!(c->edges[e] & TREE_EDGE)) {
+        set_nontree(c, e, NO_EDGE);
+        return;
+    }
+
+    c->edges[e] = NO_EDGE;
+    for (i = 0; i <= level; ++i) {
+        cut_tours(c, i, e);
+    }
+
+    for (i = level + 1; i-- > 0;) {
+        if (replace_edge(c, i, lower_end(e), upper_end(c, e))) {
+            return;
+        }
+    }
+}
+
+connectivity_t *alloc_connectivity(board_t *b, uint32_t players_num) {
+    // Nodes of fields and arcs of level 0 have to be numbered on 32 bits.
+    if (b->fields_num > UINT32_MAX / 4) {
+        return NULL;
+    }
+
+    connectivity_t *c = calloc(1, sizeof(struct connectivity));
+    if (c == NULL) {
+        return NULL;
+    }
+
+    c->fields_num = b->fields_num;
+    c->players_num = players_num;
+    c->stride = b->stride;
+    memcpy(c->shift, b->shift, sizeof(c->shift));
+
+    // Trees of level i have at most fields_num / 2^i fields.
+    for (c->levels = 1; ((uint64_t) 1 << (c->levels - 1)) < c->fields_num;) {
+        c->levels++;
+    }
+
+    c->edges = malloc(2 * (size_t) c->fields_num);
+    c->vertices = calloc(c->levels, sizeof(uint32_t *));
+    c->arcs = calloc(c->levels, sizeof(uint32_t *));
+    c->tracked = calloc((uint64_t) players_num + 1, sizeof(bool));
+    if (c->edges == NULL || c->vertices == NULL || c->arcs == NULL ||
+        c->tracked == NULL) {
+        free(c->edges);
+        free(c->vertices);
+        free(c->arcs);
+        free(c->tracked);
+        free(c);
+
+        return NULL;
+    }
+    memset(c->edges, NO_EDGE, 2 * (size_t) c->fields_num);
+
+    reserve_nodes(c, 1);
+    init_node(c, NIL, 0, 0);
+    c->nodes_num = 1;
+
+    return c;
+}
+
+void delete_connectivity(connectivity_t *c) {
+    uint32_t i;
+
+    if (c == NULL) {
+        return;
+    }
+
+    for (i = 0; i < c->levels; ++i) {
+        free(c->vertices[i]);
+        free(c->arcs[i]);
+    }
+    free(c->vertices);
+    free(c->arcs);
+    free(c->edges);
+    free(c->left);
+    free(c->right);
+    free(c->parent);
+    free(c->size);
+    free(c->keys);
+    free(c->flags);
+    free(c->tracked);
+    free(c);
+}
+
+void track_player(connectivity_t *c, board_t *b, uint32_t player_id) {
+    uint32_t x, y, f;
+
+    if (c->tracked[player_id]) {
+        return;
+    }
+
+    c->tracked[player_id] = true;
+
+    for (y = 0; y < b->height; ++y) {
+        f = field_index(b, 0, y);
+
+        for (x = 0; x < b->width; ++x, ++f) {
+            if (field_owner(b, f) != player_id) {
+                continue;
+            }
+            if (field_owner(b, f + 1) == player_id) {
+                insert_edge(c, 2 * (uint64_t) f);
+            }
+            if (field_owner(b, f + b->stride) == player_id) {
+                insert_edge(c, 2 * (uint64_t) f + 1);
+            }
+        }
+    }
+}
+
+void capture_connectivity(connectivity_t *c, board_t *b, uint32_t f) {
+    uint32_t d, owner_id = field_owner(b, f);
+    uint64_t e;
+
+    // Nobody owns a free field, so it is never tracked.
+    if (!c->tracked[owner_id]) {
+        return;
+    }
+
+    for (d = 0; d < DIR; ++d) {
+        e = edge_of(c, f, d);
+
+        if (c->edges[e] == NO_EDGE &&
+            field_owner(b, f + c->shift[d]) == owner_id) {
+            insert_edge(c, e);
+        }
+    }
+}
+
+uint32_t release_connectivity(connectivity_t *c, board_t *b, uint32_t f) {
+    uint32_t d, i, n = 0, counter = 0, adj[DIR];
+    uint64_t e;
+
+    (void) b;
+
+    for (d = 0; d < DIR; ++d) {
+        e = edge_of(c, f, d);
+
+        if (c->edges[e] != NO_EDGE) {
+            delete_edge(c, e);
+            adj[n++] = f + c->shift[d];
+        }
+    }
+
+    // Counting adjacent fields not connected with any of the previous ones.
+    for (d = 0; d < n; ++d) {
+        for (i = 0; i < d && !connected(c, 0, adj[i], adj[d]); ++i) {
+        }
+
+        if (i == d) {
+            counter++;
+        }
+    }
+
+    return counter;
+}
+
+/**@brief Attaches fields of the tree to a new area.
+ * Attaches fields of tree of level 0 of structure pointed by @p c,
+ * containing field with index @p f, to a new find&union node on board
+ * pointed by @p b.
+ * Terminates the program if memory could not be allocated.
+ * @param[in,out] c       – pointer to the structure,
+ * @param[in,out] b       – pointer to the board,
+ * @param[in] f           – index of the field.
+ */
+static void separate_tree(connectivity_t *c, board_t *b, uint32_t f) {
+    uint32_t x = vertex(c, 0, f), node = new_area(b);
+
+    if (x == NIL) {
+        join_area(b, f, node);
+        return;
+    }
+
+    // Visiting nodes of the tour in order.
+    splay(c, x);
+    while (c->left[x] != NIL) {
+        x = c->left[x];
+    }
+
+    while (x != NIL) {
+        if (c->flags[x] & VERTEX) {
+            join_area(b, c->keys[x], node);
+        }
+
+        if (c->right[x] != NIL) {
+            for (x = c->right[x]; c->left[x] != NIL; x = c->left[x]) {
+            }
+        } else {
+            while (c->parent[x] != NIL && c->right[c->parent[x]] == x) {
+                x = c->parent[x];
+            }
+            x = c->parent[x];
+        }
+    }
+}
+
+void split_fragments(connectivity_t *c, board_t *b, uint32_t f) {
+    uint32_t d, i, n = 0, largest = 0, adj, owner_id = field_owner(b, f);
+    uint32_t roots[DIR];
+
+    for (d = 0; d < DIR; ++d) {
+        adj = f + c->shift[d];
+
+        if (field_owner(b, adj) != owner_id) {
+            continue;
+        }
+
+        for (i = 0; i < n && !connected(c, 0, roots[i], adj); ++i) {
+        }
+
+        if (i == n) {
+            roots[n++] = adj;
+        }
+    }
+
+    for (i = 1; i < n; ++i) {
+        if (tree_size(c, 0, roots[i]) > tree_size(c, 0, roots[largest])) {
+            largest = i;
+        }
+    }
+
+    // The largest area stays attached to nodes of the former area.
+    for (i = 0; i < n; ++i) {
+        if (i != largest) {
+            separate_tree(c, b, roots[i]);
+        }
+    }
+}
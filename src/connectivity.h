@@ -0,0 +1,100 @@
+/**@file
+ * Interface of structure of dynamic connectivity of players' areas.
+ *
+ * Fields are vertices of a graph whose edges join adjacent fields
+ * of the same player, so that areas are its connected components.
+ * Edges are inserted and deleted in polylogarithmic amortized time,
+ * following Holm, de Lichtenberg and Thorup: every edge has a level,
+ * edges of level at least i form spanning forest of level i, whose trees
+ * are kept as Euler tours in splay trees. Trees of level i have at most
+ * 2^-i of all fields, so that edges are raised only a logarithmic
+ * number of times while replacements of deleted tree edges are searched.
+ * Thus a golden move learns into how many areas the area of its field
+ * splits without searching the area.
+ * Only edges of players tracked by the structure are kept, that is of
+ * players who lost a field by a golden move, so that moves of the others
+ * neither pay for keeping it up to date nor take its memory.
+ *
+ * @author Antoni Koszowski <a.koszowski@students.mimuw.edu.pl>
+ * @copyright
+ * @date 17.06.2020
+ */
+
+#ifndef CONNECTIVITY_H
+#define CONNECTIVITY_H
+
+#include <stdint.h>
+#include "board_utilities.h"
+
+/**
+ * Structure storing dynamic connectivity of players' areas.
+ */
+typedef struct connectivity connectivity_t;
+
+/** @brief Creates structure of dynamic connectivity.
+ * Allocates memory for a new structure of connectivity of areas on board
+ * pointed by @p b, occupied by @p players_num players, none of which
+ * is tracked yet.
+ * @param[in] b           – pointer to the board,
+ * @param[in] players_num – number of players.
+ * @return Pointer to the newly created structure or NULL in case of
+ * memory was not allocated or the board is too large.
+ */
+connectivity_t *alloc_connectivity(board_t *b, uint32_t players_num);
+
+/**@brief Deletes structure of dynamic connectivity.
+ * Deletes from memory structure pointed by @p c.
+ * Nothing happens if the pointer's value is NULL.
+ * @param[in] c           – pointer to structure that will be removed.
+ */
+void delete_connectivity(connectivity_t *c);
+
+/**@brief Starts tracking areas of the player.
+ * Inserts to structure pointed by @p c edges between all adjacent fields
+ * of player @p player_id on board pointed by @p b, unless the player
+ * is already tracked. Takes time linear in size of the board and
+ * O(k log k) for k fields of the player, once for every player.
+ * Terminates the program if memory could not be allocated.
+ * @param[in,out] c       – pointer to the structure,
+ * @param[in] b           – pointer to the board,
+ * @param[in] player_id   – player identifier.
+ */
+void track_player(connectivity_t *c, board_t *b, uint32_t player_id);
+
+/**@brief Inserts edges of captured field.
+ * Inserts to structure pointed by @p c edges between field with index @p f
+ * on board pointed by @p b and adjacent fields of its owner, if the owner
+ * is tracked. Must be called after the owner of the field is set up.
+ * Terminates the program if memory could not be allocated.
+ * @param[in,out] c       – pointer to the structure,
+ * @param[in] b           – pointer to the board,
+ * @param[in] f           – index of the captured field.
+ */
+void capture_connectivity(connectivity_t *c, board_t *b, uint32_t f);
+
+/**@brief Deletes edges of released field.
+ * Deletes from structure pointed by @p c all edges of field with index
+ * @p f on board pointed by @p b, and gives number of areas which the area
+ * of the field is split into, which is meaningful only if its owner
+ * is tracked. Must be called before the owner of the field changes.
+ * Terminates the program if memory could not be allocated.
+ * @param[in,out] c       – pointer to the structure,
+ * @param[in] b           – pointer to the board,
+ * @param[in] f           – index of the released field.
+ * @return Number of areas emerging after exclusion of the field.
+ */
+uint32_t release_connectivity(connectivity_t *c, board_t *b, uint32_t f);
+
+/**@brief Forms areas split by the released field.
+ * Attaches fields of every area adjacent to field with index @p f on board
+ * pointed by @p b, but the largest one, to their own find&union nodes,
+ * after edges of the field were deleted from structure pointed by @p c.
+ * Takes time proportional to number of fields attached to new nodes.
+ * Terminates the program if memory could not be allocated.
+ * @param[in,out] c       – pointer to the structure,
+ * @param[in,out] b       – pointer to the board,
+ * @param[in] f           – index of the released field.
+ */
+void split_fragments(connectivity_t *c, board_t *b, uint32_t f);
+
+#endif /* CONNECTIVITY_H */
@@ -0,0 +1,798 @@
+/**@file
+ * Implementation of index of articulation points of players' areas.
+ *
+ * Block-cut tree of every area is rooted at one of its fields. Every other
+ * field is a child of exactly one block, the one closest to the root,
+ * whereas every block has a head, that is its field closest to the root.
+ * Blocks are kept in find&union sets, so that blocks on a cycle closed
+ * by a captured field can be merged cheaply.
+ *
+ * @author Antoni Koszowski <a.koszowski@students.mimuw.edu.pl>
+ * @copyright
+ * @date 17.06.2020
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "cut_points.h"
+
+/**
+ * Parent block of fields that are roots of block-cut trees.
+ */
+#define NO_BLOCK UINT32_MAX
+
+/**
+ * Structure representing growable array of numbers.
+ */
+typedef struct vector {
+    uint32_t *data;     ///< stored numbers
+    uint64_t size;      ///< number of stored numbers
+    uint64_t cap;       ///< number of allocated numbers
+} vector_t;
+
+/**
+ * Structure storing index of articulation points of players' areas.
+ */
+struct cut_points {
+    uint32_t players_num;   ///< number of players
+    uint64_t *safe;         ///< numbers of safe targets of players
+    uint64_t *cuts;         ///< numbers of articulation points near players
+    bool *dirty;            ///< whether player's areas wait for rebuild
+    vector_t dirty_players; ///< players whose areas wait for rebuild
+    vector_t seeds;         ///< fields of areas waiting for rebuild
+    uint32_t *parents;      ///< nodes of blocks that fields are children of
+    uint8_t *blocks;        ///< numbers of blocks containing fields
+    uint8_t *counts;        ///< numbers of blocks counted during rebuild
+    uint32_t *marks;        ///< marks of fields visited by searches
+    uint32_t *lows;         ///< lowest marks reachable from fields
+    uint32_t last_mark;     ///< the last mark given to a field
+    uint32_t refresh_base;  ///< the first mark given during current rebuild
+    uint32_t nodes_num;     ///< number of find&union nodes of blocks in use
+    uint32_t nodes_cap;     ///< number of allocated nodes of blocks
+    uint32_t *reps;         ///< representatives of nodes of blocks
+    uint8_t *ranks;         ///< ranks of nodes of blocks
+    uint32_t *heads;        ///< heads of blocks, valid for representatives
+    vector_t stack;         ///< stack of depth-first search
+    vector_t path;          ///< fields visited by depth-first search
+    vector_t order;         ///< fields in order of visiting
+};
+
+/**@brief Appends number to the vector.
+ * Appends @p value to the vector pointed by @p v.
+ * Terminates the program if memory could not be allocated.
+ * @param[in,out] v       – pointer to the vector,
+ * @param[in] value       – appended number.
+ */
+static void push_back(vector_t *v, uint32_t value) {
+    uint64_t new_cap;
+    uint32_t *new_data;
+
+    if (v->size == v->cap) {
+        new_cap = v->cap < 32 ? 64 : 2 * v->cap;
+
+        new_data = realloc(v->data, sizeof(uint32_t) * new_cap);
+        if (new_data == NULL) {
+            exit(1);
+        }
+
+        v->data = new_data;
+        v->cap = new_cap;
+    }
+
+    v->data[v->size++] = value;
+}
+
+/**@brief Clears marks of fields.
+ * Marks all fields as not visited in index pointed by @p cp.
+ * @param[in,out] cp      – pointer to the index,
+ * @param[in] fields_num  – number of fields.
+ */
+static void clear_marks(cut_points_t *cp, uint32_t fields_num) {
+    memset(cp->marks, 0, sizeof(uint32_t) * fields_num);
+    cp->last_mark = 0;
+    cp->refresh_base = 1;
+}
+
+/**@brief Gives new marks of fields.
+ * Gives the first of @p n consecutive marks of fields, greater than marks
+ * given so far by index pointed by @p cp, clearing old marks if needed.
+ * @param[in,out] cp      – pointer to the index,
+ * @param[in] fields_num  – number of fields,
+ * @param[in] n           – number of needed marks.
+ * @return The first of new marks.
+ */
+static uint32_t new_marks(cut_points_t *cp, uint32_t fields_num, uint32_t n) {
+    if (cp->last_mark > UINT32_MAX - n) {
+        clear_marks(cp, fields_num);
+    }
+
+    cp->last_mark += n;
+
+    return cp->last_mark - n + 1;
+}
+
+/**@brief Finds representative node of the block.
+ * Finds representative of node @p node of block in index pointed by @p cp.
+ * @param[in,out] cp      – pointer to the index,
+ * @param[in] node        – node of the block.
+ * @return Representative node of the block.
+ */
+static uint32_t find_block(cut_points_t *cp, uint32_t node) {
+    uint32_t rep = node, next;
+
+    while (cp->reps[rep] != rep) {
+        rep = cp->reps[rep];
+    }
+
+    // Compressing the path.
+    while (node != rep) {
+        next = cp->reps[node];
+        cp->reps[node] = rep;
+        node = next;
+    }
+
+    return rep;
+}
+
+/**@brief Gives block which the field is a child of.
+ * Gives representative node of block which field with index @p f is a child
+ * of, according to index pointed by @p cp.
+ * @param[in,out] cp      – pointer to the index,
+ * @param[in] f           – index of the field.
+ * @return Representative node of the block or @p NO_BLOCK if the field
+ * is the root of its block-cut tree.
+ */
+static uint32_t parent_block(cut_points_t *cp, uint32_t f) {
+    if (cp->parents[f] == NO_BLOCK) {
+        return NO_BLOCK;
+    }
+
+    return find_block(cp, cp->parents[f]);
+}
+
+/**@brief Creates a new block.
+ * Creates a new block with head @p head in index pointed by @p cp.
+ * Terminates the program if memory could not be allocated.
+ * @param[in,out] cp      – pointer to the index,
+ * @param[in] head        – index of the head of the block.
+ * @return Node of the new block.
+ */
+static uint32_t new_block(cut_points_t *cp, uint32_t head) {
+    uint64_t new_cap;
+
+    if (cp->nodes_num == cp->nodes_cap) {
+        if (cp->nodes_cap == NO_BLOCK) {
+            exit(1);
+        }
+
+        new_cap = (uint64_t) cp->nodes_cap + cp->nodes_cap / 2 + 64;
+        if (new_cap > NO_BLOCK) {
+            new_cap = NO_BLOCK;
+        }
+
+        cp->reps = realloc(cp->reps, sizeof(uint32_t) * new_cap);
+        cp->ranks = realloc(cp->ranks, sizeof(uint8_t) * new_cap);
+        cp->heads = realloc(cp->heads, sizeof(uint32_t) * new_cap);
+        if (cp->reps == NULL || cp->ranks == NULL || cp->heads == NULL) {
+            exit(1);
+        }
+
+        cp->nodes_cap = (uint32_t) new_cap;
+    }
+
+    cp->reps[cp->nodes_num] = cp->nodes_num;
+    cp->ranks[cp->nodes_num] = 0;
+    cp->heads[cp->nodes_num] = head;
+
+    return cp->nodes_num++;
+}
+
+/**@brief Merges two blocks.
+ * Merges blocks represented by nodes @p a and @p b in index
+ * pointed by @p cp.
+ * @param[in,out] cp      – pointer to the index,
+ * @param[in] a           – representative node of the first block,
+ * @param[in] b           – representative node of the second block.
+ * @return Representative node of the merged block.
+ */
+static uint32_t join_blocks(cut_points_t *cp, uint32_t a, uint32_t b) {
+    if (a == b) {
+        return a;
+    } else if (cp->ranks[a] < cp->ranks[b]) {
+        cp->reps[a] = b;
+
+        return b;
+    } else {
+        if (cp->ranks[a] == cp->ranks[b]) {
+            cp->ranks[a]++;
+        }
+        cp->reps[b] = a;
+
+        return a;
+    }
+}
+
+/**@brief Gives number of adjacent fields owned by the player.
+ * Gives number of fields adjacent to field with index @p f on board
+ * pointed by @p b, owned by player @p player_id.
+ * @param[in] b           – pointer to the board,
+ * @param[in] player_id   – player identifier,
+ * @param[in] f           – index of the field.
+ * @return Number of adjacent fields owned by the player.
+ */
+static uint32_t adjacent_count(board_t *b, uint32_t player_id, uint32_t f) {
+    uint32_t i, counter = 0;
+
+    for (i = 0; i < DIR; ++i) {
+        if (field_owner(b, f + b->shift[i]) == player_id) {
+            counter++;
+        }
+    }
+
+    return counter;
+}
+
+/**@brief Gives counters the field contributes to.
+ * Gives array of counters of targets, that occupied field with index @p f
+ * contributes to, according to index pointed by @p cp.
+ * @param[in] cp          – pointer to the index,
+ * @param[in] f           – index of the field.
+ * @return Array of numbers of safe targets if the field is not
+ * an articulation point, array of numbers of articulation points otherwise.
+ */
+static uint64_t *field_targets(cut_points_t *cp, uint32_t f) {
+    return cp->blocks[f] > 1 ? cp->cuts : cp->safe;
+}
+
+/**@brief Counts the field as a target of adjacent players.
+ * Adds or removes, depending on @p add, field with index @p f on board
+ * pointed by @p b to or from targets of players owning adjacent fields,
+ * in index pointed by @p cp.
+ * @param[in,out] cp      – pointer to the index,
+ * @param[in] b           – pointer to the board,
+ * @param[in] f           – index of the occupied field,
+ * @param[in] add         – whether the field is added or removed.
+ */
+static void count_field(cut_points_t *cp, board_t *b, uint32_t f, bool add) {
+    uint32_t i, owners[DIR], owners_num = adjacent_owners(b, f, owners);
+    uint64_t *targets = field_targets(cp, f);
+
+    for (i = 0; i < owners_num; ++i) {
+        if (owners[i] != field_owner(b, f)) {
+            if (add) {
+                targets[owners[i]]++;
+            } else {
+                targets[owners[i]]--;
+            }
+        }
+    }
+}
+
+/**@brief Counts adjacent fields as targets of the field's owner.
+ * Adds or removes, depending on @p add, fields of another players adjacent
+ * only to field with index @p f on board pointed by @p b to or from targets
+ * of owner of the field, in index pointed by @p cp.
+ * @param[in,out] cp      – pointer to the index,
+ * @param[in] b           – pointer to the board,
+ * @param[in] f           – index of the occupied field,
+ * @param[in] add         – whether the fields are added or removed.
+ */
+static void count_adjacent(cut_points_t *cp, board_t *b, uint32_t f,
+                           bool add) {
+    uint32_t i, adj, owner = field_owner(b, f), adj_owner;
+
+    for (i = 0; i < DIR; ++i) {
+        adj = f + b->shift[i];
+        adj_owner = field_owner(b, adj);
+
+        if (adj_owner == 0 || adj_owner == BORDER_OWNER || adj_owner == owner) {
+            continue;
+        }
+
+        if (adjacent_count(b, owner, adj) == 1) {
+            if (add) {
+                field_targets(cp, adj)[owner]++;
+            } else {
+                field_targets(cp, adj)[owner]--;
+            }
+        }
+    }
+}
+
+/**@brief Sets up number of blocks containing the field.
+ * Sets up number @p blocks of blocks containing field with index @p f
+ * on board pointed by @p b, updating counters of targets in index
+ * pointed by @p cp.
+ * @param[in,out] cp      – pointer to the index,
+ * @param[in] b           – pointer to the board,
+ * @param[in] f           – index of the field,
+ * @param[in] blocks      – new number of blocks.
+ */
+static void set_blocks(cut_points_t *cp, board_t *b, uint32_t f,
+                       uint8_t blocks) {
+    if ((cp->blocks[f] > 1) != (blocks > 1)) {
+        count_field(cp, b, f, false);
+        cp->blocks[f] = blocks;
+        count_field(cp, b, f, true);
+    } else {
+        cp->blocks[f] = blocks;
+    }
+}
+
+/**@brief Gives a new mark to the field.
+ * Marks field with index @p f as visited by depth-first search
+ * in index pointed by @p cp.
+ * @param[in,out] cp      – pointer to the index,
+ * @param[in] f           – index of the field.
+ */
+static void visit_field(cut_points_t *cp, uint32_t f) {
+    cp->marks[f] = ++cp->last_mark;
+    cp->lows[f] = cp->marks[f];
+    push_back(&cp->order, f);
+}
+
+/**@brief Builds block-cut tree of the area.
+ * Builds block-cut tree of the area containing field with index @p s
+ * on board pointed by @p b, rooted at this field, using iterative version
+ * of Tarjan's algorithm.
+ * @param[in,out] cp      – pointer to the index,
+ * @param[in] b           – pointer to the board,
+ * @param[in] s           – index of the root field.
+ */
+static void rebuild_area(cut_points_t *cp, board_t *b, uint32_t s) {
+    uint32_t owner = field_owner(b, s), v, w, p, i, x, block;
+    vector_t *stack = &cp->stack, *path = &cp->path;
+    uint64_t k;
+
+    // Every field of the area gets a mark.
+    if (cp->last_mark > UINT32_MAX - b->fields_num) {
+        clear_marks(cp, b->fields_num);
+    }
+
+    cp->order.size = 0;
+    stack->size = 0;
+    path->size = 0;
+
+    visit_field(cp, s);
+    cp->parents[s] = NO_BLOCK;
+    push_back(stack, s);
+    push_back(stack, 0);
+
+    while (stack->size > 0) {
+        v = stack->data[stack->size - 2];
+        i = stack->data[stack->size - 1];
+
+        if (i < DIR) {
+            stack->data[stack->size - 1]++;
+            w = v + b->shift[i];
+
+            if (field_owner(b, w) != owner) {
+                continue;
+            }
+
+            if (cp->marks[w] < cp->refresh_base) {
+                visit_field(cp, w);
+                push_back(path, w);
+                push_back(stack, w);
+                push_back(stack, 0);
+            } else if (cp->marks[w] < cp->lows[v]) {
+                cp->lows[v] = cp->marks[w];
+            }
+        } else {
+            stack->size -= 2;
+            if (stack->size == 0) {
+                break;
+            }
+
+            p = stack->data[stack->size - 2];
+            if (cp->lows[v] < cp->lows[p]) {
+                cp->lows[p] = cp->lows[v];
+            }
+
+            // Fields visited from v form a block, unless they reach above p.
+            if (cp->lows[v] >= cp->marks[p]) {
+                block = new_block(cp, p);
+
+                do {
+                    x = path->data[--path->size];
+                    cp->parents[x] = block;
+                    cp->counts[x]++;
+                } while (x != v);
+
+                cp->counts[p]++;
+            }
+        }
+    }
+
+    for (k = 0; k < cp->order.size; ++k) {
+        x = cp->order.data[k];
+        set_blocks(cp, b, x, cp->counts[x]);
+        cp->counts[x] = 0;
+    }
+}
+
+/**@brief Starts rebuilding areas.
+ * Clears list of areas waiting for rebuild in index pointed by @p cp
+ * and makes every field on board pointed by @p b unvisited.
+ * @param[in,out] cp      – pointer to the index,
+ * @param[in] b           – pointer to the board.
+ */
+static void start_rebuild(cut_points_t *cp, board_t *b) {
+    uint64_t k;
+
+    for (k = 0; k < cp->dirty_players.size; ++k) {
+        cp->dirty[cp->dirty_players.data[k]] = false;
+    }
+
+    cp->dirty_players.size = 0;
+    cp->refresh_base = new_marks(cp, b->fields_num, 1) + 1;
+}
+
+/**@brief Rebuilds all areas.
+ * Rebuilds block-cut trees of all areas on board pointed by @p b
+ * from scratch, reusing all nodes of blocks in index pointed by @p cp.
+ * @param[in,out] cp      – pointer to the index,
+ * @param[in] b           – pointer to the board.
+ */
+static void rebuild_all(cut_points_t *cp, board_t *b) {
+    uint32_t f, owner;
+
+    start_rebuild(cp, b);
+    cp->seeds.size = 0;
+    cp->nodes_num = 0;
+
+    for (f = 0; f < b->fields_num; ++f) {
+        owner = field_owner(b, f);
+
+        if (owner != 0 && owner != BORDER_OWNER &&
+            cp->marks[f] < cp->refresh_base) {
+            rebuild_area(cp, b, f);
+        }
+    }
+}
+
+/**@brief Checks whether nodes of blocks should be reused.
+ * Checks whether most of nodes of blocks in index pointed by @p cp are not
+ * used anymore by areas on board pointed by @p b.
+ * @param[in] cp          – pointer to the index,
+ * @param[in] b           – pointer to the board.
+ * @return Value @p true if all areas should be rebuilt; @p false otherwise.
+ */
+static bool too_many_nodes(cut_points_t *cp, board_t *b) {
+    return cp->nodes_num > NO_BLOCK - DIR ||
+           cp->nodes_num >= 2 * (uint64_t) b->fields_num + DIR;
+}
+
+cut_points_t *alloc_cut_points(board_t *b, uint32_t players_num) {
+    uint32_t f, owner;
+    cut_points_t *cp = calloc(1, sizeof(struct cut_points));
+
+    if (cp == NULL) {
+        return NULL;
+    }
+
+    cp->players_num = players_num;
+    cp->safe = calloc((uint64_t) players_num + 1, sizeof(uint64_t));
+    cp->cuts = calloc((uint64_t) players_num + 1, sizeof(uint64_t));
+    cp->dirty = calloc((uint64_t) players_num + 1, sizeof(bool));
+    cp->parents = malloc(sizeof(uint32_t) * b->fields_num);
+    cp->blocks = calloc(b->fields_num, sizeof(uint8_t));
+    cp->counts = calloc(b->fields_num, sizeof(uint8_t));
+    cp->marks = calloc(b->fields_num, sizeof(uint32_t));
+    cp->lows = malloc(sizeof(uint32_t) * b->fields_num);
+
+    if (cp->safe == NULL || cp->cuts == NULL || cp->dirty == NULL ||
+        cp->parents == NULL || cp->blocks == NULL || cp->counts == NULL ||
+        cp->marks == NULL || cp->lows == NULL) {
+        delete_cut_points(cp);
+
+        return NULL;
+    }
+
+    // Every field is counted as a safe target first, then blocks are built.
+    for (f = 0; f < b->fields_num; ++f) {
+        owner = field_owner(b, f);
+
+        cp->parents[f] = NO_BLOCK;
+        if (owner != 0 && owner != BORDER_OWNER) {
+            count_field(cp, b, f, true);
+        }
+    }
+
+    rebuild_all(cp, b);
+
+    return cp;
+}
+
+void delete_cut_points(cut_points_t *cp) {
+    if (cp == NULL) {
+        return;
+    }
+
+    free(cp->safe);
+    free(cp->cuts);
+    free(cp->dirty);
+    free(cp->dirty_players.data);
+    free(cp->seeds.data);
+    free(cp->parents);
+    free(cp->blocks);
+    free(cp->counts);
+    free(cp->marks);
+    free(cp->lows);
+    free(cp->reps);
+    free(cp->ranks);
+    free(cp->heads);
+    free(cp->stack.data);
+    free(cp->path.data);
+    free(cp->order.data);
+    free(cp);
+}
+
+/**@brief Waits with the area for rebuild.
+ * Marks area of field with index @p f on board pointed by @p b,
+ * owned by player @p player_id, as waiting for rebuild
+ * in index pointed by @p cp.
+ * @param[in,out] cp      – pointer to the index,
+ * @param[in] player_id   – owner of the area,
+ * @param[in] f           – index of the field.
+ */
+static void add_seed(cut_points_t *cp, uint32_t player_id, uint32_t f) {
+    if (!cp->dirty[player_id]) {
+        cp->dirty[player_id] = true;
+        push_back(&cp->dirty_players, player_id);
+    }
+
+    push_back(&cp->seeds, f);
+}
+
+/**@brief Makes the field a root of its block-cut tree.
+ * Reverses path from field with index @p f to the root of its block-cut tree
+ * in index pointed by @p cp, so that the field becomes the root.
+ * @param[in,out] cp      – pointer to the index,
+ * @param[in] f           – index of the field.
+ */
+static void evert(cut_points_t *cp, uint32_t f) {
+    uint32_t child_block = NO_BLOCK, block, head;
+
+    while (true) {
+        block = parent_block(cp, f);
+        cp->parents[f] = child_block;
+
+        if (block == NO_BLOCK) {
+            return;
+        }
+
+        head = cp->heads[block];
+        cp->heads[block] = f;
+        child_block = block;
+        f = head;
+    }
+}
+
+/**@brief Links block-cut trees of two fields.
+ * Links block-cut trees of adjacent fields with indices @p u and @p v
+ * on board pointed by @p b, that were not connected so far,
+ * with a new block consisting of these two fields.
+ * The tree that is shallower at its field is rerooted.
+ * @param[in,out] cp      – pointer to the index,
+ * @param[in] b           – pointer to the board,
+ * @param[in] u           – index of the first field,
+ * @param[in] v           – index of the second field.
+ */
+static void link_fields(cut_points_t *cp, board_t *b, uint32_t u, uint32_t v) {
+    uint32_t x = u, y = v, child, head, block;
+
+    while (true) {
+        if (cp->parents[x] == NO_BLOCK) {
+            child = u;
+            head = v;
+            break;
+        } else if (cp->parents[y] == NO_BLOCK) {
+            child = v;
+            head = u;
+            break;
+        }
+
+        x = cp->heads[parent_block(cp, x)];
+        y = cp->heads[parent_block(cp, y)];
+    }
+
+    evert(cp, child);
+
+    block = new_block(cp, head);
+    cp->parents[child] = block;
+    set_blocks(cp, b, child, cp->blocks[child] + 1);
+    set_blocks(cp, b, head, cp->blocks[head] + 1);
+}
+
+/**@brief Gives position of the field on the path.
+ * Gives position of field with index @p f on the path stored
+ * in vector pointed by @p path.
+ * @param[in] path        – pointer to vector storing the path,
+ * @param[in] f           – index of the field.
+ * @return Position of the field.
+ */
+static uint64_t path_position(vector_t *path, uint32_t f) {
+    uint64_t k = path->size - 1;
+
+    while (path->data[k] != f) {
+        k--;
+    }
+
+    return k;
+}
+
+/**@brief Merges blocks on path between two fields.
+ * Merges all blocks on path in block-cut tree between adjacent fields
+ * with indices @p u and @p v on board pointed by @p b, that were already
+ * connected, since they form a cycle together with the edge between them.
+ * Both paths are climbed in turns, until they meet.
+ * @param[in,out] cp      – pointer to the index,
+ * @param[in] b           – pointer to the board,
+ * @param[in] u           – index of the first field,
+ * @param[in] v           – index of the second field.
+ */
+static void condense(cut_points_t *cp, board_t *b, uint32_t u, uint32_t v) {
+    uint32_t mark = new_marks(cp, b->fields_num, 2), side, x, block, meet;
+    uint32_t merged = NO_BLOCK;
+    uint64_t i, j, k;
+    vector_t *paths[2] = {&cp->path, &cp->order}, *path;
+    bool lca_block;
+
+    paths[0]->size = 0;
+    paths[1]->size = 0;
+    push_back(paths[0], u);
+    push_back(paths[1], v);
+    cp->marks[u] = mark;
+    cp->marks[v] = mark + 1;
+
+    // Climbing towards roots in turns, until a field marked by the other side.
+    for (side = 0;; side ^= 1) {
+        path = paths[side];
+        block = parent_block(cp, path->data[path->size - 1]);
+
+        if (block == NO_BLOCK) {
+            continue;
+        }
+
+        x = cp->heads[block];
+        push_back(path, x);
+
+        if (cp->marks[x] == mark + (side ^ 1)) {
+            meet = x;
+            break;
+        }
+
+        cp->marks[x] = mark + side;
+    }
+
+    i = path_position(paths[0], meet);
+    j = path_position(paths[1], meet);
+
+    // Paths may meet in a block or in its head.
+    lca_block = i > 0 && j > 0 &&
+                parent_block(cp, paths[0]->data[i - 1]) ==
+                parent_block(cp, paths[1]->data[j - 1]);
+
+    for (side = 0; side < 2; ++side) {
+        path = paths[side];
+
+        for (k = 0; k < (side == 0 ? i : j); ++k) {
+            block = parent_block(cp, path->data[k]);
+            merged = merged == NO_BLOCK ? block :
+                     join_blocks(cp, merged, block);
+
+            if (k > 0) {
+                set_blocks(cp, b, path->data[k], cp->blocks[path->data[k]] - 1);
+            }
+        }
+    }
+
+    if (merged != NO_BLOCK) {
+        cp->heads[merged] = meet;
+    }
+
+    if (!lca_block && i > 0 && j > 0) {
+        set_blocks(cp, b, meet, cp->blocks[meet] - 1);
+    }
+}
+
+void capture_cut_points(cut_points_t *cp, board_t *b, uint32_t f) {
+    uint32_t i, j, adj, owner = field_owner(b, f), reps[DIR], reps_num = 0;
+
+    cp->parents[f] = NO_BLOCK;
+    cp->blocks[f] = 0;
+    count_field(cp, b, f, true);
+    count_adjacent(cp, b, f, true);
+
+    if (cp->dirty[owner]) {
+        add_seed(cp, owner, f);
+
+        return;
+    } else if (too_many_nodes(cp, b)) {
+        rebuild_all(cp, b);
+
+        return;
+    }
+
+    // Adjacent areas are linked to the field, fields of the same area
+    // close cycles.
+    for (i = 0; i < DIR; ++i) {
+        adj = f + b->shift[i];
+
+        if (field_owner(b, adj) != owner) {
+            continue;
+        }
+
+        reps[reps_num] = find_rep(b, adj);
+        for (j = 0; j < reps_num && reps[j] != reps[reps_num]; ++j) {
+        }
+
+        if (j == reps_num) {
+            reps_num++;
+            link_fields(cp, b, f, adj);
+        } else {
+            condense(cp, b, f, adj);
+        }
+    }
+}
+
+void release_cut_points(cut_points_t *cp, board_t *b, uint32_t f) {
+    uint32_t i, adj, owner = field_owner(b, f);
+
+    count_field(cp, b, f, false);
+    count_adjacent(cp, b, f, false);
+    cp->parents[f] = NO_BLOCK;
+    cp->blocks[f] = 0;
+
+    for (i = 0; i < DIR; ++i) {
+        adj = f + b->shift[i];
+
+        if (field_owner(b, adj) == owner) {
+            add_seed(cp, owner, adj);
+        }
+    }
+}
+
+void refresh_cut_points(cut_points_t *cp, board_t *b) {
+    uint32_t f, owner;
+    uint64_t k;
+
+    if (cp->seeds.size == 0) {
+        return;
+    } else if (too_many_nodes(cp, b)) {
+        rebuild_all(cp, b);
+
+        return;
+    }
+
+    start_rebuild(cp, b);
+
+    for (k = 0; k < cp->seeds.size; ++k) {
+        f = cp->seeds.data[k];
+        owner = field_owner(b, f);
+
+        if (owner != 0 && owner != BORDER_OWNER &&
+            cp->marks[f] < cp->refresh_base) {
+            rebuild_area(cp, b, f);
+        }
+    }
+
+    cp->seeds.size = 0;
+}
+
+uint32_t field_fragments(cut_points_t *cp, uint32_t f) {
+    return cp->blocks[f];
+}
+
+bool fresh_areas(const cut_points_t *cp, uint32_t player_id) {
+    return !cp->dirty[player_id];
+}
+
+uint64_t safe_targets(cut_points_t *cp, uint32_t player_id) {
+    return cp->safe[player_id];
+}
+
+uint64_t cut_targets(cut_points_t *cp, uint32_t player_id) {
+    return cp->cuts[player_id];
+}
@@ -0,0 +1,124 @@
+/**@file
+ * Interface of index of articulation points of players' areas.
+ *
+ * For every area the index keeps its block-cut tree: areas are split into
+ * blocks, that is maximal parts which stay connected after exclusion of any
+ * single field. Number of blocks containing a field is the number of areas
+ * emerging from its area after the field is excluded, so that feasibility
+ * of golden move on the field is known without searching the board.
+ * Captured fields are added to the trees incrementally, whereas areas split
+ * by golden moves are rebuilt when the index is refreshed, in time linear
+ * in the split area. With the refreshed index gamma_golden_possible counts
+ * safe targets and cut targets near the player, and gamma_legal_mask reads
+ * feasibility of golden move on every field, without searching areas.
+ * check_golden_move, which does not modify the game, reads the index for
+ * fields whose owner's areas were not split since the last refresh.
+ *
+ * @author Antoni Koszowski <a.koszowski@students.mimuw.edu.pl>
+ * @copyright
+ * @date 17.06.2020
+ */
+
+#ifndef CUT_POINTS_H
+#define CUT_POINTS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "board_utilities.h"
+
+/**
+ * Structure storing index of articulation points of players' areas.
+ */
+typedef struct cut_points cut_points_t;
+
+/** @brief Creates index of articulation points.
+ * Allocates memory for a new index of articulation points of areas
+ * on board pointed by @p b, occupied by @p players_num players,
+ * and builds it for current state of the board.
+ * @param[in] b           – pointer to the board,
+ * @param[in] players_num – number of players.
+ * @return Pointer to the newly created structure or NULL in case of
+ * memory was not allocated.
+ */
+cut_points_t *alloc_cut_points(board_t *b, uint32_t players_num);
+
+/**@brief Deletes index of articulation points.
+ * Deletes from memory structure pointed by @p cp.
+ * Nothing happens if the pointer's value is NULL.
+ * @param[in] cp          – pointer to structure that will be removed.
+ */
+void delete_cut_points(cut_points_t *cp);
+
+/**@brief Adds captured field to the index.
+ * Updates index pointed by @p cp after field with index @p f on board
+ * pointed by @p b has been captured. Must be called after the owner
+ * of the field is set up, but before the field is joined with adjacent areas.
+ * Terminates the program if memory could not be allocated.
+ * @param[in,out] cp      – pointer to the index,
+ * @param[in] b           – pointer to the board,
+ * @param[in] f           – index of the captured field.
+ */
+void capture_cut_points(cut_points_t *cp, board_t *b, uint32_t f);
+
+/**@brief Removes field from the index.
+ * Updates index pointed by @p cp when field with index @p f on board
+ * pointed by @p b is about to be released. Must be called before the field
+ * is marked as free. Areas of the former owner are rebuilt on next refresh.
+ * Terminates the program if memory could not be allocated.
+ * @param[in,out] cp      – pointer to the index,
+ * @param[in] b           – pointer to the board,
+ * @param[in] f           – index of the released field.
+ */
+void release_cut_points(cut_points_t *cp, board_t *b, uint32_t f);
+
+/**@brief Brings the index up to date.
+ * Rebuilds areas on board pointed by @p b that were split since last refresh
+ * of index pointed by @p cp.
+ * Terminates the program if memory could not be allocated.
+ * @param[in,out] cp      – pointer to the index,
+ * @param[in] b           – pointer to the board.
+ */
+void refresh_cut_points(cut_points_t *cp, board_t *b);
+
+/**@brief Gives number of areas emerging after exclusion of the field.
+ * Gives number of areas that the area of field with index @p f would be split
+ * into after the field is excluded, according to refreshed index
+ * pointed by @p cp.
+ * @param[in] cp          – pointer to the index,
+ * @param[in] f           – index of the occupied field.
+ * @return Number of areas emerging after exclusion of the field.
+ */
+uint32_t field_fragments(cut_points_t *cp, uint32_t f);
+
+/**@brief Checks whether areas of the player are indexed.
+ * Checks whether block-cut trees of areas of player @p player_id in index
+ * pointed by @p cp are up to date, that is none of its areas was split
+ * since last refresh. The index is not modified.
+ * @param[in] cp          – pointer to the index,
+ * @param[in] player_id   – player identifier.
+ * @return Value @p true if areas of the player are indexed,
+ * @p false otherwise.
+ */
+bool fresh_areas(const cut_points_t *cp, uint32_t player_id);
+
+/**@brief Gives number of safe targets of golden move.
+ * Gives number of fields adjacent to areas of player @p player_id, occupied
+ * by another players, whose exclusion would not increase number of areas
+ * of their owners, according to refreshed index pointed by @p cp.
+ * @param[in] cp          – pointer to the index,
+ * @param[in] player_id   – player identifier.
+ * @return Number of safe targets.
+ */
+uint64_t safe_targets(cut_points_t *cp, uint32_t player_id);
+
+/**@brief Gives number of articulation points adjacent to player's areas.
+ * Gives number of fields adjacent to areas of player @p player_id, occupied
+ * by another players, whose exclusion would split areas of their owners,
+ * according to refreshed index pointed by @p cp.
+ * @param[in] cp          – pointer to the index,
+ * @param[in] player_id   – player identifier.
+ * @return Number of articulation points adjacent to player's areas.
+ */
+uint64_t cut_targets(cut_points_t *cp, uint32_t player_id);
+
+#endif /* CUT_POINTS_H */
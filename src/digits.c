@@ -0,0 +1,36 @@
+/**@file
+ * Implementation of formatting of decimal numbers.
+ *
+ * @author Antoni Koszowski <a.koszowski@students.mimuw.edu.pl>
+ * @copyright
+ * @date 17.06.2020
+ */
+
+#include <string.h>
+#include "digits.h"
+
+/**
+ * Decimal representations of numbers from 0 to 99, two digits each.
+ */
+static const char digit_pairs[] =
+        "00010203040506070809101112131415161718192021222324252627282930313233"
+        "34353637383940414243444546474849505152535455565758596061626364656667"
+        "6869707172737475767778798081828384858687888990919293949596979899";
+
+char *format_number(char *end, uint64_t value) {
+    char *pos = end;
+
+    while (value >= 100) {
+        pos -= 2;
+        memcpy(pos, &digit_pairs[2 * (value % 100)], 2);
+        value /= 100;
+    }
+    if (value >= 10) {
+        pos -= 2;
+        memcpy(pos, &digit_pairs[2 * value], 2);
+    } else {
+        *--pos = (char) ('0' + value);
+    }
+
+    return pos;
+}
@@ -0,0 +1,24 @@
+/**@file
+ * Interface of formatting of decimal numbers.
+ *
+ * @author Antoni Koszowski <a.koszowski@students.mimuw.edu.pl>
+ * @copyright
+ * @date 17.06.2020
+ */
+
+#ifndef DIGITS_H
+#define DIGITS_H
+
+#include <stdint.h>
+
+/**@brief Formats a number.
+ * Writes decimal number @p value ending at @p end, without terminating
+ * null character. Digits are written in pairs taken from a table, so
+ * a number takes one division per two digits.
+ * @param[in,out] end     – position following the last digit,
+ * @param[in] value       – written number.
+ * @return Position of the first digit.
+ */
+char *format_number(char *end, uint64_t value);
+
+#endif /* DIGITS_H */
@@ -0,0 +1,91 @@
+/**@file
+ * Implementation of parallel search for a field on gamma game board.
+ *
+ * @author Antoni Koszowski <a.koszowski@students.mimuw.edu.pl>
+ * @copyright
+ * @date 17.06.2020
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include "field_scan.h"
+#include "worker_pool.h"
+
+/**
+ * Number of fields checked by the calling thread on its own,
+ * before any worker thread is started.
+ */
+#define FIELDS_PER_WORKER (1u << 16)
+
+/**
+ * Structure storing state of the scan shared by all workers.
+ */
+typedef struct scan {
+    board_t *b;                 ///< pointer to the scanned board
+    field_check_t check;        ///< checked condition
+    void *data;                 ///< data passed to the condition
+    atomic_uint_fast32_t row;   ///< next row to be handed out
+    atomic_bool found;          ///< whether some field met the condition
+} scan_t;
+
+/**@brief Checks rows of the board.
+ * Checks fields of rows taken one by one from scan pointed by @p arg,
+ * until no row is left or some field meets the condition. A worker whose
+ * scratch space could not be allocated takes no rows, leaving them
+ * to the others.
+ * @param[in,out] arg     – pointer to the scan.
+ * @return Value NULL.
+ */
+static void *scan_rows(void *arg) {
+    scan_t *scan = arg;
+    board_t *b = scan->b;
+    uint32_t y, x, f;
+    search_t *s = alloc_search();
+
+    if (s == NULL || !prepare_search(b, s)) {
+        delete_search(s);
+        return NULL;
+    }
+
+    while (!atomic_load_explicit(&scan->found, memory_order_relaxed)) {
+        y = atomic_fetch_add(&scan->row, 1);
+        if (y >= b->height) {
+            break;
+        }
+
+        f = field_index(b, 0, y);
+        for (x = 0; x < b->width; ++x, ++f) {
+            if (scan->check(scan->data, s, f)) {
+                atomic_store(&scan->found, true);
+                break;
+            } else if (atomic_load_explicit(&scan->found,
+                                            memory_order_relaxed)) {
+                break;
+            }
+        }
+    }
+
+    delete_search(s);
+
+    return NULL;
+}
+
+bool scan_fields(board_t *b, field_check_t check, void *data, bool *found) {
+    scan_t scan;
+
+    scan.b = b;
+    scan.check = check;
+    scan.data = data;
+    atomic_init(&scan.row, 0);
+    atomic_init(&scan.found, false);
+
+    run_pool(scan_rows, &scan, pool_size((uint64_t) b->width * b->height,
+                                         FIELDS_PER_WORKER, b->height));
+
+    // Rows are left only if no worker could take them.
+    *found = atomic_load(&scan.found);
+
+    return *found || atomic_load(&scan.row) >= b->height;
+}
@@ -0,0 +1,40 @@
+/**@file
+ * Interface of parallel search for a field on gamma game board.
+ *
+ * Rows of the board are handed out to a pool of worker threads, each of
+ * them with its own scratch space for searching areas, and all workers stop
+ * as soon as one of them finds a field meeting the condition.
+ *
+ * @author Antoni Koszowski <a.koszowski@students.mimuw.edu.pl>
+ * @copyright
+ * @date 17.06.2020
+ */
+
+#ifndef FIELD_SCAN_H
+#define FIELD_SCAN_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "board_utilities.h"
+
+/**
+ * Condition checked for fields, given data passed to @ref scan_fields,
+ * scratch space of the worker and index of the field. It may be checked
+ * for many fields at once, so it must not modify the board nor the data.
+ */
+typedef bool (*field_check_t)(void *data, search_t *s, uint32_t f);
+
+/**@brief Looks for a field meeting the condition.
+ * Checks condition @p check with data @p data for fields on board
+ * pointed by @p b, until some field meets it. Large boards are split by rows
+ * between worker threads, small ones are checked by the calling thread.
+ * @param[in] b           – pointer to the board,
+ * @param[in] check       – checked condition,
+ * @param[in] data        – data passed to the condition,
+ * @param[out] found      – whether some field meets the condition.
+ * @return Value @p true if the board was checked; @p false if memory
+ * for scratch space of any worker could not be allocated.
+ */
+bool scan_fields(board_t *b, field_check_t check, void *data, bool *found);
+
+#endif /* FIELD_SCAN_H */
@@ -6,10 +6,20 @@
  * @date 17.04.2020
  */
 
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <pthread.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include "player.h"
 #include "board_utilities.h"
+#include "connectivity.h"
+#include "cut_points.h"
+#include "digits.h"
+#include "field_scan.h"
 #include "gamma.h"
 
 /**
@@ -21,7 +31,16 @@ struct gamma {
     uint32_t players_num;          ///< number of players in game
     uint32_t max_areas;            ///< maximal number of areas one can occupy
     uint64_t globally_free_fields; ///< number of free fields on board
-    field_t **board;               ///< pointer to structure representing board
+    uint64_t version;              ///< number of changes of state, from one
+    uint64_t canonical_hash;       ///< hash up to symmetries of the board
+    uint64_t canonical_version;    ///< version canonical_hash is valid for
+    uint64_t status_version;       ///< number of changes of statuses in game
+    uint64_t over_version;         ///< version over is valid for
+    uint64_t over_status_version;  ///< status_version over is valid for
+    bool over;                     ///< whether no player could make a move
+    board_t *board;                ///< pointer to structure representing board
+    cut_points_t *cut_points;      ///< index of articulation points or NULL
+    connectivity_t *connectivity;  ///< connectivity of areas or NULL
     player_t **players;            ///< pointer to array storing state of players
 };
 
@@ -31,7 +50,7 @@ struct gamma {
  * @param player_id       – player identifier.
  * @return Value @p true if both parameters are correct; @p false otherwise.
  */
-static bool preconditions(gamma_t *g, uint32_t player_id) {
+static bool preconditions(const gamma_t *g, uint32_t player_id) {
     if (g == NULL) {
         return false;
     } else if (player_id == 0 || player_id > g->players_num) {
@@ -41,26 +60,84 @@ static bool preconditions(gamma_t *g, uint32_t player_id) {
     }
 }
 
+/**@brief Changes value of the player.
+ * Sets up value of kind @p kind of player @p player_id in game pointed
+ * by @p g to @p value, recording the change if journal is kept.
+ * @param[in,out] g       – pointer to the current game,
+ * @param[in] player_id   – player identifier,
+ * @param[in] kind        – kind of the value,
+ * @param[in] value       – new value.
+ */
+static void set_player(gamma_t *g, uint32_t player_id, change_kind_t kind,
+                       uint64_t value) {
+    if (kind == CHANGE_IN_GAME &&
+        g->players[player_id]->in_game != (value != 0)) {
+        g->status_version++;
+    }
+
+    change_player(g->board, g->players, player_id, kind, value);
+}
+
+/**@brief Sets up number of free fields on board.
+ * Sets up number @p value of free fields on board in game pointed by @p g,
+ * recording the change if journal is kept.
+ * @param[in,out] g       – pointer to the current game,
+ * @param[in] value       – new number of free fields.
+ */
+static void set_free_fields(gamma_t *g, uint64_t value) {
+    if (g->board->journal != NULL) {
+        record_change(g->board->journal, CHANGE_FREE_FIELDS, 0,
+                      g->globally_free_fields);
+    }
+
+    g->globally_free_fields = value;
+}
+
+/**@brief Restores recorded value.
+ * Restores value of game pointed by @p data recorded in change
+ * pointed by @p c, storing replaced value in the change.
+ * @param[in,out] data    – pointer to the game,
+ * @param[in,out] c       – pointer to the change.
+ */
+static void restore_game(void *data, change_t *c) {
+    gamma_t *g = data;
+    uint64_t value = c->value;
+
+    if (c->kind == CHANGE_FREE_FIELDS) {
+        c->value = g->globally_free_fields;
+        g->globally_free_fields = value;
+    } else if (c->kind == CHANGE_OWNER && g->connectivity != NULL) {
+        // Edges of the field follow its owner.
+        release_connectivity(g->connectivity, g->board, c->index);
+        restore_change(g->board, g->players, c);
+        capture_connectivity(g->connectivity, g->board, c->index);
+    } else {
+        restore_change(g->board, g->players, c);
+    }
+}
+
 /**@brief Updates state of player.
- * Updates state of player represented by structure pointed by @p p
- * whose identifier is @p player_id, inter alia, his status in game as well as
- * number of free fields he can capture on board
- * in game represented by the pointer @p g.
+ * Updates state of player @p player_id, inter alia, his status in game
+ * as well as number of free fields he can capture on board in game
+ * represented by the pointer @p g.
+ * Takes constant time, since the number of free fields adjacent to player's
+ * areas is kept up to date by every move. Number of free fields is always
+ * updated before it is used, so its changes are not recorded in journal.
  * @param[in] g           – pointer to the current game,
- * @param[in] p           – pointer to the structure representing player,
- * @param[in] player_id   – number identifying player.
+ * @param[in] player_id   – player identifier.
  */
-static void update_player_state(gamma_t *g, player_t *p, uint32_t player_id) {
+static void update_player_state(gamma_t *g, uint32_t player_id) {
+    player_t *p = g->players[player_id];
     uint64_t counted = 0;
 
     if (p->busy_areas == g->max_areas) {
-        counted = count_free_fields(g->board, player_id, g->width, g->height);
+        counted = p->border_fields;
         p->free_fields = counted;
 
         if (counted == 0 && p->golden_used) {
-            p->in_game = false;
+            set_player(g, player_id, CHANGE_IN_GAME, false);
         } else if (!p->in_game) {
-            p->in_game = true;
+            set_player(g, player_id, CHANGE_IN_GAME, true);
         }
     } else if (p->busy_areas < g->max_areas) {
         p->free_fields = g->globally_free_fields;
@@ -83,22 +160,139 @@ gamma_t *gamma_new(uint32_t width, uint32_t height,
     g->players_num = players_num;
     g->max_areas = max_areas;
     g->globally_free_fields = (uint64_t) width * height;
-
-    g->board = alloc_board(width, height);
+    g->version = 1;
+    g->canonical_version = 0;
+    g->status_version = 0;
+    g->over_version = 0;
+    g->over_status_version = 0;
+    g->over = false;
+
+    g->cut_points = NULL;
+    g->connectivity = NULL;
+    g->board = alloc_board(width, height, players_num);
     if (g->board == NULL) {
         free(g);
 
         return NULL;
     }
 
+    g->board->live = alloc_live_set(players_num, max_areas);
+    if (g->board->live == NULL) {
+        delete_board(g->board);
+        free(g);
+
+        return NULL;
+    }
+
     g->players = alloc_players(players_num);
     if (g->players == NULL) {
-        delete_board(g->board, height);
+        delete_board(g->board);
         free(g);
 
         return NULL;
     }
 
+    // Small boards are also kept as bitboards, larger ones are not.
+    g->board->bits = alloc_bitboard(width, height, players_num);
+
+    return g;
+}
+
+gamma_t *gamma_clone(const gamma_t *g) {
+    if (g == NULL) {
+        return NULL;
+    }
+
+    gamma_t *copy = malloc(sizeof(struct gamma));
+    if (copy == NULL) {
+        return NULL;
+    }
+
+    *copy = *g;
+    copy->cut_points = NULL;
+    copy->connectivity = NULL;
+
+    copy->board = clone_board(g->board);
+    if (copy->board == NULL) {
+        free(copy);
+
+        return NULL;
+    }
+
+    copy->players = copy_players(g->players, g->players_num);
+    if (copy->players == NULL) {
+        delete_board(copy->board);
+        free(copy);
+
+        return NULL;
+    }
+
+    return copy;
+}
+
+/**@brief Restores state of players.
+ * Forms areas of fields restored on board of game pointed by @p g,
+ * counting fields and areas of players, and sets up golden moves used
+ * given by @p golden_used.
+ * @param[in,out] g        – pointer to the restored game,
+ * @param[in] golden_used  – array of golden moves used.
+ * @return Value @p true if no player has more areas than allowed,
+ * @p false otherwise.
+ */
+static bool restore_players(gamma_t *g, const bool *golden_used) {
+    uint32_t player_id;
+    uint64_t busy_fields = 0;
+
+    label_areas(g->board, g->players, g->players_num);
+
+    for (player_id = 1; player_id <= g->players_num; ++player_id) {
+        if (g->players[player_id]->busy_areas > g->max_areas) {
+            return false;
+        }
+
+        busy_fields += g->players[player_id]->busy_fields;
+        set_player(g, player_id, CHANGE_GOLDEN_USED, golden_used[player_id - 1]);
+    }
+
+    g->globally_free_fields -= busy_fields;
+
+    return true;
+}
+
+gamma_t *gamma_restore(uint32_t width, uint32_t height, uint32_t players,
+                       uint32_t areas, const uint32_t *owners,
+                       const bool *golden_used, const bool *in_game) {
+    uint32_t x, y;
+
+    if (owners == NULL || golden_used == NULL || in_game == NULL) {
+        return NULL;
+    }
+
+    gamma_t *g = gamma_new(width, height, players, areas);
+    if (g == NULL) {
+        return NULL;
+    }
+
+    for (y = 0; y < height; ++y, owners += width) {
+        for (x = 0; x < width; ++x) {
+            if (owners[x] > players) {
+                gamma_delete(g);
+
+                return NULL;
+            }
+        }
+
+        restore_row(g->board, y, owners);
+    }
+
+    if (!restore_players(g, golden_used)) {
+        gamma_delete(g);
+
+        return NULL;
+    }
+
+    gamma_set_statuses(g, in_game);
+
     return g;
 }
 
@@ -107,53 +301,129 @@ void gamma_delete(gamma_t *g) {
         return;
     }
 
-    delete_board(g->board, g->height);
+    delete_cut_points(g->cut_points);
+    delete_connectivity(g->connectivity);
+    delete_board(g->board);
     delete_players(g->players, g->players_num);
     free(g);
 }
 
-bool gamma_move(gamma_t *g, uint32_t player_id, uint32_t x, uint32_t y) {
-    if (!preconditions(g, player_id)) {
-        return false;
-    } else if (!params_ok(g->width, g->height, x, y)) {
-        return false;
+/**@brief Updates indices of areas after the field is captured.
+ * Updates index of articulation points and connectivity of areas in game
+ * pointed by @p g, if they are already built, after field with index @p f
+ * has been captured.
+ * Must be called before the field is joined with adjacent areas.
+ * @param[in,out] g       – pointer to the current game,
+ * @param[in] f           – index of the captured field.
+ */
+static void capture_field(gamma_t *g, uint32_t f) {
+    if (g->cut_points != NULL) {
+        capture_cut_points(g->cut_points, g->board, f);
+    }
+    if (g->connectivity != NULL) {
+        capture_connectivity(g->connectivity, g->board, f);
     }
+}
 
+/**@brief Places the piece on the field.
+ * Places the piece of player @p player_id on field with index @p f
+ * in game pointed by @p g, if it is possible.
+ * Parameters have to be checked beforehand.
+ * @param[in,out] g       – pointer to the current game,
+ * @param[in] player_id   – player identifier,
+ * @param[in] f           – index of the field.
+ * @return Value @p true if the piece was placed, @p false otherwise.
+ */
+static bool place_piece(gamma_t *g, uint32_t player_id, uint32_t f) {
     uint32_t joined_areas = 0;
     player_t *cur_player = g->players[player_id];
+    near_t n;
 
-    update_player_state(g, cur_player, player_id);
+    update_player_state(g, player_id);
 
     if (!cur_player->in_game) {
         return false;
-    } else if (field_owner(&g->board[y][x]) != 0) {
+    }
+
+    // Owners next to the field are read once for the whole move, owners
+    // around them only once it is known that the field is captured.
+    read_near(g->board, f, &n);
+    if (n.owner != 0) {
         return false;
     }
 
     // In case of new are is created,
     // checking whether max_areas limit is exceeded.
-    if (!adjacent_field(g->board, player_id, g->width, g->height, x, y)) {
+    if (!near_owner(&n, player_id)) {
         if (cur_player->busy_areas + 1 > g->max_areas) {
             return false;
         } else {
-            set_up_field(&g->board[y][x], player_id);
+            read_around(g->board, f, &n);
+            capture_borders(g->board, g->players, player_id, &n);
+            set_up_field(g->board, f, player_id);
+            capture_field(g, f);
 
-            cur_player->busy_areas++;
+            set_player(g, player_id, CHANGE_BUSY_AREAS,
+                       cur_player->busy_areas + 1);
         }
     } else {
-        set_up_field(&g->board[y][x], player_id);
-
-        joined_areas = union_adj(g->board, player_id, g->width, g->height, x,
-                                 y);
-        cur_player->busy_areas -= joined_areas - 1;
+        read_around(g->board, f, &n);
+        capture_borders(g->board, g->players, player_id, &n);
+        set_up_field(g->board, f, player_id);
+        capture_field(g, f);
+
+        joined_areas = union_adj(g->board, player_id, f);
+        set_player(g, player_id, CHANGE_BUSY_AREAS,
+                   cur_player->busy_areas - (joined_areas - 1));
     }
 
-    cur_player->busy_fields++;
-    g->globally_free_fields--;
+    set_player(g, player_id, CHANGE_BUSY_FIELDS, cur_player->busy_fields + 1);
+    set_free_fields(g, g->globally_free_fields - 1);
 
     return true;
 }
 
+/**@brief Ends step of the journal.
+ * Groups changes made by the move in game pointed by @p g, if it
+ * was executed and journal is kept, so that it can be undone. Changes
+ * made on the way by a move that was not executed are discarded.
+ * @param[in,out] g       – pointer to the current game,
+ * @param[in] executed    – whether the move was executed.
+ */
+static void end_step(gamma_t *g, bool executed) {
+    if (executed && g->board->journal != NULL) {
+        close_step(g->board->journal);
+    } else if (g->board->journal != NULL) {
+        discard_changes(g->board->journal, restore_game, g);
+    }
+}
+
+/**@brief Ends executed move.
+ * Ends step of the journal of game pointed by @p g, like @ref end_step.
+ * Version of the game changes with every executed move.
+ * @param[in,out] g       – pointer to the current game,
+ * @param[in] executed    – whether the move was executed.
+ * @return Value @p executed.
+ */
+static bool end_move(gamma_t *g, bool executed) {
+    end_step(g, executed);
+    if (executed) {
+        g->version++;
+    }
+
+    return executed;
+}
+
+bool gamma_move(gamma_t *g, uint32_t player_id, uint32_t x, uint32_t y) {
+    if (!preconditions(g, player_id)) {
+        return false;
+    } else if (!params_ok(g->width, g->height, x, y)) {
+        return false;
+    }
+
+    return end_move(g, place_piece(g, player_id, field_index(g->board, x, y)));
+}
+
 /**@brief Checks whether given player has stock areas.
  * Checks whether player @p player_id in game pointed by @param g
  * has stock areas that can be captured.
@@ -161,7 +431,7 @@ bool gamma_move(gamma_t *g, uint32_t player_id, uint32_t x, uint32_t y) {
  * @param player_id  - player id.
  * @return Value @p true if player has stock areas, @p false otherwise.
  */
-static bool has_stock_areas(gamma_t *g, uint32_t player_id) {
+static bool has_stock_areas(const gamma_t *g, uint32_t player_id) {
     player_t *cur_player = g->players[player_id];
 
     if (cur_player->busy_areas < g->max_areas) {
@@ -174,19 +444,19 @@ static bool has_stock_areas(gamma_t *g, uint32_t player_id) {
 /**@brief Checks whether golden_move prerequisites are met.
  * Checks whether in game pointed by @p g, golden move
  * prerequisites are met for player @p player_id.
+ * The game is not modified, since state of player is always updated
+ * before it is used.
  * @param g           - pointer to the game structure,
  * @param player_id   - player id.
  * @return Value @p true if prerequisites are met, @p false otherwise.
  */
-static bool golden_conditions(gamma_t *g, uint32_t player_id) {
+static bool golden_conditions(const gamma_t *g, uint32_t player_id) {
     if (!preconditions(g, player_id)) {
         return false;
     }
 
     player_t *cur_player = g->players[player_id];
 
-    update_player_state(g, cur_player, player_id);
-
     if (cur_player->golden_used) {
         return false;
     } else if (cur_player->busy_fields + g->globally_free_fields ==
@@ -197,209 +467,1491 @@ static bool golden_conditions(gamma_t *g, uint32_t player_id) {
     return true;
 }
 
-bool check_golden_move(gamma_t *g, uint32_t player_id, uint32_t x, uint32_t y) {
-    if (!golden_conditions(g, player_id)) {
-        return false;
-    }
-
-    uint32_t prev_owner_id = field_owner(&g->board[y][x]), areas_num = 0;
-    player_t *prev_owner = g->players[prev_owner_id];
+/**@brief Checks whether field can be a target of golden move.
+ * Checks whether field with index @p f in game pointed by @p g is occupied
+ * by another player and player @p player_id could place his piece there,
+ * not taking into account areas of field's owner.
+ * @param g           - pointer to the game structure,
+ * @param player_id   - player id,
+ * @param f           - index of the field.
+ * @return Value @p true if field can be a target, @p false otherwise.
+ */
+static bool golden_target(const gamma_t *g, uint32_t player_id, uint32_t f) {
+    uint32_t prev_owner_id = field_owner(g->board, f);
 
     if (prev_owner_id == player_id || prev_owner_id == 0) {
         return false;
     }
 
-    // Splitting prev_owner areas, determining number of newly emerged areas.
-    areas_num = prev_owner->busy_areas - 1;
-    areas_num += divide_adj(g->board, prev_owner_id, g->width, g->height, x, y);
-    union_adj(g->board, prev_owner_id, g->width, g->height, x, y);
-
-    if (areas_num > g->max_areas) {
-        return false;
-    }
-
     if (has_stock_areas(g, player_id)) {
         return true;
-    } else if (adjacent_field(g->board, player_id, g->width, g->height, x, y)) {
+    } else if (adjacent_field(g->board, player_id, f)) {
         return true;
     }
 
     return false;
 }
 
-bool gamma_golden_move(gamma_t *g, uint32_t player_id, uint32_t x, uint32_t y) {
-    if (!preconditions(g, player_id)) {
-        return false;
-    } else if (!params_ok(g->width, g->height, x, y)) {
-        return false;
-    } else if (!check_golden_move(g, player_id, x, y)) {
+/**@brief Checks whether golden move on the field is feasible.
+ * Checks whether player @p player_id, meeting golden move prerequisites
+ * in game pointed by @p g, can take over field with index @p f.
+ * Areas of field's owner are counted in scratch space pointed by @p s,
+ * the game is not modified.
+ * @param g           - pointer to the game structure,
+ * @param s           - pointer to the scratch space,
+ * @param player_id   - player id,
+ * @param f           - index of the field.
+ * @return Value @p true if golden move is feasible, @p false otherwise.
+ */
+static bool golden_feasible(const gamma_t *g, search_t *s,
+                            uint32_t player_id, uint32_t f) {
+    uint32_t prev_owner_id = field_owner(g->board, f), areas_num = 0;
+
+    if (!golden_target(g, player_id, f)) {
         return false;
     }
 
-    uint32_t prev_owner_id = field_owner(&g->board[y][x]), areas_num = 0;
-    player_t *prev_owner = g->players[prev_owner_id];
-    player_t *cur_player = g->players[player_id];
+    // Counting areas emerging from prev_owner areas.
+    areas_num = g->players[prev_owner_id]->busy_areas - 1;
+    areas_num += count_adj(g->board, s, prev_owner_id, f);
 
-    // Splitting prev_owner areas, determining number of newly emerged areas.
-    areas_num = prev_owner->busy_areas - 1;
-    areas_num += divide_adj(g->board, prev_owner_id, g->width, g->height, x, y);
+    return areas_num <= g->max_areas;
+}
 
-    g->board[y][x].owner_id = 0;
+/**
+ * Key of scratch space of the thread, used for checking golden moves.
+ */
+static pthread_key_t search_key;
 
-    // Checking whether cur_player can execute a move.
-    if (!gamma_move(g, player_id, x, y)) {
-        union_adj(g->board, prev_owner_id, g->width, g->height, x, y);
-        g->board[y][x].owner_id = prev_owner_id;
+/**
+ * Whether the key of scratch space of the thread was created.
+ */
+static bool search_key_made = false;
 
-        return false;
-    }
+/**
+ * Control of creating the key of scratch space of the thread.
+ */
+static pthread_once_t search_once = PTHREAD_ONCE_INIT;
 
-    cur_player->golden_used = true;
-    prev_owner->busy_areas = areas_num;
-    prev_owner->busy_fields--;
-    g->globally_free_fields++;
+/**@brief Deletes scratch space of a finishing thread.
+ * @param[in] s           – pointer to the scratch space.
+ */
+static void delete_thread_search(void *s) {
+    delete_search(s);
+}
 
-    return true;
+/**@brief Creates the key of scratch space of the thread.
+ */
+static void make_search_key(void) {
+    search_key_made = pthread_key_create(&search_key,
+                                         delete_thread_search) == 0;
 }
 
-bool gamma_golden_possible(gamma_t *g, uint32_t player_id) {
-    if (!preconditions(g, player_id)) {
-        return false;
-    } else if (!golden_conditions(g, player_id)) {
-        return false;
-    } else if (has_stock_areas(g, player_id)) {
-        return true;
+/**@brief Gives scratch space of the thread.
+ * Gives scratch space of the calling thread, prepared for searching
+ * board of game pointed by @p g, so that checks of golden moves neither
+ * modify the game nor share scratch space with other threads.
+ * @param[in] g           – pointer to the current game.
+ * @return Pointer to the scratch space or NULL if memory was not allocated.
+ */
+static search_t *thread_search(const gamma_t *g) {
+    search_t *s;
+
+    if (pthread_once(&search_once, make_search_key) != 0 || !search_key_made) {
+        return NULL;
     }
 
-    uint32_t i, j;
-    for (i = 0; i < g->height; ++i) {
-        for (j = 0; j < g->width; ++j) {
-            if (check_golden_move(g, player_id, j, i)) {
-                return true;
-            }
+    s = pthread_getspecific(search_key);
+    if (s == NULL) {
+        s = alloc_search();
+        if (s == NULL || pthread_setspecific(search_key, s) != 0) {
+            delete_search(s);
+            return NULL;
         }
     }
 
-    return false;
+    return prepare_search(g->board, s) ? s : NULL;
 }
 
-uint64_t gamma_busy_fields(gamma_t *g, uint32_t player_id) {
-    if (!preconditions(g, player_id)) {
-        return 0;
+/**@brief Checks whether golden move is legal on the field.
+ * Checks whether player @p player_id, meeting golden move prerequisites
+ * in game pointed by @p g, can take over field with index @p f. Areas
+ * of field's owner are counted using index of articulation points,
+ * if it is up to date, or in scratch space pointed by @p s otherwise.
+ * @param[in] g           – pointer to the current game,
+ * @param[in,out] s       – pointer to the scratch space, used only if index
+ *                          of articulation points is not up to date,
+ * @param[in] player_id   – player identifier,
+ * @param[in] f           – index of the field,
+ * @param[in] indexed     – whether index of articulation points is up to date.
+ * @return Value @p true if golden move is legal, @p false otherwise.
+ */
+static bool golden_legal(const gamma_t *g, search_t *s, uint32_t player_id,
+                         uint32_t f, bool indexed) {
+    if (!indexed) {
+        return golden_feasible(g, s, player_id, f);
+    } else if (!golden_target(g, player_id, f)) {
+        return false;
     }
 
-    player_t *cur_player = g->players[player_id];
-
-    return cur_player->busy_fields;
+    return g->players[field_owner(g->board, f)]->busy_areas - 1 +
+           field_fragments(g->cut_points, f) <= g->max_areas;
 }
 
-uint64_t gamma_free_fields(gamma_t *g, uint32_t player_id) {
-    if (!preconditions(g, player_id)) {
-        return 0;
+bool check_golden_move(const gamma_t *g, uint32_t player_id,
+                       uint32_t x, uint32_t y) {
+    search_t *s = NULL;
+    uint32_t f;
+
+    if (!golden_conditions(g, player_id)) {
+        return false;
+    } else if (!params_ok(g->width, g->height, x, y)) {
+        return false;
     }
 
-    player_t *cur_player = g->players[player_id];
+    // Areas of the owner are not searched while the index holds them.
+    f = field_index(g->board, x, y);
+    if (g->cut_points != NULL &&
+        fresh_areas(g->cut_points, field_owner(g->board, f))) {
+        return golden_legal(g, NULL, player_id, f, true);
+    }
 
-    update_player_state(g, cur_player, player_id);
+    s = thread_search(g);
+    if (s == NULL) {
+        return false;
+    }
 
-    return cur_player->free_fields;
+    return golden_feasible(g, s, player_id, f);
 }
 
 /**
- * Gives gamma game board cell width
- * @param players_num   - number of players.
- * @return Value @p counter - board cell width.
+ * Structure describing search for a target of golden move.
  */
-uint32_t get_cell_width(uint32_t players_num) {
-    int counter = 0;
+typedef struct golden_scan {
+    gamma_t *g;             ///< pointer to the game structure
+    uint32_t player_id;     ///< player making golden move
+} golden_scan_t;
+
+/**@brief Checks whether the field is a target of golden move.
+ * Checks whether field with index @p f is a feasible target of golden move
+ * described by @p data.
+ * @param data        - pointer to the structure describing the search,
+ * @param s           - pointer to the scratch space of the worker,
+ * @param f           - index of the field.
+ * @return Value @p true if golden move is feasible, @p false otherwise.
+ */
+static bool golden_check(void *data, search_t *s, uint32_t f) {
+    golden_scan_t *scan = data;
 
-    while (players_num > 0) {
-        counter++;
-        players_num /= 10;
-    }
+    return golden_feasible(scan->g, s, scan->player_id, f);
+}
 
-    if (counter > 1) {
-        counter++;
+/**@brief Checks whether the field is a feasible articulation point.
+ * Checks whether field with index @p f is adjacent to areas of player
+ * searching for golden move described by @p data, and its owner
+ * would not exceed limit of areas after losing it, according to refreshed
+ * index of articulation points.
+ * @param data        - pointer to the structure describing the search,
+ * @param s           - pointer to the scratch space of the worker, unused,
+ * @param f           - index of the field.
+ * @return Value @p true if golden move is feasible, @p false otherwise.
+ */
+static bool cut_check(void *data, search_t *s, uint32_t f) {
+    golden_scan_t *scan = data;
+    gamma_t *g = scan->g;
+    uint32_t owner_id = field_owner(g->board, f);
+
+    (void) s;
+
+    if (owner_id == 0 || owner_id == scan->player_id ||
+        !adjacent_field(g->board, scan->player_id, f)) {
+        return false;
     }
 
-    return counter;
+    return g->players[owner_id]->busy_areas - 1 +
+           field_fragments(g->cut_points, f) <= g->max_areas;
 }
 
-char *get_cell_content(gamma_t *g, uint32_t x, uint32_t y) {
-    uint32_t cell_width = get_cell_width(g->players_num);
-    uint32_t owner_id = 0, i = 0;
-    bool dots = false, spaces = false;
+/**@brief Looks for a feasible articulation point using bitboards.
+ * Checks, like @ref cut_check, fields adjacent to areas of player
+ * @p player_id in game pointed by @p g, visiting only fields of other
+ * players given by bitboards of the board.
+ * @param g           - pointer to the game structure,
+ * @param player_id   - player id.
+ * @return Value @p true if golden move is feasible, @p false otherwise.
+ */
+static bool cut_rows(gamma_t *g, uint32_t player_id) {
+    bitboard_t *bits = g->board->bits;
+    uint32_t x, y, f, owner_id;
+    uint64_t row;
 
-    char *cell_content = malloc(sizeof(char) * (cell_width + 1));
-    if (cell_content == NULL) {
-        exit(1);
-    }
+    for (y = 0; y < g->height; ++y) {
+        row = adjacent_row(bits, player_id, y) & rivals_row(bits, player_id, y);
 
-    owner_id = field_owner(&g->board[y][x]);
-    if (owner_id == 0) {
-        dots = true;
-    }
-
-    for (i = cell_width; i > 0; --i) {
-        if (i == cell_width && i > 1) {
-            cell_content[i - 1] = ' ';
-        } else if (dots) {
-            cell_content[i - 1] = '.';
-            dots = false;
-            spaces = true;
-        } else if (spaces) {
-            cell_content[i - 1] = ' ';
-        } else {
-            cell_content[i - 1] = '0' + owner_id % 10;
-            owner_id /= 10;
+        for (; row != 0; row &= row - 1) {
+            x = lowest_bit(row);
+            f = field_index(g->board, x, y);
+            owner_id = field_owner(g->board, f);
 
-            if (owner_id == 0) {
-                spaces = true;
+            if (g->players[owner_id]->busy_areas - 1 +
+                field_fragments(g->cut_points, f) <= g->max_areas) {
+                return true;
             }
         }
     }
 
-    cell_content[cell_width] = '\0';
+    return false;
+}
 
-    return cell_content;
+/**@brief Builds connectivity of areas of the player.
+ * Builds connectivity of areas of player @p owner_id in game pointed
+ * by @p g, when it is needed for the first time, that is on the first golden
+ * move on a field of the player. Since then it is kept up to date by every
+ * move, while moves on fields of other players do not touch it.
+ * @param[in,out] g       – pointer to the current game,
+ * @param[in] owner_id    – identifier of the player.
+ * @return Value @p true if connectivity of areas is kept, @p false if memory
+ * for it was not allocated.
+ */
+static bool connect_areas(gamma_t *g, uint32_t owner_id) {
+    if (g->connectivity == NULL) {
+        g->connectivity = alloc_connectivity(g->board, g->players_num);
+        if (g->connectivity == NULL) {
+            return false;
+        }
+    }
+
+    track_player(g->connectivity, g->board, owner_id);
+
+    return true;
 }
 
-char *gamma_board(gamma_t *g) {
-    if (g == NULL) {
-        return NULL;
+/**@brief Splits areas of owner of the field.
+ * Splits areas of player @p owner_id in game pointed by @p g after exclusion
+ * of field with index @p f, unless number of areas would exceed the limit.
+ * The field is cut out of connectivity of areas, which gives the number
+ * of emerging areas without searching them, and fields of all of them but
+ * the largest one are attached to new nodes. Areas are searched only
+ * if connectivity of areas could not be built.
+ * @param[in,out] g       – pointer to the current game,
+ * @param[in] owner_id    – owner of the field,
+ * @param[in] f           – index of the field.
+ * @return Number of areas of the player after exclusion of the field,
+ * or a number above the limit if the areas were not split.
+ */
+static uint32_t split_areas(gamma_t *g, uint32_t owner_id, uint32_t f) {
+    uint32_t areas_num = g->players[owner_id]->busy_areas - 1;
+
+    if (!connect_areas(g, owner_id)) {
+        areas_num += divide_adj(g->board, owner_id, f);
+        if (areas_num > g->max_areas) {
+            union_adj(g->board, owner_id, f);
+        }
+
+        return areas_num;
     }
 
-    uint32_t cell_width = get_cell_width(g->players_num);
-    uint64_t row_width = (uint64_t) g->width * cell_width + 1;
-    uint64_t cells = (uint64_t) row_width * g->height;
-    uint64_t i = 0, k = 0, x = 0, y = 0;
+    areas_num += release_connectivity(g->connectivity, g->board, f);
+    if (areas_num > g->max_areas) {
+        capture_connectivity(g->connectivity, g->board, f);
+    } else {
+        split_fragments(g->connectivity, g->board, f);
+    }
 
-    char *cell_content;
-    char *b = malloc(sizeof(char) * (cells + 1));
-    if (b == NULL) {
-        exit(1);
+    return areas_num;
+}
+
+/**@brief Places the piece on the field using golden move.
+ * Places the piece of player @p player_id on field with index @p f
+ * in game pointed by @p g, occupied by another player, if it is possible.
+ * Parameters have to be checked beforehand.
+ * @param[in,out] g       – pointer to the current game,
+ * @param[in] player_id   – player identifier,
+ * @param[in] f           – index of the field.
+ * @return Value @p true if the piece was placed, @p false otherwise.
+ */
+static bool place_golden_piece(gamma_t *g, uint32_t player_id, uint32_t f) {
+    // Status in game is refreshed by every attempted golden move, also
+    // one which is not executed, as well as by queries about the player.
+    update_player_state(g, player_id);
+
+    if (!golden_conditions(g, player_id)) {
+        return false;
     }
 
-    while (i < cells) {
-        y = i / row_width;
-        k = row_width * (g->height - y - 1) + x * cell_width;
+    uint32_t areas_num = 0;
+    uint32_t prev_owner_id = field_owner(g->board, f);
+    player_t *prev_owner = g->players[prev_owner_id];
+    near_t n;
 
-        if (i % row_width == row_width - 1) {
-            b[k] = '\n';
-            x = 0;
-            i++;
-        } else {
-            cell_content = get_cell_content(g, x, y);
-            strcpy(&b[k], cell_content);
+    if (!golden_target(g, player_id, f)) {
+        return false;
+    }
 
-            x++;
-            i += cell_width;
+    // Splitting prev_owner areas, determining number of newly emerged areas.
+    areas_num = split_areas(g, prev_owner_id, f);
+    if (areas_num > g->max_areas) {
+        return false;
+    }
 
-            free(cell_content);
-        }
+    if (g->cut_points != NULL) {
+        release_cut_points(g->cut_points, g->board, f);
     }
+    release_field(g->board, f);
+    release_borders(g->board, g->players, prev_owner_id, f);
 
-    b[cells] = '\0';
+    // Checking whether cur_player can execute a move.
+    if (!place_piece(g, player_id, f)) {
+        read_near(g->board, f, &n);
+        read_around(g->board, f, &n);
+        capture_borders(g->board, g->players, prev_owner_id, &n);
+        set_up_field(g->board, f, prev_owner_id);
+        capture_field(g, f);
+        union_adj(g->board, prev_owner_id, f);
 
-    return b;
+        return false;
+    }
+
+    set_player(g, player_id, CHANGE_GOLDEN_USED, true);
+    set_player(g, prev_owner_id, CHANGE_BUSY_AREAS, areas_num);
+    set_player(g, prev_owner_id, CHANGE_BUSY_FIELDS,
+               prev_owner->busy_fields - 1);
+    set_free_fields(g, g->globally_free_fields + 1);
+
+    return true;
+}
+
+bool gamma_golden_move(gamma_t *g, uint32_t player_id, uint32_t x, uint32_t y) {
+    if (!preconditions(g, player_id)) {
+        return false;
+    } else if (!params_ok(g->width, g->height, x, y)) {
+        return false;
+    }
+
+    return end_move(g, place_golden_piece(g, player_id,
+                                          field_index(g->board, x, y)));
+}
+
+bool gamma_move_batch(gamma_t *g, const gamma_move_record_t *moves,
+                      uint64_t n, bool *results) {
+    uint64_t i;
+    uint32_t f;
+    bool executed = false;
+
+    if (g == NULL) {
+        return false;
+    } else if (n > 0 && (moves == NULL || results == NULL)) {
+        return false;
+    }
+
+    // Each move updates state of its player only, in constant time. It can
+    // not be deferred to the end of the batch, since status in game decides
+    // whether the next move of the player is legal, and moves of one player
+    // change border fields of others. Only the version, which drops cached
+    // answers of all players, is changed once for the whole batch.
+    for (i = 0; i < n; ++i) {
+        results[i] = false;
+
+        if (moves[i].player_id == 0 || moves[i].player_id > g->players_num) {
+            continue;
+        } else if (!params_ok(g->width, g->height, moves[i].x, moves[i].y)) {
+            continue;
+        }
+
+        f = field_index(g->board, moves[i].x, moves[i].y);
+
+        if (moves[i].kind == GAMMA_MOVE) {
+            results[i] = place_piece(g, moves[i].player_id, f);
+        } else if (moves[i].kind == GAMMA_GOLDEN_MOVE) {
+            results[i] = place_golden_piece(g, moves[i].player_id, f);
+        }
+
+        end_step(g, results[i]);
+        executed = executed || results[i];
+    }
+
+    if (executed) {
+        g->version++;
+    }
+
+    return true;
+}
+
+/**@brief Brings index of articulation points up to date.
+ * Builds index of articulation points in game pointed by @p g, when it is
+ * needed for the first time, and refreshes it.
+ * @param[in,out] g       – pointer to the current game.
+ * @return Value @p true if the index is up to date, @p false if memory
+ * for it was not allocated.
+ */
+static bool refresh_index(gamma_t *g) {
+    if (g->cut_points == NULL) {
+        g->cut_points = alloc_cut_points(g->board, g->players_num);
+        if (g->cut_points == NULL) {
+            return false;
+        }
+    }
+
+    refresh_cut_points(g->cut_points, g->board);
+
+    return true;
+}
+
+/**@brief Looks for a field on which player can execute a golden move.
+ * Checks whether player @p player_id, meeting golden move prerequisites
+ * in game pointed by @p g, can execute a golden move on any field.
+ * @param[in,out] g       – pointer to the current game,
+ * @param[in] player_id   – player identifier,
+ * @param[out] possible   – whether golden move is possible.
+ * @return Value @p true if the answer is known, @p false if memory
+ * for searching the board was not allocated.
+ */
+static bool find_golden_move(gamma_t *g, uint32_t player_id, bool *possible) {
+    *possible = true;
+    if (has_stock_areas(g, player_id)) {
+        return true;
+    }
+
+    golden_scan_t scan = {g, player_id};
+
+    if (!refresh_index(g)) {
+        return scan_fields(g->board, golden_check, &scan, possible);
+    }
+
+    if (safe_targets(g->cut_points, player_id) > 0) {
+        return true;
+    } else if (cut_targets(g->cut_points, player_id) == 0) {
+        *possible = false;
+        return true;
+    }
+
+    // Only articulation points are left, checking whether any of them
+    // would not split area of its owner too much.
+    if (g->board->bits != NULL) {
+        *possible = cut_rows(g, player_id);
+        return true;
+    }
+
+    return scan_fields(g->board, cut_check, &scan, possible);
+}
+
+bool gamma_golden_possible(gamma_t *g, uint32_t player_id) {
+    bool possible;
+
+    if (!preconditions(g, player_id)) {
+        return false;
+    }
+
+    // Like gamma_free_fields, the query refreshes status in game.
+    update_player_state(g, player_id);
+
+    if (!golden_conditions(g, player_id)) {
+        return false;
+    }
+
+    player_t *cur_player = g->players[player_id];
+
+    // Answer is kept until the state of game changes, unless it is unknown.
+    if (cur_player->golden_version != g->version) {
+        if (!find_golden_move(g, player_id, &possible)) {
+            return false;
+        }
+
+        cur_player->golden_possible = possible;
+        cur_player->golden_version = g->version;
+    }
+
+    return cur_player->golden_possible;
+}
+
+/**@brief Checks whether player would stay in game.
+ * Checks whether player @p player_id in game pointed by @p g would be
+ * in game after his state was updated, without updating it.
+ * @param[in] g           – pointer to the current game,
+ * @param[in] player_id   – player identifier.
+ * @return Value @p true if player would be in game, @p false otherwise.
+ */
+static bool stays_in_game(gamma_t *g, uint32_t player_id) {
+    player_t *p = g->players[player_id];
+
+    if (p->busy_areas == g->max_areas) {
+        return p->border_fields > 0 || !p->golden_used;
+    }
+
+    return p->in_game;
+}
+
+/**@brief Checks whether move is legal on the field.
+ * Checks whether player @p player_id, who would stay in game pointed
+ * by @p g, can place his piece on field with index @p f.
+ * @param[in] g           – pointer to the current game,
+ * @param[in] player_id   – player identifier,
+ * @param[in] f           – index of the field.
+ * @return Value @p true if move is legal, @p false otherwise.
+ */
+static bool move_legal(gamma_t *g, uint32_t player_id, uint32_t f) {
+    if (field_owner(g->board, f) != 0) {
+        return false;
+    }
+
+    return has_stock_areas(g, player_id) ||
+           adjacent_field(g->board, player_id, f);
+}
+
+/**@brief Gives fields of the row on which move is legal.
+ * Gives bits of fields in row @p y, among fields @p cols, on which player
+ * @p player_id, who would stay in game pointed by @p g, can execute a move
+ * of kind @p kind, using bitboards of the board.
+ * @param[in] g           – pointer to the current game,
+ * @param[in,out] s       – pointer to the scratch space, used only if index
+ *                          of articulation points is not up to date,
+ * @param[in] player_id   – player identifier,
+ * @param[in] kind        – kind of the move,
+ * @param[in] y           – number of the row,
+ * @param[in] cols        – bits of checked fields of the row,
+ * @param[in] indexed     – whether index of articulation points is up to date.
+ * @return Bits of fields on which move is legal.
+ */
+static uint64_t legal_row(gamma_t *g, search_t *s, uint32_t player_id,
+                          gamma_move_kind_t kind, uint32_t y, uint64_t cols,
+                          bool indexed) {
+    bitboard_t *bits = g->board->bits;
+    uint64_t row, legal = 0;
+    uint32_t x;
+
+    if (has_stock_areas(g, player_id)) {
+        row = cols;
+    } else {
+        row = adjacent_row(bits, player_id, y) & cols;
+    }
+
+    if (kind == GAMMA_MOVE) {
+        return row & bits->free[y];
+    }
+
+    // Only fields of other players, which are potential targets, are checked.
+    for (row &= rivals_row(bits, player_id, y); row != 0; row &= row - 1) {
+        x = lowest_bit(row);
+
+        if (golden_legal(g, s, player_id, field_index(g->board, x, y),
+                         indexed)) {
+            legal |= (uint64_t) 1 << x;
+        }
+    }
+
+    return legal;
+}
+
+/**@brief Stores fields of the row in the bitmap.
+ * Stores bits @p row, of @p w fields, in bitmap @p bitmap starting
+ * from bit number @p first.
+ * @param[in,out] bitmap  – bitmap of the rectangle,
+ * @param[in] first       – number of bit of the first field of the row,
+ * @param[in] w           – number of fields in the row,
+ * @param[in] row         – bits of fields in the row.
+ */
+static void store_row(uint64_t *bitmap, uint64_t first, uint32_t w,
+                      uint64_t row) {
+    uint32_t shift = first % 64;
+
+    if (row == 0) {
+        return;
+    }
+
+    bitmap[first / 64] |= row << shift;
+    if (shift > 0 && shift + w > 64) {
+        bitmap[first / 64 + 1] |= row >> (64 - shift);
+    }
+}
+
+bool gamma_legal_mask_region(gamma_t *g, uint32_t player_id,
+                             gamma_move_kind_t kind, uint32_t x0, uint32_t y0,
+                             uint32_t w, uint32_t h, uint64_t *bitmap_out) {
+    uint64_t bit = 0, cols;
+    uint32_t x, y, f;
+    bool indexed = false, legal = false;
+    search_t *s = NULL;
+
+    if (!preconditions(g, player_id) || bitmap_out == NULL) {
+        return false;
+    } else if (kind != GAMMA_MOVE && kind != GAMMA_GOLDEN_MOVE) {
+        return false;
+    } else if (w == 0 || x0 >= g->width || w > g->width - x0) {
+        return false;
+    } else if (h == 0 || y0 >= g->height || h > g->height - y0) {
+        return false;
+    }
+
+    memset(bitmap_out, 0, sizeof(uint64_t) * (((uint64_t) w * h + 63) / 64));
+
+    if (kind == GAMMA_MOVE) {
+        if (!stays_in_game(g, player_id)) {
+            return true;
+        }
+    } else {
+        // Player taking over a field adjacent to his areas stays in game,
+        // since the field is free for a moment.
+        if (!golden_conditions(g, player_id)) {
+            return true;
+        } else if (has_stock_areas(g, player_id) &&
+                   !g->players[player_id]->in_game) {
+            return true;
+        }
+
+        indexed = refresh_index(g);
+        if (!indexed) {
+            s = thread_search(g);
+            if (s == NULL) {
+                return false;
+            }
+        }
+    }
+
+    if (g->board->bits != NULL) {
+        cols = w == 64 ? UINT64_MAX : (((uint64_t) 1 << w) - 1) << x0;
+
+        for (y = y0; y < y0 + h; ++y, bit += w) {
+            store_row(bitmap_out, bit, w,
+                      legal_row(g, s, player_id, kind, y, cols, indexed) >> x0);
+        }
+
+        return true;
+    }
+
+    for (y = y0; y < y0 + h; ++y) {
+        f = field_index(g->board, x0, y);
+
+        for (x = 0; x < w; ++x, ++f, ++bit) {
+            if (kind == GAMMA_MOVE) {
+                legal = move_legal(g, player_id, f);
+            } else {
+                legal = golden_legal(g, s, player_id, f, indexed);
+            }
+
+            if (legal) {
+                bitmap_out[bit / 64] |= (uint64_t) 1 << (bit % 64);
+            }
+        }
+    }
+
+    return true;
+}
+
+bool gamma_legal_mask(gamma_t *g, uint32_t player_id, gamma_move_kind_t kind,
+                      uint64_t *bitmap_out) {
+    if (g == NULL) {
+        return false;
+    }
+
+    return gamma_legal_mask_region(g, player_id, kind, 0, 0,
+                                   g->width, g->height, bitmap_out);
+}
+
+bool gamma_journal(gamma_t *g, bool enabled) {
+    if (g == NULL) {
+        return false;
+    }
+
+    if (!enabled) {
+        delete_journal(g->board->journal);
+        g->board->journal = NULL;
+    } else if (g->board->journal == NULL) {
+        g->board->journal = alloc_journal();
+    }
+
+    return !enabled || g->board->journal != NULL;
+}
+
+/**@brief Moves through journal of the game.
+ * Undoes or redoes, depending on @p undo, a move in game pointed by @p g.
+ * Index of articulation points is dropped, it is built again when needed.
+ * @param[in,out] g       – pointer to the current game,
+ * @param[in] undo        – whether the move is undone or redone.
+ * @return Value @p true if a move was undone or redone, @p false otherwise.
+ */
+static bool travel(gamma_t *g, bool undo) {
+    bool moved;
+
+    if (g == NULL || g->board->journal == NULL) {
+        return false;
+    }
+
+    if (undo) {
+        moved = undo_step(g->board->journal, restore_game, g);
+    } else {
+        moved = redo_step(g->board->journal, restore_game, g);
+    }
+
+    if (moved) {
+        g->version++;
+        g->status_version++;
+
+        delete_cut_points(g->cut_points);
+        g->cut_points = NULL;
+    }
+
+    return moved;
+}
+
+bool gamma_undo(gamma_t *g) {
+    return travel(g, true);
+}
+
+bool gamma_redo(gamma_t *g) {
+    return travel(g, false);
+}
+
+uint64_t gamma_busy_fields(gamma_t *g, uint32_t player_id) {
+    if (!preconditions(g, player_id)) {
+        return 0;
+    }
+
+    player_t *cur_player = g->players[player_id];
+
+    return cur_player->busy_fields;
+}
+
+uint64_t gamma_free_fields(gamma_t *g, uint32_t player_id) {
+    if (!preconditions(g, player_id)) {
+        return 0;
+    }
+
+    player_t *cur_player = g->players[player_id];
+
+    update_player_state(g, player_id);
+
+    return cur_player->free_fields;
+}
+
+/**@brief Checks whether player can make a move.
+ * Checks whether live player @p player_id can make a standard or golden
+ * move in game pointed by @p g.
+ * @param[in,out] g       – pointer to the current game,
+ * @param[in] player_id   – player identifier.
+ * @return Value @p true if player can make a move, @p false otherwise.
+ */
+static bool can_move(gamma_t *g, uint32_t player_id) {
+    if (g->globally_free_fields > 0 && open_player(g->board->live, player_id)) {
+        return true;
+    }
+
+    return gamma_golden_possible(g, player_id);
+}
+
+uint32_t gamma_next_active_player(gamma_t *g, uint32_t after) {
+    uint32_t i, player_id = after;
+
+    if (g == NULL || after > g->players_num) {
+        return 0;
+    }
+
+    live_set_t *live = g->board->live;
+
+    // Players who are not live will never move again.
+    for (i = 0; i < live->live_num; ++i) {
+        player_id = next_live_player(live, player_id);
+        if (can_move(g, player_id)) {
+            return player_id;
+        }
+    }
+
+    return 0;
+}
+
+bool gamma_is_over(gamma_t *g) {
+    if (g == NULL) {
+        return true;
+    }
+
+    if (g->globally_free_fields > 0 && g->board->live->open_num > 0) {
+        return false;
+    }
+
+    // Otherwise live players are checked for golden moves, so the answer
+    // is kept until the state of game or a status in game changes.
+    if (g->over_version != g->version ||
+        g->over_status_version != g->status_version) {
+        g->over = gamma_next_active_player(g, 0) == 0;
+        g->over_version = g->version;
+        g->over_status_version = g->status_version;
+    }
+
+    return g->over;
+}
+
+uint64_t gamma_hash(gamma_t *g) {
+    if (g == NULL) {
+        return 0;
+    }
+
+    return g->board->zobrist.hash;
+}
+
+uint64_t gamma_canonical_hash(gamma_t *g) {
+    if (g == NULL) {
+        return 0;
+    }
+
+    // Hash is kept until the state of game changes.
+    if (g->canonical_version != g->version) {
+        g->canonical_hash = canonical_hash(g->board);
+        g->canonical_version = g->version;
+    }
+
+    return g->canonical_hash;
+}
+
+bool gamma_params(gamma_t *g, uint32_t *width, uint32_t *height,
+                  uint32_t *players, uint32_t *areas) {
+    if (g == NULL) {
+        return false;
+    }
+
+    *width = g->width;
+    *height = g->height;
+    *players = g->players_num;
+    *areas = g->max_areas;
+
+    return true;
+}
+
+bool gamma_state(gamma_t *g, uint32_t *owners, bool *golden_used,
+                 bool *in_game) {
+    uint32_t x, y, player_id, f;
+
+    if (g == NULL || owners == NULL || golden_used == NULL || in_game == NULL) {
+        return false;
+    }
+
+    for (y = 0; y < g->height; ++y) {
+        f = field_index(g->board, 0, y);
+        for (x = 0; x < g->width; ++x, ++f) {
+            *owners++ = field_owner(g->board, f);
+        }
+    }
+
+    for (player_id = 1; player_id <= g->players_num; ++player_id) {
+        golden_used[player_id - 1] = g->players[player_id]->golden_used;
+        in_game[player_id - 1] = g->players[player_id]->in_game;
+    }
+
+    return true;
+}
+
+uint64_t gamma_status_version(gamma_t *g) {
+    return g == NULL ? 0 : g->status_version;
+}
+
+bool gamma_statuses(gamma_t *g, bool *in_game) {
+    uint32_t player_id;
+
+    if (g == NULL || in_game == NULL) {
+        return false;
+    }
+
+    for (player_id = 1; player_id <= g->players_num; ++player_id) {
+        in_game[player_id - 1] = g->players[player_id]->in_game;
+    }
+
+    return true;
+}
+
+bool gamma_set_statuses(gamma_t *g, const bool *in_game) {
+    uint32_t player_id;
+
+    if (g == NULL || in_game == NULL) {
+        return false;
+    }
+
+    for (player_id = 1; player_id <= g->players_num; ++player_id) {
+        set_player(g, player_id, CHANGE_IN_GAME, in_game[player_id - 1]);
+    }
+
+    return true;
+}
+
+/**
+ * Gives gamma game board cell width
+ * @param players_num   - number of players.
+ * @return Value @p counter - board cell width.
+ */
+uint32_t get_cell_width(uint32_t players_num) {
+    int counter = 0;
+
+    while (players_num > 0) {
+        counter++;
+        players_num /= 10;
+    }
+
+    if (counter > 1) {
+        counter++;
+    }
+
+    return counter;
+}
+
+/**
+ * Number of characters gathered before the board is passed on.
+ */
+#define CHUNK_SIZE (1u << 16)
+
+/**@brief Writes content of board cell.
+ * Writes content of cell of width @p cell_width of field owned by player
+ * @p owner_id to @p cell, without terminating null character.
+ * Identifiers of players have at most ten digits, written in pairs,
+ * so rendering costs copying of cells into the chunk rather than
+ * conversion of numbers.
+ * @param[out] cell       – written cell,
+ * @param[in] owner_id    – owner of the field,
+ * @param[in] cell_width  – width of the cell.
+ */
+static void format_cell(char *cell, uint32_t owner_id, uint32_t cell_width) {
+    char *pos = cell + cell_width;
+
+    if (cell_width == 1) {
+        *cell = owner_id == 0 ? '.' : (char) ('0' + owner_id);
+        return;
+    }
+
+    *--pos = ' ';
+
+    if (owner_id == 0) {
+        *--pos = '.';
+    } else {
+        pos = format_number(pos, owner_id);
+    }
+
+    while (pos > cell) {
+        *--pos = ' ';
+    }
+}
+
+char *get_cell_content(gamma_t *g, uint32_t x, uint32_t y) {
+    uint32_t cell_width = get_cell_width(g->players_num);
+
+    char *cell_content = malloc(sizeof(char) * (cell_width + 1));
+    if (cell_content == NULL) {
+        exit(1);
+    }
+
+    format_cell(cell_content,
+                field_owner(g->board, field_index(g->board, x, y)),
+                cell_width);
+    cell_content[cell_width] = '\0';
+
+    return cell_content;
+}
+
+uint64_t gamma_board_size(gamma_t *g) {
+    if (g == NULL) {
+        return 0;
+    }
+
+    return ((uint64_t) g->width * get_cell_width(g->players_num) + 1) *
+           g->height;
+}
+
+/**
+ * Function receiving consecutive chunks of depicted board, given data
+ * passed to @ref render_board, the chunk and its length.
+ * Gives @p false if the chunk could not be received.
+ */
+typedef bool (*board_sink_t)(void *data, const char *chunk, size_t len);
+
+/**@brief Depicts the rectangle of the board chunk by chunk.
+ * Passes string depicting rectangle of board of game pointed by @p g,
+ * of width @p w and height @p h, whose lower left field has coordinates
+ * @p x0, @p y0, without terminating null character, to function @p sink
+ * with data @p data, in chunks of at most @ref CHUNK_SIZE characters.
+ * The rectangle has to lie on the board. No memory is allocated.
+ * @param[in] g           – pointer to the current game,
+ * @param[in] x0          – x-coordinate of lower left field,
+ * @param[in] y0          – y-coordinate of lower left field,
+ * @param[in] w           – width of the rectangle,
+ * @param[in] h           – height of the rectangle,
+ * @param[in] sink        – function receiving chunks,
+ * @param[in] data        – data passed to the function.
+ * @return Value @p true if all chunks were received, @p false otherwise.
+ */
+static bool render_region(gamma_t *g, uint32_t x0, uint32_t y0, uint32_t w,
+                          uint32_t h, board_sink_t sink, void *data) {
+    char chunk[CHUNK_SIZE];
+    uint32_t cell_width = get_cell_width(g->players_num);
+    uint32_t x, y, f;
+    size_t len = 0;
+
+    for (y = y0 + h; y > y0; --y) {
+        f = field_index(g->board, x0, y - 1);
+
+        for (x = 0; x < w; ++x, ++f) {
+            if (len + cell_width > CHUNK_SIZE) {
+                if (!sink(data, chunk, len)) {
+                    return false;
+                }
+                len = 0;
+            }
+
+            format_cell(&chunk[len], field_owner(g->board, f), cell_width);
+            len += cell_width;
+        }
+
+        if (len == CHUNK_SIZE) {
+            if (!sink(data, chunk, len)) {
+                return false;
+            }
+            len = 0;
+        }
+        chunk[len++] = '\n';
+    }
+
+    return len == 0 || sink(data, chunk, len);
+}
+
+/**@brief Depicts the board chunk by chunk.
+ * Passes string depicting board of game pointed by @p g, like
+ * @ref render_region does for the whole board.
+ * @param[in] g           – pointer to the current game,
+ * @param[in] sink        – function receiving chunks,
+ * @param[in] data        – data passed to the function.
+ * @return Value @p true if all chunks were received, @p false otherwise.
+ */
+static bool render_board(gamma_t *g, board_sink_t sink, void *data) {
+    return render_region(g, 0, 0, g->width, g->height, sink, data);
+}
+
+/**
+ * Structure describing buffer receiving depicted board.
+ */
+typedef struct board_buffer {
+    char *buf;          ///< the buffer
+    uint64_t size;      ///< size of the buffer
+    uint64_t len;       ///< number of already written characters
+} board_buffer_t;
+
+/**@brief Copies chunk of the board to the buffer.
+ * Copies chunk @p chunk of length @p len to buffer described by @p data.
+ * @param[in,out] data    – pointer to description of the buffer,
+ * @param[in] chunk       – copied chunk,
+ * @param[in] len         – length of the chunk.
+ * @return Value @p true if the chunk fits in the buffer, @p false otherwise.
+ */
+static bool buffer_sink(void *data, const char *chunk, size_t len) {
+    board_buffer_t *out = data;
+
+    if (out->size - out->len < len) {
+        return false;
+    }
+
+    memcpy(&out->buf[out->len], chunk, len);
+    out->len += len;
+
+    return true;
+}
+
+/**@brief Writes chunk of the board to the stream.
+ * Writes chunk @p chunk of length @p len to stream pointed by @p data.
+ * @param[in,out] data    – pointer to the stream,
+ * @param[in] chunk       – written chunk,
+ * @param[in] len         – length of the chunk.
+ * @return Value @p true if the chunk was written, @p false otherwise.
+ */
+static bool stream_sink(void *data, const char *chunk, size_t len) {
+    return fwrite(chunk, sizeof(char), len, data) == len;
+}
+
+/**@brief Writes chunk of the board to the file descriptor.
+ * Writes chunk @p chunk of length @p len to file descriptor pointed
+ * by @p data, repeating interrupted and partial writes.
+ * @param[in] data        – pointer to the file descriptor,
+ * @param[in] chunk       – written chunk,
+ * @param[in] len         – length of the chunk.
+ * @return Value @p true if the chunk was written, @p false otherwise.
+ */
+static bool fd_sink(void *data, const char *chunk, size_t len) {
+    int fd = *(int *) data;
+    ssize_t written;
+
+    while (len > 0) {
+        written = write(fd, chunk, len);
+
+        if (written < 0 && errno == EINTR) {
+            continue;
+        } else if (written <= 0) {
+            return false;
+        }
+
+        chunk += written;
+        len -= written;
+    }
+
+    return true;
+}
+
+bool gamma_board_render(gamma_t *g, char *buf, uint64_t size) {
+    board_buffer_t out = {buf, size, 0};
+
+    if (g == NULL || buf == NULL || size <= gamma_board_size(g)) {
+        return false;
+    }
+
+    render_board(g, buffer_sink, &out);
+    buf[out.len] = '\0';
+
+    return true;
+}
+
+bool gamma_board_fwrite(gamma_t *g, FILE *stream) {
+    if (g == NULL || stream == NULL) {
+        return false;
+    }
+
+    return render_board(g, stream_sink, stream);
+}
+
+bool gamma_board_write(gamma_t *g, int fd) {
+    if (g == NULL || fd < 0) {
+        return false;
+    }
+
+    return render_board(g, fd_sink, &fd);
+}
+
+bool gamma_board_region(gamma_t *g, uint32_t x0, uint32_t y0, uint32_t w,
+                        uint32_t h, char *buf, uint64_t size) {
+    board_buffer_t out = {buf, size, 0};
+
+    if (g == NULL || buf == NULL || w == 0 || h == 0) {
+        return false;
+    } else if (x0 >= g->width || w > g->width - x0) {
+        return false;
+    } else if (y0 >= g->height || h > g->height - y0) {
+        return false;
+    } else if (size <= ((uint64_t) w * get_cell_width(g->players_num) + 1) *
+                       h) {
+        return false;
+    }
+
+    render_region(g, x0, y0, w, h, buffer_sink, &out);
+    buf[out.len] = '\0';
+
+    return true;
+}
+
+char *gamma_board(gamma_t *g) {
+    if (g == NULL) {
+        return NULL;
+    }
+
+    uint64_t size = gamma_board_size(g) + 1;
+
+    char *b = malloc(sizeof(char) * size);
+    if (b == NULL) {
+        exit(1);
+    }
+
+    gamma_board_render(g, b, size);
+
+    return b;
+}
+
+/**
+ * Signs starting snapshot of game.
+ */
+#define SNAPSHOT_MAGIC "GMSV"
+
+/**
+ * Version of format of snapshot.
+ */
+#define SNAPSHOT_VERSION 1
+
+/**
+ * Number of bytes of header of snapshot: magic signs, version, width,
+ * height, number of players, maximal number of areas and number of free
+ * fields.
+ */
+#define SNAPSHOT_HEADER 32
+
+/**
+ * Number of bytes of state of a player in snapshot: flags of status in game
+ * and golden move used, number of areas and number of fields.
+ */
+#define SNAPSHOT_PLAYER 13
+
+/**
+ * Flag of status in game in snapshot of a player.
+ */
+#define FLAG_IN_GAME 1
+
+/**
+ * Flag of golden move used in snapshot of a player.
+ */
+#define FLAG_GOLDEN_USED 2
+
+/**@brief Stores a number.
+ * Stores @p size lowest bytes of number @p value at @p pos,
+ * starting from the lowest one.
+ * @param[out] pos        – pointer to the stored bytes,
+ * @param[in] value       – the number,
+ * @param[in] size        – number of bytes.
+ */
+static void put_bytes(unsigned char *pos, uint64_t value, uint32_t size) {
+    uint32_t i;
+
+    for (i = 0; i < size; ++i) {
+        pos[i] = (unsigned char) (value >> (8 * i));
+    }
+}
+
+/**@brief Gives a stored number.
+ * Gives number stored by @ref put_bytes in @p size bytes at @p pos.
+ * @param[in] pos         – pointer to the stored bytes,
+ * @param[in] size        – number of bytes.
+ * @return The number.
+ */
+static uint64_t get_bytes(const unsigned char *pos, uint32_t size) {
+    uint64_t value = 0;
+    uint32_t i;
+
+    for (i = 0; i < size; ++i) {
+        value |= (uint64_t) pos[i] << (8 * i);
+    }
+
+    return value;
+}
+
+/**@brief Gives size of owner in snapshot.
+ * Gives number of bytes of owner of a field in snapshot of game
+ * with @p players_num players.
+ * @param[in] players_num – number of players.
+ * @return Number of bytes of owner.
+ */
+static uint32_t snapshot_owner_size(uint32_t players_num) {
+    if (players_num <= UINT8_MAX) {
+        return sizeof(uint8_t);
+    } else if (players_num <= UINT16_MAX) {
+        return sizeof(uint16_t);
+    }
+
+    return sizeof(uint32_t);
+}
+
+/**@brief Reads bytes from the file descriptor.
+ * Reads @p len bytes from file descriptor @p fd into @p buf,
+ * repeating interrupted and partial reads.
+ * @param[in] fd          – the file descriptor,
+ * @param[out] buf        – buffer for the bytes,
+ * @param[in] len         – number of bytes.
+ * @return Value @p true if all bytes were read, @p false otherwise.
+ */
+static bool fd_source(int fd, unsigned char *buf, size_t len) {
+    ssize_t was_read;
+
+    while (len > 0) {
+        was_read = read(fd, buf, len);
+
+        if (was_read < 0 && errno == EINTR) {
+            continue;
+        } else if (was_read <= 0) {
+            return false;
+        }
+
+        buf += was_read;
+        len -= was_read;
+    }
+
+    return true;
+}
+
+/**@brief Checks whether the snapshot fits in the file.
+ * Checks whether at least @p len bytes are left to be read from file
+ * descriptor @p fd, if it refers to a regular file, so that memory is not
+ * allocated for a game bigger than the snapshot. Other files are not checked.
+ * @param[in] fd          – the file descriptor,
+ * @param[in] len         – number of bytes.
+ * @return Value @p false if fewer bytes are left in the file,
+ * @p true otherwise.
+ */
+static bool snapshot_fits(int fd, uint64_t len) {
+    struct stat st;
+    off_t pos;
+
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        return true;
+    }
+
+    pos = lseek(fd, 0, SEEK_CUR);
+
+    return pos >= 0 && pos <= st.st_size &&
+           (uint64_t) (st.st_size - pos) >= len;
+}
+
+bool gamma_save(gamma_t *g, int fd) {
+    unsigned char chunk[CHUNK_SIZE], *pos = chunk;
+    uint32_t x, y, f, player_id, size;
+    player_t *p;
+
+    if (g == NULL || fd < 0) {
+        return false;
+    }
+
+    memcpy(pos, SNAPSHOT_MAGIC, 4);
+    put_bytes(pos + 4, SNAPSHOT_VERSION, 4);
+    put_bytes(pos + 8, g->width, 4);
+    put_bytes(pos + 12, g->height, 4);
+    put_bytes(pos + 16, g->players_num, 4);
+    put_bytes(pos + 20, g->max_areas, 4);
+    put_bytes(pos + 24, g->globally_free_fields, 8);
+    pos += SNAPSHOT_HEADER;
+
+    for (player_id = 1; player_id <= g->players_num; ++player_id) {
+        if (pos - chunk > CHUNK_SIZE - SNAPSHOT_PLAYER) {
+            if (!fd_sink(&fd, (char *) chunk, pos - chunk)) {
+                return false;
+            }
+
+            pos = chunk;
+        }
+
+        p = g->players[player_id];
+        put_bytes(pos, (p->in_game ? FLAG_IN_GAME : 0) |
+                       (p->golden_used ? FLAG_GOLDEN_USED : 0), 1);
+        put_bytes(pos + 1, p->busy_areas, 4);
+        put_bytes(pos + 5, p->busy_fields, 8);
+        pos += SNAPSHOT_PLAYER;
+    }
+
+    size = snapshot_owner_size(g->players_num);
+    for (y = 0; y < g->height; ++y) {
+        f = field_index(g->board, 0, y);
+
+        for (x = 0; x < g->width; ++x, ++f) {
+            if (pos - chunk > CHUNK_SIZE - size) {
+                if (!fd_sink(&fd, (char *) chunk, pos - chunk)) {
+                    return false;
+                }
+
+                pos = chunk;
+            }
+
+            put_bytes(pos, field_owner(g->board, f), size);
+            pos += size;
+        }
+    }
+
+    return fd_sink(&fd, (char *) chunk, pos - chunk);
+}
+
+/**@brief Reads owners of fields of snapshot.
+ * Reads owners of fields of snapshot from file descriptor @p fd
+ * and restores them, row by row, on board of game pointed by @p g.
+ * @param[in,out] g       – pointer to the loaded game,
+ * @param[in] fd          – the file descriptor.
+ * @return Value @p true if correct owners of all fields were read,
+ * @p false otherwise.
+ */
+static bool load_owners(gamma_t *g, int fd) {
+    uint32_t x, y, largest, size = snapshot_owner_size(g->players_num);
+    uint32_t *owners = malloc(sizeof(uint32_t) * g->width);
+    unsigned char *row = malloc((size_t) size * g->width);
+    bool loaded = owners != NULL && row != NULL;
+
+    for (y = 0; loaded && y < g->height; ++y) {
+        loaded = fd_source(fd, row, (size_t) size * g->width);
+        largest = 0;
+
+        // Owners of whole row are validated at once, by the largest one.
+        if (size == 1) {
+            for (x = 0; x < g->width; ++x) {
+                owners[x] = row[x];
+                largest = owners[x] > largest ? owners[x] : largest;
+            }
+        } else {
+            for (x = 0; x < g->width; ++x) {
+                owners[x] = (uint32_t) get_bytes(&row[(size_t) size * x],
+                                                 size);
+                largest = owners[x] > largest ? owners[x] : largest;
+            }
+        }
+        loaded = loaded && largest <= g->players_num;
+
+        if (loaded) {
+            restore_row(g->board, y, owners);
+        }
+    }
+
+    free(owners);
+    free(row);
+
+    return loaded;
+}
+
+gamma_t *gamma_load(int fd) {
+    unsigned char header[SNAPSHOT_HEADER], *players;
+    uint32_t width, height, players_num, player_id;
+    unsigned char *stored;
+    uint64_t free_fields;
+    bool *golden_used, loaded;
+    player_t *p;
+    gamma_t *g;
+
+    if (fd < 0 || !fd_source(fd, header, SNAPSHOT_HEADER) ||
+        memcmp(header, SNAPSHOT_MAGIC, 4) != 0 ||
+        get_bytes(header + 4, 4) != SNAPSHOT_VERSION) {
+        return NULL;
+    }
+
+    width = (uint32_t) get_bytes(header + 8, 4);
+    height = (uint32_t) get_bytes(header + 12, 4);
+    players_num = (uint32_t) get_bytes(header + 16, 4);
+    free_fields = get_bytes(header + 24, 8);
+
+    // Identifiers of fields have to fit in 32 bits anyway.
+    if ((uint64_t) width * height > UINT32_MAX ||
+        !snapshot_fits(fd, (uint64_t) SNAPSHOT_PLAYER * players_num +
+                           (uint64_t) snapshot_owner_size(players_num) *
+                           width * height)) {
+        return NULL;
+    }
+
+    g = gamma_new(width, height, players_num,
+                  (uint32_t) get_bytes(header + 20, 4));
+    if (g == NULL) {
+        return NULL;
+    }
+
+    players = malloc((size_t) SNAPSHOT_PLAYER * players_num);
+    golden_used = malloc(sizeof(bool) * players_num);
+    loaded = players != NULL && golden_used != NULL &&
+             fd_source(fd, players, (size_t) SNAPSHOT_PLAYER * players_num);
+
+    for (player_id = 1; loaded && player_id <= players_num; ++player_id) {
+        golden_used[player_id - 1] =
+                players[SNAPSHOT_PLAYER * (player_id - 1)] & FLAG_GOLDEN_USED;
+    }
+
+    // Counters are rebuilt from owners of fields, and have to agree
+    // with stored ones.
+    loaded = loaded && load_owners(g, fd) && restore_players(g, golden_used) &&
+             g->globally_free_fields == free_fields;
+
+    for (player_id = 1; loaded && player_id <= players_num; ++player_id) {
+        stored = &players[SNAPSHOT_PLAYER * (player_id - 1)];
+        p = g->players[player_id];
+
+        loaded = stored[0] <= (FLAG_IN_GAME | FLAG_GOLDEN_USED) &&
+                 p->busy_areas == get_bytes(stored + 1, 4) &&
+                 p->busy_fields == get_bytes(stored + 5, 8);
+        set_player(g, player_id, CHANGE_IN_GAME, stored[0] & FLAG_IN_GAME);
+    }
+
+    free(players);
+    free(golden_used);
+
+    if (!loaded) {
+        gamma_delete(g);
+
+        return NULL;
+    }
+
+    return g;
 }
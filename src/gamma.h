@@ -11,12 +11,31 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
 
 /**
  * Structure storing state of the gamma game.
  */
 typedef struct gamma gamma_t;
 
+/**
+ * Kinds of moves that can be executed in a sequence.
+ */
+typedef enum gamma_move_kind {
+    GAMMA_MOVE,           ///< move executed by @ref gamma_move
+    GAMMA_GOLDEN_MOVE     ///< move executed by @ref gamma_golden_move
+} gamma_move_kind_t;
+
+/**
+ * Structure describing a single move executed in a sequence.
+ */
+typedef struct gamma_move_record {
+    uint32_t player_id;       ///< number of player executing the move
+    uint32_t x;               ///< number of column of the field
+    uint32_t y;               ///< number of row of the field
+    gamma_move_kind_t kind;   ///< kind of the move
+} gamma_move_record_t;
+
 /** @brief Creates a structure storing the state of game.
  * Allocates memory for a new structure storing the state of game.
  * Initializes the structure so that it represents the initial state of game.
@@ -31,6 +50,66 @@ typedef struct gamma gamma_t;
 gamma_t *gamma_new(uint32_t width, uint32_t height,
                    uint32_t players_num, uint32_t max_areas);
 
+/** @brief Copies a structure storing the state of game.
+ * Allocates memory for a new structure storing the same state of game
+ * as structure pointed by @p g. Both games share the board, which is split
+ * into tiles, until one of them changes a tile, so that copying takes time
+ * proportional to number of tiles and players. Copies can be used
+ * by different threads. Journal of moves is not copied.
+ * @param[in] g          – pointer to the copied structure.
+ * @return Pointer to the newly created structure or NULL in case of memory
+ * was not allocated or the pointer is NULL.
+ */
+gamma_t *gamma_clone(const gamma_t *g);
+
+/** @brief Creates a structure storing given state of game.
+ * Allocates memory for a new game with parameters like in @ref gamma_new,
+ * in which field (@p x, @p y) is owned by player @p owners[@p y * @p width
+ * + @p x], or is free if it is zero, and player @p player_id has used
+ * golden move if @p golden_used[@p player_id - 1] is set and is in game
+ * if @p in_game[@p player_id - 1] is set. Areas are rebuilt in a single
+ * pass over the board. Journal is not kept.
+ * @param[in] width       – width of the board,
+ * @param[in] height      – height of the board,
+ * @param[in] players     – number of players,
+ * @param[in] areas       – maximal number of areas of a player,
+ * @param[in] owners      – array of @p width * @p height owners of fields,
+ * @param[in] golden_used – array of @p players golden moves used,
+ * @param[in] in_game     – array of @p players statuses in game.
+ * @return Pointer to the created structure or NULL if memory was not
+ * allocated, one of the parameters is incorrect or some player would have
+ * more than @p areas areas.
+ */
+gamma_t *gamma_restore(uint32_t width, uint32_t height, uint32_t players,
+                       uint32_t areas, const uint32_t *owners,
+                       const bool *golden_used, const bool *in_game);
+
+/** @brief Writes snapshot of game to a file descriptor.
+ * Writes state of game pointed by @p g to file descriptor @p fd,
+ * in versioned binary format: header with parameters of game and number
+ * of free fields, status in game, golden move used and numbers of areas
+ * and fields of each player, followed by owners of fields row by row,
+ * each of the smallest number of bytes fitting identifiers of players.
+ * Journal of the game is not written.
+ * @param[in] g          – pointer to structure storing the state of game,
+ * @param[in] fd         – the file descriptor.
+ * @return Value @p true if the snapshot was written, @p false if one
+ * of the parameters is incorrect or writing failed.
+ */
+bool gamma_save(gamma_t *g, int fd);
+
+/** @brief Reads snapshot of game from a file descriptor.
+ * Creates game in state written by @ref gamma_save, read from file
+ * descriptor @p fd. Owners are copied into the board a row at a time,
+ * then areas, hashes and counters of players are rebuilt in a single pass
+ * over the board, and the counters have to agree with the stored ones.
+ * Journal of the created game is not kept.
+ * @param[in] fd         – the file descriptor.
+ * @return Pointer to the created structure or NULL if memory was not
+ * allocated, reading failed or the snapshot is not correct.
+ */
+gamma_t *gamma_load(int fd);
+
 /** @brief Deletes a structure storing the state of game.
  * Deletes from memory the structure pointed by @p g.
  * Nothing happens if the pointer's value is NULL.
@@ -56,13 +135,16 @@ bool gamma_move(gamma_t *g, uint32_t player_id, uint32_t x, uint32_t y);
 /**@brief Checks if golden move is possible on given field.
  * Checks whether player @p player_id can make a golden move
  * in game pointed by @p g, on field with coordinates @p x, @p y.
+ * Neither the board nor state of players is modified, so the check may
+ * be run by many threads at once.
  * @param g           - pointer to the gamma game stucture,
  * @param player_id   - player id,
  * @param x           - field x-coordinate,
  * @param y           - field y-coordinate.
  * @return  Value @p true if golden move is possible, @p false otherwise.
  */
-bool check_golden_move(gamma_t *g, uint32_t player_id, uint32_t x, uint32_t y);
+bool check_golden_move(const gamma_t *g, uint32_t player_id,
+                       uint32_t x, uint32_t y);
 
 /** @brief Executes golden move.
 * Places the piece of player @p player_id on field (@p x, @p y), occupied by
@@ -80,11 +162,62 @@ bool check_golden_move(gamma_t *g, uint32_t player_id, uint32_t x, uint32_t y);
 */
 bool gamma_golden_move(gamma_t *g, uint32_t player_id, uint32_t x, uint32_t y);
 
+/** @brief Executes a sequence of moves.
+ * Executes moves described by @p n records from array @p moves one after
+ * another, each of them as @ref gamma_move or @ref gamma_golden_move,
+ * depending on its kind, and stores their results in array @p results.
+ * The game is left in the same state as after executing them one by one,
+ * but the game is validated, and answers kept for queries are dropped, once
+ * for the whole sequence.
+ * @param[in,out] g      – pointer to structure storing the state of game,
+ * @param[in] moves      – array of @p n records describing moves,
+ * @param[in] n          – number of moves,
+ * @param[out] results   – array of @p n values, where value @p true is stored
+ *                         for moves that were executed, @p false otherwise.
+ * @return Value @p true if the moves were processed, @p false if some
+ * of the pointers is NULL.
+ */
+bool gamma_move_batch(gamma_t *g, const gamma_move_record_t *moves,
+                      uint64_t n, bool *results);
+
+/** @brief Starts or stops keeping journal of moves.
+ * Starts, if @p enabled is @p true, recording changes made by moves
+ * in game pointed by @p g, so that they can be undone, or stops it
+ * and forgets recorded moves otherwise.
+ * @param[in,out] g      – pointer to structure storing the state of game,
+ * @param[in] enabled    – whether journal is kept.
+ * @return Value @p true if journal is kept as requested, @p false if
+ * the pointer is NULL or memory was not allocated.
+ */
+bool gamma_journal(gamma_t *g, bool enabled);
+
+/** @brief Undoes the last move.
+ * Takes back the last executed move recorded in journal of game pointed
+ * by @p g, restoring the state of game right after the previous move.
+ * Takes time proportional to number of values changed since then.
+ * @param[in,out] g      – pointer to structure storing the state of game.
+ * @return Value @p true if a move was undone, @p false if journal is not kept
+ * or there is no move to be undone.
+ */
+bool gamma_undo(gamma_t *g);
+
+/** @brief Redoes the last undone move.
+ * Executes again the last move undone in game pointed by @p g, unless
+ * the state of game has changed since then.
+ * @param[in,out] g      – pointer to structure storing the state of game.
+ * @return Value @p true if a move was redone, @p false if journal is not kept
+ * or there is no move to be redone.
+ */
+bool gamma_redo(gamma_t *g);
+
 /** @brief Checks if exists a field on which player can execute a golden move.
  * Checks whether player @p player_id hasn't yet used a golden move
  * in this game and there is at least one field occupied by the another player
  * that can be changed via golden move.
- * @param[in] g          – pointer to structure storing the state of game,
+ * The answer is remembered until a move changes the state of game,
+ * so repeated queries take constant time. Like @ref gamma_free_fields,
+ * refreshes status in game of the player.
+ * @param[in,out] g      – pointer to structure storing the state of game,
  * @param[in] player_id  – number of player, that is positive not bigger than
  *                         value @p players_num from function @ref gamma_new.
  * @return Value @p true if player hasn't yet used golden move in this game
@@ -93,6 +226,50 @@ bool gamma_golden_move(gamma_t *g, uint32_t player_id, uint32_t x, uint32_t y);
  */
 bool gamma_golden_possible(gamma_t *g, uint32_t player_id);
 
+/** @brief Gives fields on which player can execute a move.
+ * Marks in bitmap @p bitmap_out fields on which player @p player_id could
+ * execute a move of kind @p kind in the current state of game, checking
+ * the whole board in one pass. Field (@p x, @p y) is represented by bit
+ * number @p y * @p width + @p x, counting from the least significant bit
+ * of the first word. The game is not modified.
+ * @param[in] g          – pointer to structure storing the state of game,
+ * @param[in] player_id  – number of player, that is positive not bigger than
+ *                         value @p players_num from function @ref gamma_new,
+ * @param[in] kind       – kind of the move,
+ * @param[out] bitmap_out – array of (@p width * @p height + 63) / 64 words,
+ *                         where the bitmap is stored.
+ * @return Value @p true if the bitmap was stored, @p false if one of the
+ * parameters is incorrect or memory was not allocated.
+ */
+bool gamma_legal_mask(gamma_t *g, uint32_t player_id, gamma_move_kind_t kind,
+                      uint64_t *bitmap_out);
+
+/** @brief Gives fields of a rectangle on which player can execute a move.
+ * Marks in bitmap @p bitmap_out fields of rectangle of board in game
+ * pointed by @p g, of width @p w and height @p h, whose lower left field
+ * has coordinates @p x0, @p y0, on which player @p player_id could execute
+ * a move of kind @p kind, like @ref gamma_legal_mask. Field (@p x, @p y)
+ * is represented by bit number (@p y - @p y0) * @p w + @p x - @p x0.
+ * Fields outside of the rectangle are not checked, so it takes time
+ * proportional to its area rather than to area of the board.
+ * @param[in] g          – pointer to structure storing the state of game,
+ * @param[in] player_id  – number of player, that is positive not bigger than
+ *                         value @p players_num from function @ref gamma_new,
+ * @param[in] kind       – kind of the move,
+ * @param[in] x0         – number of the first column of the rectangle,
+ * @param[in] y0         – number of the first row of the rectangle,
+ * @param[in] w          – positive width of the rectangle,
+ * @param[in] h          – positive height of the rectangle,
+ * @param[out] bitmap_out – array of (@p w * @p h + 63) / 64 words,
+ *                         where the bitmap is stored.
+ * @return Value @p true if the bitmap was stored, @p false if one of the
+ * parameters is incorrect, the rectangle does not lie on the board
+ * or memory was not allocated.
+ */
+bool gamma_legal_mask_region(gamma_t *g, uint32_t player_id,
+                             gamma_move_kind_t kind, uint32_t x0, uint32_t y0,
+                             uint32_t w, uint32_t h, uint64_t *bitmap_out);
+
 /** @brief Gives number of fields occupied by a player.
 * Gives number of fields occupied by the player @p player_id.
 * @param[in] g          – pointer to structure storing the state of game,
@@ -114,6 +291,117 @@ uint64_t gamma_busy_fields(gamma_t *g, uint32_t player_id);
 */
 uint64_t gamma_free_fields(gamma_t *g, uint32_t player_id);
 
+/** @brief Gives the next player who can make a move.
+ * Gives the first player following player @p after, in order of numbers
+ * of players and wrapping around after the last one, who can make
+ * a standard or golden move in the current state of game. Player @p after
+ * is checked last. Players who will never move again are skipped without
+ * being checked, since set of such players is updated by every move.
+ * @param[in] g          – pointer to structure storing the state of game,
+ * @param[in] after      – number of player, that is not bigger than
+ *                         value @p players_num from function @ref gamma_new,
+ *                         or zero to start from the first player.
+ * @return Number of the next player who can make a move or zero if there
+ * is no such player or one of the parameters is incorrect.
+ */
+uint32_t gamma_next_active_player(gamma_t *g, uint32_t after);
+
+/** @brief Checks whether the game is over.
+ * Checks whether no player can make a standard or golden move in game
+ * pointed by @p g. Takes constant time as long as some player can make
+ * a standard move. Otherwise live players are checked for golden moves,
+ * like in @ref gamma_next_active_player, once after every change of state
+ * of game or of statuses of players in game, and the answer is kept
+ * until the next change.
+ * @param[in] g          – pointer to structure storing the state of game.
+ * @return Value @p true if no player can make a move or the pointer is NULL,
+ * @p false otherwise.
+ */
+bool gamma_is_over(gamma_t *g);
+
+/** @brief Gives hash of the state of game.
+ * Gives 64-bit Zobrist hash of owners of fields and golden moves used
+ * by players in game pointed by @p g. Equal states have equal hashes,
+ * different states have different hashes with high probability.
+ * The hash is updated by every move, so it takes constant time.
+ * The game does not know whose turn it is, callers keeping track
+ * of it have to combine it with the hash on their own.
+ * @param[in] g          – pointer to structure storing the state of game.
+ * @return Hash of the state of game or zero if the pointer is NULL.
+ */
+uint64_t gamma_hash(gamma_t *g);
+
+/** @brief Gives hash of the state of game up to symmetries of the board.
+ * Gives hash of the state of game pointed by @p g, like @ref gamma_hash,
+ * which is equal for states transformed one into another by reflections,
+ * and rotations in case of square boards.
+ * Moves keep only the plain hash up to date, so the first call after
+ * a change of state takes time proportional to area of the board, further
+ * calls take constant time.
+ * @param[in] g          – pointer to structure storing the state of game.
+ * @return Canonical hash of the state of game or zero if the pointer is NULL.
+ */
+uint64_t gamma_canonical_hash(gamma_t *g);
+
+/** @brief Gives parameters of game.
+ * Stores parameters of game pointed by @p g, given to @ref gamma_new,
+ * in variables pointed by @p width, @p height, @p players and @p areas.
+ * @param[in] g          – pointer to structure storing the state of game,
+ * @param[out] width     – pointer to width of the board,
+ * @param[out] height    – pointer to height of the board,
+ * @param[out] players   – pointer to number of players,
+ * @param[out] areas     – pointer to maximal number of areas of a player.
+ * @return Value @p true if parameters were stored, @p false if the pointer
+ * to game is NULL.
+ */
+bool gamma_params(gamma_t *g, uint32_t *width, uint32_t *height,
+                  uint32_t *players, uint32_t *areas);
+
+/** @brief Gives state of game.
+ * Stores owners of fields, golden moves used and statuses in game of players
+ * in game pointed by @p g, in the same form as taken by @ref gamma_restore.
+ * Status in game is refreshed only when all areas of a player are taken,
+ * so it can not be derived from the other values.
+ * @param[in] g            – pointer to structure storing the state of game,
+ * @param[out] owners      – array of @p width * @p height owners of fields,
+ * @param[out] golden_used – array of @p players golden moves used,
+ * @param[out] in_game     – array of @p players statuses in game.
+ * @return Value @p true if state was stored, @p false if one
+ * of the pointers is NULL.
+ */
+bool gamma_state(gamma_t *g, uint32_t *owners, bool *golden_used,
+                 bool *in_game);
+
+/** @brief Gives version of statuses in game.
+ * Gives number which changes whenever status in game of some player in game
+ * pointed by @p g may have changed. Status is refreshed also by queries
+ * and moves which were not executed, so that a recording of moves can
+ * notice that it has to store statuses.
+ * @param[in] g            – pointer to structure storing the state of game.
+ * @return Version of statuses in game or zero if the pointer is NULL.
+ */
+uint64_t gamma_status_version(gamma_t *g);
+
+/** @brief Gives statuses in game.
+ * Stores statuses in game of players in game pointed by @p g, in the same
+ * form as @ref gamma_state, without refreshing them.
+ * @param[in] g            – pointer to structure storing the state of game,
+ * @param[out] in_game     – array of @p players statuses in game.
+ * @return Value @p true if statuses were stored, @p false if one
+ * of the pointers is NULL.
+ */
+bool gamma_statuses(gamma_t *g, bool *in_game);
+
+/** @brief Sets up statuses in game.
+ * Sets up statuses in game of players in game pointed by @p g to ones
+ * given in the same form as by @ref gamma_statuses.
+ * @param[in,out] g        – pointer to structure storing the state of game,
+ * @param[in] in_game      – array of @p players statuses in game.
+ * @return Value @p true if statuses were set up, @p false if one
+ * of the pointers is NULL.
+ */
+bool gamma_set_statuses(gamma_t *g, const bool *in_game);
+
 /**
  * Gives gamma game board cell width
  * @param players_num   - number of players.
@@ -131,6 +419,72 @@ uint32_t get_cell_width(uint32_t players_num);
  */
 char *get_cell_content(gamma_t *g, uint32_t x, uint32_t y);
 
+/** @brief Gives length of string depicting the state of board.
+ * Gives number of characters of string depicting the state of board
+ * in game pointed by @p g, as given by @ref gamma_board, not counting
+ * the terminating null character.
+ * @param[in] g          – pointer to structure storing the state of game.
+ * @return Length of the string or zero if the pointer is NULL.
+ */
+uint64_t gamma_board_size(gamma_t *g);
+
+/** @brief Writes string depicting the state of board to a buffer.
+ * Writes string depicting the state of board in game pointed by @p g,
+ * terminated by null character, to buffer @p buf of size @p size.
+ * No memory is allocated.
+ * @param[in] g          – pointer to structure storing the state of game,
+ * @param[out] buf       – buffer for the string,
+ * @param[in] size       – size of the buffer, bigger than value given
+ *                         by @ref gamma_board_size.
+ * @return Value @p true if the string was written, @p false if one of
+ * the parameters is incorrect or the buffer is too small.
+ */
+bool gamma_board_render(gamma_t *g, char *buf, uint64_t size);
+
+/** @brief Writes string depicting a rectangle of board to a buffer.
+ * Writes string depicting the state of rectangle of board in game pointed
+ * by @p g, of width @p w and height @p h, whose lower left field has
+ * coordinates @p x0, @p y0, in the same way as @ref gamma_board depicts
+ * the whole board, terminated by null character, to buffer @p buf of size
+ * @p size. Takes time proportional to area of the rectangle, no memory
+ * is allocated.
+ * @param[in] g          – pointer to structure storing the state of game,
+ * @param[in] x0         – number of the first column of the rectangle,
+ * @param[in] y0         – number of the first row of the rectangle,
+ * @param[in] w          – positive width of the rectangle,
+ * @param[in] h          – positive height of the rectangle,
+ * @param[out] buf       – buffer for the string,
+ * @param[in] size       – size of the buffer, bigger than
+ *                         @p h * (@p w * @ref get_cell_width + 1).
+ * @return Value @p true if the string was written, @p false if one of
+ * the parameters is incorrect, the rectangle does not lie on the board
+ * or the buffer is too small.
+ */
+bool gamma_board_region(gamma_t *g, uint32_t x0, uint32_t y0, uint32_t w,
+                        uint32_t h, char *buf, uint64_t size);
+
+/** @brief Writes string depicting the state of board to a stream.
+ * Writes string depicting the state of board in game pointed by @p g,
+ * without terminating null character, to stream @p stream, in chunks
+ * of fixed size, so that the whole string is never kept in memory.
+ * @param[in] g          – pointer to structure storing the state of game,
+ * @param[in,out] stream – the stream.
+ * @return Value @p true if the string was written, @p false if one of
+ * the pointers is NULL or writing failed.
+ */
+bool gamma_board_fwrite(gamma_t *g, FILE *stream);
+
+/** @brief Writes string depicting the state of board to a file descriptor.
+ * Writes string depicting the state of board in game pointed by @p g,
+ * without terminating null character, to file descriptor @p fd, in chunks
+ * of fixed size, so that the whole string is never kept in memory.
+ * @param[in] g          – pointer to structure storing the state of game,
+ * @param[in] fd         – the file descriptor.
+ * @return Value @p true if the string was written, @p false if one of
+ * the parameters is incorrect or writing failed.
+ */
+bool gamma_board_write(gamma_t *g, int fd);
+
 /** @brief Gives string depicting the state of board.
  * Allocates a buffer in memory that stores string containing text description
  * of the current state of board. Example can be found in file gamma_test.c.
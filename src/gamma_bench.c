@@ -0,0 +1,686 @@
+/**@file
+ * Implementation of gamma game engine benchmark.
+ *
+ * Every scenario sets up a game with a seeded generator of moves, and then
+ * times every call of its operation on its own, so that percentiles concern
+ * single operations and a slow one is not hidden in an average. Time of
+ * reading the clock, measured before the scenario, is subtracted from every
+ * time and reported with results. Scenarios are run in separate processes,
+ * so that peak
+ * resident memory and number of allocations concern a single scenario.
+ * Results are written as CSV or JSON, and two files of results can be
+ * compared to find regressions.
+ *
+ * @author Antoni Koszowski <a.koszowski@students.mimuw.edu.pl>
+ * @copyright
+ * @date 17.06.2020
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "gamma.h"
+
+/**
+ * Maximal length of name of a scenario.
+ */
+#define NAME_SIZE 64
+
+/**
+ * Maximal number of results in a compared file.
+ */
+#define MAX_RESULTS 64
+
+/**
+ * Number of readings of the clock measuring its cost.
+ */
+#define CLOCK_READINGS 1000
+
+/**
+ * Default regression threshold, in percents.
+ */
+#define DEFAULT_THRESHOLD 10.0
+
+/**
+ * Number of allocations made by the engine, counted if allocating functions
+ * are wrapped while linking.
+ */
+static atomic_uint_fast64_t allocations;
+
+#ifdef COUNT_ALLOCATIONS
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t num, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+/**@brief Allocates memory, counting the allocation.
+ * @param size - number of bytes.
+ * @return Pointer to the allocated memory or NULL.
+ */
+void *__wrap_malloc(size_t size) {
+    atomic_fetch_add_explicit(&allocations, 1, memory_order_relaxed);
+
+    return __real_malloc(size);
+}
+
+/**@brief Allocates zeroed memory, counting the allocation.
+ * @param num  - number of elements,
+ * @param size - size of an element.
+ * @return Pointer to the allocated memory or NULL.
+ */
+void *__wrap_calloc(size_t num, size_t size) {
+    atomic_fetch_add_explicit(&allocations, 1, memory_order_relaxed);
+
+    return __real_calloc(num, size);
+}
+
+/**@brief Reallocates memory, counting the allocation.
+ * @param ptr  - pointer to the reallocated memory,
+ * @param size - number of bytes.
+ * @return Pointer to the allocated memory or NULL.
+ */
+void *__wrap_realloc(void *ptr, size_t size) {
+    atomic_fetch_add_explicit(&allocations, 1, memory_order_relaxed);
+
+    return __real_realloc(ptr, size);
+}
+
+#endif /* COUNT_ALLOCATIONS */
+
+/**
+ * Structure storing state of generator of pseudorandom numbers.
+ */
+typedef struct rng {
+    uint64_t state;         ///< state of the generator
+} rng_t;
+
+/**
+ * Structure describing a scenario.
+ */
+typedef struct scenario scenario_t;
+
+/**
+ * Operation measured by scenario, given the game, the scenario
+ * and the generator.
+ */
+typedef void (*operation_t)(gamma_t *g, const scenario_t *sc, rng_t *rng);
+
+/**
+ * Structure describing a scenario.
+ */
+struct scenario {
+    const char *name;           ///< name of the scenario
+    uint32_t width;             ///< width of the board
+    uint32_t height;            ///< height of the board
+    uint32_t players;           ///< number of players
+    uint32_t areas;             ///< maximal number of areas of a player
+    uint64_t setup_moves;       ///< number of moves tried before measuring
+    bool journal;               ///< whether journal is kept while measuring
+    uint32_t samples;           ///< number of measured operations
+    operation_t operation;      ///< measured operation
+};
+
+/**
+ * Structure storing result of a scenario.
+ */
+typedef struct result {
+    char scenario[NAME_SIZE];   ///< name of the scenario
+    uint64_t seed;              ///< seed of the generator
+    uint64_t operations;        ///< number of measured operations
+    double p50;                 ///< median time of operation, in ns
+    double p90;                 ///< 90th percentile of time of operation
+    double p99;                 ///< 99th percentile of time of operation
+    double max;                 ///< maximal time of operation
+    double mean;                ///< mean time of operation
+    double clock;               ///< time of reading the clock, subtracted
+    uint64_t allocations;       ///< number of allocations while measuring
+    uint64_t peak_rss;          ///< peak resident memory, in kilobytes
+} result_t;
+
+/**@brief Gives next pseudorandom number.
+ * Gives next number of generator pointed by @p rng, which is SplitMix64.
+ * @param rng - pointer to the generator.
+ * @return Pseudorandom number.
+ */
+static uint64_t next_random(rng_t *rng) {
+    uint64_t v = (rng->state += UINT64_C(0x9e3779b97f4a7c15));
+
+    v = (v ^ (v >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+    v = (v ^ (v >> 27)) * UINT64_C(0x94d049bb133111eb);
+
+    return v ^ (v >> 31);
+}
+
+/**@brief Gives pseudorandom number from range.
+ * @param rng   - pointer to the generator,
+ * @param range - size of the range.
+ * @return Pseudorandom number from 0 to @p range - 1.
+ */
+static uint32_t random_below(rng_t *rng, uint32_t range) {
+    return (uint32_t) (((next_random(rng) >> 32) * range) >> 32);
+}
+
+/**@brief Tries a random move.
+ * Tries move of random player on random field of game pointed by @p g.
+ * @param g   - pointer to the game,
+ * @param sc  - pointer to the scenario,
+ * @param rng - pointer to the generator.
+ */
+static void random_move(gamma_t *g, const scenario_t *sc, rng_t *rng) {
+    gamma_move(g, 1 + random_below(rng, sc->players),
+               random_below(rng, sc->width), random_below(rng, sc->height));
+}
+
+/**@brief Tries a random golden move.
+ * Checks whether random player can make golden move in game pointed
+ * by @p g and tries it on random field, taking it back if it was made,
+ * so that the player can try again.
+ * @param g   - pointer to the game,
+ * @param sc  - pointer to the scenario,
+ * @param rng - pointer to the generator.
+ */
+static void random_golden_move(gamma_t *g, const scenario_t *sc, rng_t *rng) {
+    uint32_t player = 1 + random_below(rng, sc->players);
+
+    if (gamma_golden_possible(g, player) &&
+        gamma_golden_move(g, player, random_below(rng, sc->width),
+                          random_below(rng, sc->height))) {
+        gamma_undo(g);
+    }
+}
+
+/**@brief Renders the board.
+ * Gives string depicting board of game pointed by @p g and frees it.
+ * @param g   - pointer to the game,
+ * @param sc  - pointer to the scenario,
+ * @param rng - pointer to the generator.
+ */
+static void render(gamma_t *g, const scenario_t *sc, rng_t *rng) {
+    (void) sc;
+    (void) rng;
+
+    free(gamma_board(g));
+}
+
+/**
+ * Scenarios of the benchmark.
+ */
+static const scenario_t scenarios[] = {
+    {"random_fill", 1000, 1000, 8, 1000000, 0, false, 640000, random_move},
+    {"late_game", 500, 500, 4, 5, 1000000, false, 640000, random_move},
+    {"golden_heavy", 100, 100, 10, 10, 100000, true, 20000,
+     random_golden_move},
+    {"huge_sparse", 5000, 5000, 4, 100, 0, false, 80000, random_move},
+    {"many_players", 1000, 1000, 65536, 4, 100000, false, 640000,
+     random_move},
+    {"board_render", 200, 200, 120, 1000, 200000, false, 200, render},
+};
+
+/**
+ * Number of scenarios of the benchmark.
+ */
+#define SCENARIOS_NUM (sizeof(scenarios) / sizeof(scenarios[0]))
+
+/**@brief Gives current time.
+ * @return Time of monotonic clock, in nanoseconds.
+ */
+static uint64_t now(void) {
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+
+    return (uint64_t) t.tv_sec * 1000000000 + (uint64_t) t.tv_nsec;
+}
+
+/**@brief Measures time of reading the clock.
+ * Gives the shortest time between two consecutive readings of the clock,
+ * out of @ref CLOCK_READINGS of them.
+ * @return Time of reading the clock, in nanoseconds.
+ */
+static uint64_t clock_cost(void) {
+    uint64_t i, start, elapsed, shortest = UINT64_MAX;
+
+    for (i = 0; i < CLOCK_READINGS; ++i) {
+        start = now();
+        elapsed = now() - start;
+
+        if (elapsed < shortest) {
+            shortest = elapsed;
+        }
+    }
+
+    return shortest;
+}
+
+/**@brief Compares times.
+ * @param a - pointer to the first time,
+ * @param b - pointer to the second time.
+ * @return Negative, zero or positive value as the first time is smaller,
+ * equal or greater than the second one.
+ */
+static int compare_times(const void *a, const void *b) {
+    double x = *(const double *) a, y = *(const double *) b;
+
+    return (x > y) - (x < y);
+}
+
+/**@brief Gives percentile of sorted times.
+ * @param times - sorted array of times,
+ * @param n     - number of times,
+ * @param p     - percentile, from 0 to 100.
+ * @return The smallest time not smaller than @p p percent of times.
+ */
+static double percentile(const double *times, uint32_t n, double p) {
+    uint64_t rank = (uint64_t) (p * n / 100);
+
+    if (rank * 100 < p * n) {
+        rank++;
+    }
+
+    return times[rank == 0 ? 0 : rank - 1];
+}
+
+/**@brief Runs a scenario.
+ * Sets up and measures scenario pointed by @p sc, with generator seeded
+ * by @p seed, storing result in structure pointed by @p r.
+ * @param sc    - pointer to the scenario,
+ * @param seed  - seed of the generator,
+ * @param quick - whether number of samples is reduced tenfold,
+ * @param r     - pointer to the result.
+ * @return Value @p true if the scenario was run, @p false if memory
+ * was not allocated.
+ */
+static bool run_scenario(const scenario_t *sc, uint64_t seed, bool quick,
+                         result_t *r) {
+    uint32_t i, samples = quick ? (sc->samples + 9) / 10 : sc->samples;
+    rng_t rng = {seed};
+    uint64_t k, start, elapsed, cost, first_allocation, total = 0;
+    double *times = malloc(sizeof(double) * samples);
+    struct rusage usage;
+    gamma_t *g;
+
+    g = gamma_new(sc->width, sc->height, sc->players, sc->areas);
+    if (g == NULL || times == NULL) {
+        gamma_delete(g);
+        free(times);
+
+        return false;
+    }
+
+    for (k = 0; k < sc->setup_moves; ++k) {
+        random_move(g, sc, &rng);
+    }
+
+    gamma_journal(g, sc->journal);
+    cost = clock_cost();
+
+    first_allocation = atomic_load(&allocations);
+    for (i = 0; i < samples; ++i) {
+        start = now();
+        sc->operation(g, sc, &rng);
+        elapsed = now() - start;
+
+        elapsed = elapsed > cost ? elapsed - cost : 0;
+        total += elapsed;
+        times[i] = (double) elapsed;
+    }
+    r->allocations = atomic_load(&allocations) - first_allocation;
+
+    qsort(times, samples, sizeof(double), compare_times);
+
+    snprintf(r->scenario, NAME_SIZE, "%s", sc->name);
+    r->seed = seed;
+    r->operations = samples;
+    r->p50 = percentile(times, samples, 50);
+    r->p90 = percentile(times, samples, 90);
+    r->p99 = percentile(times, samples, 99);
+    r->max = times[samples - 1];
+    r->mean = (double) total / r->operations;
+    r->clock = (double) cost;
+
+    getrusage(RUSAGE_SELF, &usage);
+    r->peak_rss = (uint64_t) usage.ru_maxrss;
+
+    gamma_delete(g);
+    free(times);
+
+    return true;
+}
+
+/**@brief Runs a scenario in a separate process.
+ * Runs scenario pointed by @p sc like @ref run_scenario in a child
+ * process, which passes the result through a pipe.
+ * @param sc    - pointer to the scenario,
+ * @param seed  - seed of the generator,
+ * @param quick - whether number of samples is reduced tenfold,
+ * @param r     - pointer to the result.
+ * @return Value @p true if the scenario was run, @p false otherwise.
+ */
+static bool run_child(const scenario_t *sc, uint64_t seed, bool quick,
+                      result_t *r) {
+    int fds[2], status;
+    ssize_t was_read;
+    pid_t pid;
+
+    if (pipe(fds) != 0) {
+        return false;
+    }
+
+    fflush(NULL);
+    pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+
+        return false;
+    } else if (pid == 0) {
+        close(fds[0]);
+        if (!run_scenario(sc, seed, quick, r) ||
+            write(fds[1], r, sizeof(result_t)) != sizeof(result_t)) {
+            _exit(1);
+        }
+
+        _exit(0);
+    }
+
+    close(fds[1]);
+    do {
+        was_read = read(fds[0], r, sizeof(result_t));
+    } while (was_read < 0);
+    close(fds[0]);
+
+    while (waitpid(pid, &status, 0) < 0) {
+    }
+
+    return was_read == sizeof(result_t) && WIFEXITED(status) &&
+           WEXITSTATUS(status) == 0;
+}
+
+/**@brief Writes a result.
+ * Writes result pointed by @p r to stream @p out, as a line of CSV
+ * or an element of JSON array.
+ * @param out   - the stream,
+ * @param r     - pointer to the result,
+ * @param json  - whether JSON is written,
+ * @param first - whether it is the first written result.
+ */
+static void write_result(FILE *out, const result_t *r, bool json, bool first) {
+    if (json) {
+        fprintf(out, "%s\n  {\"scenario\": \"%s\", \"seed\": %" PRIu64
+                     ", \"operations\": %" PRIu64 ", \"ns_p50\": %.1f"
+                     ", \"ns_p90\": %.1f, \"ns_p99\": %.1f, \"ns_max\": %.1f"
+                     ", \"ns_mean\": %.1f, \"ns_clock\": %.1f"
+                     ", \"allocations\": %" PRIu64
+                     ", \"peak_rss_kb\": %" PRIu64 "}",
+                first ? "[" : ",", r->scenario, r->seed, r->operations,
+                r->p50, r->p90, r->p99, r->max, r->mean, r->clock,
+                r->allocations, r->peak_rss);
+    } else {
+        if (first) {
+            fprintf(out, "scenario,seed,operations,ns_p50,ns_p90,ns_p99,"
+                         "ns_max,ns_mean,ns_clock,allocations,peak_rss_kb\n");
+        }
+
+        fprintf(out, "%s,%" PRIu64 ",%" PRIu64 ",%.1f,%.1f,%.1f,%.1f,%.1f,"
+                     "%.1f,%" PRIu64 ",%" PRIu64 "\n",
+                r->scenario, r->seed, r->operations, r->p50, r->p90, r->p99,
+                r->max, r->mean, r->clock, r->allocations, r->peak_rss);
+    }
+}
+
+/**@brief Runs the benchmark.
+ * Runs scenarios named @p only, or all of them if it is NULL, writing
+ * their results to stream @p out.
+ * @param out   - the stream,
+ * @param only  - name of the only run scenario or NULL,
+ * @param seed  - seed of the generator,
+ * @param quick - whether number of samples is reduced tenfold,
+ * @param json  - whether JSON is written instead of CSV.
+ * @return Value @p 0 if all scenarios were run, @p 1 otherwise.
+ */
+static int run_benchmark(FILE *out, const char *only, uint64_t seed,
+                         bool quick, bool json) {
+    uint32_t i, written = 0;
+    result_t r;
+    int code = 0;
+
+    for (i = 0; i < SCENARIOS_NUM; ++i) {
+        if (only != NULL && strcmp(only, scenarios[i].name) != 0) {
+            continue;
+        }
+
+        // Every scenario gets its own sequence of moves.
+        if (!run_child(&scenarios[i], seed + i, quick, &r)) {
+            fprintf(stderr, "scenario %s failed\n", scenarios[i].name);
+            code = 1;
+            continue;
+        }
+
+        write_result(out, &r, json, written == 0);
+        written++;
+    }
+
+    if (json) {
+        fprintf(out, written == 0 ? "[]\n" : "\n]\n");
+    }
+
+    if (only != NULL && written == 0 && code == 0) {
+        fprintf(stderr, "unknown scenario %s\n", only);
+        code = 1;
+    }
+
+    return code;
+}
+
+/**@brief Reads results from file.
+ * Reads results written by @ref write_result, either in CSV or in JSON,
+ * from file named @p name into array @p results.
+ * @param name    - name of the file,
+ * @param results - array of @ref MAX_RESULTS results.
+ * @return Number of read results or -1 if the file could not be opened.
+ */
+static int read_results(const char *name, result_t *results) {
+    char line[512];
+    int n = 0;
+    result_t *r;
+    FILE *in = fopen(name, "r");
+
+    if (in == NULL) {
+        return -1;
+    }
+
+    while (n < MAX_RESULTS && fgets(line, sizeof(line), in) != NULL) {
+        r = &results[n];
+
+        if (sscanf(line, " {\"scenario\": \"%63[^\"]\", \"seed\": %" SCNu64
+                         ", \"operations\": %" SCNu64 ", \"ns_p50\": %lf"
+                         ", \"ns_p90\": %lf, \"ns_p99\": %lf, \"ns_max\": %lf"
+                         ", \"ns_mean\": %lf, \"ns_clock\": %lf"
+                         ", \"allocations\": %" SCNu64
+                         ", \"peak_rss_kb\": %" SCNu64,
+                   r->scenario, &r->seed, &r->operations, &r->p50, &r->p90,
+                   &r->p99, &r->max, &r->mean, &r->clock, &r->allocations,
+                   &r->peak_rss) == 11 ||
+            sscanf(line, "%63[^,],%" SCNu64 ",%" SCNu64 ",%lf,%lf,%lf,%lf,%lf,"
+                         "%lf,%" SCNu64 ",%" SCNu64,
+                   r->scenario, &r->seed, &r->operations, &r->p50, &r->p90,
+                   &r->p99, &r->max, &r->mean, &r->clock, &r->allocations,
+                   &r->peak_rss) == 11) {
+            n++;
+        }
+    }
+
+    fclose(in);
+
+    return n;
+}
+
+/**@brief Gives relative change.
+ * @param base    - base value,
+ * @param current - current value.
+ * @return Change of @p current against @p base, in percents.
+ */
+static double change(double base, double current) {
+    return base == 0 ? 0 : 100 * (current - base) / base;
+}
+
+/**@brief Compares two files of results.
+ * Compares results of scenarios in file named @p current with results
+ * in file named @p base, writing a line per scenario. Scenario regressed
+ * if its median or 99th percentile of time, or peak resident memory, grew
+ * by more than @p threshold percents, or if it makes more allocations.
+ * @param base      - name of the file with base results,
+ * @param current   - name of the file with current results,
+ * @param threshold - allowed growth, in percents.
+ * @return Value @p 0 if no scenario regressed, @p 1 otherwise.
+ */
+static int compare_results(const char *base, const char *current,
+                           double threshold) {
+    result_t old[MAX_RESULTS], cur[MAX_RESULTS];
+    int i, j, old_num = read_results(base, old);
+    int cur_num = read_results(current, cur);
+    bool regressed, any = false;
+
+    if (old_num < 0 || cur_num < 0) {
+        fprintf(stderr, "cannot read %s\n", old_num < 0 ? base : current);
+
+        return 1;
+    }
+
+    printf("%-16s %12s %12s %8s %8s %8s %8s  %s\n", "scenario", "base_p50",
+           "p50", "p50%", "p99%", "allocs%", "rss%", "status");
+
+    for (i = 0; i < cur_num; ++i) {
+        for (j = 0; j < old_num && strcmp(old[j].scenario,
+                                          cur[i].scenario) != 0; ++j) {
+        }
+
+        if (j == old_num) {
+            printf("%-16s %12s %12.1f %8s %8s %8s %8s  new\n",
+                   cur[i].scenario, "-", cur[i].p50, "-", "-", "-", "-");
+            continue;
+        }
+
+        regressed = change(old[j].p50, cur[i].p50) > threshold ||
+                    change(old[j].p99, cur[i].p99) > threshold ||
+                    change(old[j].peak_rss, cur[i].peak_rss) > threshold ||
+                    cur[i].allocations > old[j].allocations;
+        any = any || regressed;
+
+        printf("%-16s %12.1f %12.1f %+7.1f%% %+7.1f%% %+7.1f%% %+7.1f%%  %s\n",
+               cur[i].scenario, old[j].p50, cur[i].p50,
+               change(old[j].p50, cur[i].p50), change(old[j].p99, cur[i].p99),
+               change(old[j].allocations, cur[i].allocations),
+               change(old[j].peak_rss, cur[i].peak_rss),
+               regressed ? "REGRESSION" : "ok");
+    }
+
+    return any ? 1 : 0;
+}
+
+/**@brief Writes out usage of the program.
+ * @param name - name of the program.
+ */
+static void usage(const char *name) {
+    fprintf(stderr, "usage: %s [-s seed] [-r scenario] [-q] [-j] [-o file]\n"
+                    "       %s -c base current [-t percent]\n"
+                    "       %s -l\n", name, name, name);
+}
+
+/**@brief Main function of gamma engine benchmark.
+ * Runs scenarios of the benchmark with option @p -s giving seed,
+ * @p -r choosing a single scenario, @p -q reducing number of samples,
+ * @p -j choosing JSON instead of CSV and @p -o giving output file.
+ * Option @p -c compares two files of results instead, with @p -t giving
+ * allowed growth in percents, and option @p -l lists scenarios.
+ * @param argc - number of arguments,
+ * @param argv - arguments.
+ * @return Value @p 0 if benchmark was run, or no regression was found.
+ */
+int main(int argc, char *argv[]) {
+    uint64_t seed = 1;
+    double threshold = DEFAULT_THRESHOLD;
+    const char *only = NULL, *output = NULL;
+    bool quick = false, json = false, compare = false, list = false;
+    char *ending;
+    uint32_t i;
+    int option, code;
+    FILE *out = stdout;
+
+    while ((option = getopt(argc, argv, "s:r:qjo:ct:l")) != -1) {
+        if (option == 's') {
+            seed = strtoull(optarg, &ending, 10);
+        } else if (option == 't') {
+            threshold = strtod(optarg, &ending);
+        } else if (option == 'r') {
+            only = optarg;
+        } else if (option == 'o') {
+            output = optarg;
+        } else if (option == 'q' || option == 'j' || option == 'c' ||
+                   option == 'l') {
+            quick = quick || option == 'q';
+            json = json || option == 'j';
+            compare = compare || option == 'c';
+            list = list || option == 'l';
+            continue;
+        } else {
+            usage(argv[0]);
+
+            return 1;
+        }
+
+        if ((option == 's' || option == 't') &&
+            (optarg[0] == '\0' || ending[0] != '\0')) {
+            usage(argv[0]);
+
+            return 1;
+        }
+    }
+
+    if (list) {
+        for (i = 0; i < SCENARIOS_NUM; ++i) {
+            printf("%s\n", scenarios[i].name);
+        }
+
+        return 0;
+    } else if (compare) {
+        if (argc - optind != 2) {
+            usage(argv[0]);
+
+            return 1;
+        }
+
+        return compare_results(argv[optind], argv[optind + 1], threshold);
+    } else if (optind != argc) {
+        usage(argv[0]);
+
+        return 1;
+    }
+
+    if (output != NULL) {
+        out = fopen(output, "w");
+        if (out == NULL) {
+            fprintf(stderr, "cannot open %s\n", output);
+
+            return 1;
+        }
+    }
+
+    code = run_benchmark(out, only, seed, quick, json);
+
+    if (out != stdout && fclose(out) != 0) {
+        code = 1;
+    }
+
+    return code;
+}
@@ -0,0 +1,415 @@
+/**@file
+ * Implementation of gamma game batch input reader.
+ *
+ * @author Antoni Koszowski <a.koszowski@students.mimuw.edu.pl>
+ * @copyright
+ * @date 17.06.2020
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "gamma_input.h"
+#include "gamma_output.h"
+#include "gamma_parser.h"
+#include "worker_pool.h"
+
+/**
+ * Initial number of bytes read at once.
+ */
+#define BLOCK_SIZE (1u << 20)
+
+/**
+ * Maximal number of lines parsed at once.
+ */
+#define BATCH_LINES (1u << 16)
+
+/**
+ * Number of lines handed out to a worker at once.
+ */
+#define LINES_PER_TASK (1u << 10)
+
+/**
+ * Number of lines parsed by the calling thread on its own,
+ * before any worker thread is started.
+ */
+#define LINES_PER_WORKER (1u << 13)
+
+/**
+ * Number of lines executed by the calling thread on its own,
+ * before games are split between worker threads.
+ */
+#define COMMANDS_PER_WORKER (1u << 10)
+
+/**
+ * Structure storing a batch of input lines.
+ * Lines meant for different games may be executed in parallel, each group
+ * of games, called a shard, by a single thread in order of lines.
+ */
+typedef struct batch {
+    const char *starts[BATCH_LINES];    ///< first signs of lines
+    size_t lens[BATCH_LINES];           ///< numbers of signs of lines
+    command_t commands[BATCH_LINES];    ///< parsed lines
+    session_t *sessions[BATCH_LINES];   ///< sessions of games of lines
+    uint32_t order[BATCH_LINES];        ///< lines grouped by shards
+    reply_t slots[BATCH_LINES];         ///< replies to lines
+    uint32_t shard_ends[MAX_WORKERS];   ///< ends of shards in order of lines
+    uint32_t shards_num;                ///< number of shards
+    replies_t replies[MAX_WORKERS];     ///< replies gathered by shards
+    uint32_t lines_num;                 ///< number of lines in the batch
+    uint64_t first_line;                ///< number of the first line
+    atomic_uint_fast32_t next;          ///< next line or shard to be handed out
+} batch_t;
+
+/**
+ * Pointer to batch of lines being parsed.
+ */
+static batch_t *batch = NULL;
+
+/**
+ * Buffer storing input which is read in blocks.
+ */
+static char *buffer = NULL;
+
+/**
+ * Whether input consists of binary command records instead of lines.
+ */
+static bool binary_input = false;
+
+/**
+ * Pointer to session which executed the last line directly, whose moves
+ * may still wait for execution.
+ */
+static session_t *last_session = NULL;
+
+/**
+ * Function deallocating batch and buffer.
+ */
+static void free_input() {
+    uint32_t i;
+
+    if (batch != NULL) {
+        for (i = 0; i < MAX_WORKERS; ++i) {
+            free(batch->replies[i].text);
+        }
+    }
+
+    free(batch);
+    free(buffer);
+}
+
+/**@brief Parses lines of the batch.
+ * Parses lines taken in tasks from batch pointed by @p arg,
+ * until no line is left.
+ * @param[in,out] arg - pointer to the batch.
+ * @return Value NULL.
+ */
+static void *parse_lines(void *arg) {
+    batch_t *b = arg;
+    uint32_t i, first;
+
+    while (true) {
+        first = atomic_fetch_add(&b->next, LINES_PER_TASK);
+        if (first >= b->lines_num) {
+            break;
+        }
+
+        for (i = first; i < b->lines_num && i < first + LINES_PER_TASK; ++i) {
+            if (binary_input) {
+                decode_record(b->starts[i], b->lens[i], &b->commands[i]);
+            } else {
+                parse_line(b->starts[i], b->lens[i], &b->commands[i]);
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/**@brief Gives number of workers for the batch.
+ * Gives number of threads that should work on the batch, including
+ * the calling thread, given that each of them should get at least
+ * @p per_worker lines.
+ * @param per_worker - number of lines per worker.
+ * @return Number of workers.
+ */
+static uint32_t workers_num(uint32_t per_worker) {
+    return pool_size(batch->lines_num, per_worker, MAX_WORKERS);
+}
+
+/**@brief Runs work on the batch.
+ * Runs function @p work on the batch in @p workers threads, including
+ * the calling thread, which hand out the work among themselves.
+ * @param work    - function run by the threads,
+ * @param workers - number of threads.
+ */
+static void run_workers(void *(*work)(void *), uint32_t workers) {
+    atomic_store(&batch->next, 0);
+    run_pool(work, batch, workers);
+}
+
+/**@brief Executes shards of the batch.
+ * Executes lines of shards taken one by one from batch pointed by @p arg,
+ * until no shard is left, gathering replies of each shard apart.
+ * Waiting moves of games are executed at the end of their shard.
+ * @param[in,out] arg - pointer to the batch.
+ * @return Value NULL.
+ */
+static void *execute_shards(void *arg) {
+    batch_t *b = arg;
+    uint32_t shard, i, line;
+
+    while ((shard = atomic_fetch_add(&b->next, 1)) < b->shards_num) {
+        i = shard == 0 ? 0 : b->shard_ends[shard - 1];
+        for (; i < b->shard_ends[shard]; ++i) {
+            line = b->order[i];
+            execute_command(b->sessions[line], &b->commands[line],
+                            b->first_line + line, &b->replies[shard], line);
+        }
+
+        i = shard == 0 ? 0 : b->shard_ends[shard - 1];
+        for (; i < b->shard_ends[shard]; ++i) {
+            finish_session(b->sessions[b->order[i]]);
+        }
+    }
+
+    return NULL;
+}
+
+/**@brief Executes lines of the batch in parallel.
+ * Splits lines of the batch into @p shards shards by numbers of their games
+ * and executes them in parallel. Replies are written in order of lines.
+ * @param shards - number of shards.
+ */
+static void execute_parallel(uint32_t shards) {
+    uint32_t i, shard, counts[MAX_WORKERS] = {0};
+
+    for (i = 0; i < batch->lines_num; ++i) {
+        counts[batch->commands[i].game_id % shards]++;
+    }
+
+    batch->shards_num = shards;
+    for (shard = 0; shard < shards; ++shard) {
+        batch->shard_ends[shard] = counts[shard] +
+                (shard == 0 ? 0 : batch->shard_ends[shard - 1]);
+        batch->replies[shard].len = 0;
+    }
+
+    // Lines of each shard stay in order of input.
+    for (i = batch->lines_num; i > 0; --i) {
+        shard = batch->commands[i - 1].game_id % shards;
+        batch->order[--counts[shard] + (shard == 0 ? 0 :
+                                        batch->shard_ends[shard - 1])] = i - 1;
+    }
+
+    memset(batch->slots, 0, sizeof(reply_t) * batch->lines_num);
+    run_workers(execute_shards, shards);
+    write_replies(batch->slots, batch->lines_num);
+}
+
+/**@brief Executes lines of the batch one by one.
+ * Executes lines of the batch in order of input, writing replies directly.
+ * Waiting moves of a game are executed as soon as a line of another game
+ * follows them, so that replies stay in order of lines.
+ */
+static void execute_directly() {
+    uint32_t i;
+
+    for (i = 0; i < batch->lines_num; ++i) {
+        if (batch->commands[i].kind != LINE_SKIPPED &&
+            batch->sessions[i] != last_session) {
+            if (last_session != NULL) {
+                finish_session(last_session);
+            }
+            last_session = batch->sessions[i];
+        }
+
+        execute_command(batch->sessions[i], &batch->commands[i],
+                        batch->first_line + i, NULL, 0);
+    }
+}
+
+/**@brief Parses and executes the batch.
+ * Parses lines of the batch, in parallel if there are many of them,
+ * and executes them. Lines of different games are executed in parallel
+ * if there are many of them, replies are written in order of lines anyway.
+ */
+static void run_batch() {
+    uint32_t i, shards = workers_num(COMMANDS_PER_WORKER);
+    bool tagged = false;
+    command_t *cmd;
+
+    run_workers(parse_lines, workers_num(LINES_PER_WORKER));
+
+    // Interactive mode can be launched only by the calling thread.
+    for (i = 0; i < batch->lines_num; ++i) {
+        cmd = &batch->commands[i];
+        batch->sessions[i] = find_session(cmd);
+        tagged = tagged || cmd->tagged;
+
+        if (cmd->kind == LINE_COMMAND && cmd->sign == 'I' && !cmd->tagged) {
+            shards = 1;
+        }
+    }
+
+    if (tagged && shards > 1) {
+        if (last_session != NULL) {
+            finish_session(last_session);
+            last_session = NULL;
+        }
+
+        execute_parallel(shards);
+    } else {
+        execute_directly();
+    }
+
+    batch->first_line += batch->lines_num;
+    batch->lines_num = 0;
+}
+
+/**@brief Executes lines of the input.
+ * Executes lines of @p size signs of input starting at @p data. Last line
+ * is executed only if @p end is set, otherwise only lines ending with '\n'
+ * are executed. Binary input is split into records of fixed size instead,
+ * and a shorter record is left only at the end of input.
+ * @param data - signs of the input,
+ * @param size - number of signs,
+ * @param end  - whether the input ends with these signs.
+ * @return Number of signs of executed lines.
+ */
+static size_t run_lines(const char *data, size_t size, bool end) {
+    const char *pos = data, *stop = data + size, *endl;
+
+    while (pos < stop) {
+        if (binary_input) {
+            endl = stop - pos >= RECORD_SIZE ? pos + RECORD_SIZE - 1 : NULL;
+        } else {
+            endl = memchr(pos, '\n', (size_t) (stop - pos));
+        }
+        if (endl == NULL && !end) {
+            break;
+        }
+
+        endl = endl == NULL ? stop - 1 : endl;
+        batch->starts[batch->lines_num] = pos;
+        batch->lens[batch->lines_num] = (size_t) (endl + 1 - pos);
+        pos = endl + 1;
+
+        if (++batch->lines_num == BATCH_LINES) {
+            run_batch();
+        }
+    }
+
+    if (batch->lines_num > 0) {
+        run_batch();
+    }
+
+    return (size_t) (pos - data);
+}
+
+/**@brief Reads and executes input mapped into memory.
+ * Maps regular file @p fd into memory and executes its lines following
+ * the current offset of the file.
+ * @param fd   - file descriptor of input.
+ * @return Value @p true if the file was mapped, @p false otherwise.
+ */
+static bool map_input(int fd) {
+    struct stat st;
+    off_t offset = lseek(fd, 0, SEEK_CUR);
+    size_t size;
+    char *data;
+
+    if (offset == -1 || fstat(fd, &st) == -1 || !S_ISREG(st.st_mode) ||
+        st.st_size <= offset || (uint64_t) st.st_size > SIZE_MAX) {
+        return false;
+    }
+
+    size = (size_t) st.st_size;
+    data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+
+    posix_madvise(data, size, POSIX_MADV_SEQUENTIAL);
+    run_lines(data + offset, size - (size_t) offset, true);
+    munmap(data, size);
+
+    return true;
+}
+
+/**@brief Reads and executes input in blocks.
+ * Reads input from @p fd in large blocks and executes lines completely read
+ * after each of them. Buffer grows when a line does not fit in it.
+ * @param fd - file descriptor of input.
+ */
+static void read_blocks(int fd) {
+    size_t size = BLOCK_SIZE, filled = 0, done;
+    ssize_t got;
+
+    buffer = malloc(size);
+    if (buffer == NULL) {
+        exit(1);
+    }
+
+    while (true) {
+        if (filled == size) {
+            size *= 2;
+            buffer = realloc(buffer, size);
+            if (buffer == NULL) {
+                exit(1);
+            }
+        }
+
+        // Replies to lines read so far are not held back while waiting.
+        flush_output();
+
+        got = read(fd, buffer + filled, size - filled);
+        if (got == -1 && errno == EINTR) {
+            continue;
+        } else if (got <= 0) {
+            break;
+        }
+
+        filled += (size_t) got;
+        done = run_lines(buffer, filled, false);
+        memmove(buffer, buffer + done, filled - done);
+        filled -= done;
+    }
+
+    run_lines(buffer, filled, true);
+}
+
+void read_input(int fd, bool binary) {
+    uint32_t i;
+
+    binary_input = binary;
+    atexit(free_input);
+
+    batch = malloc(sizeof(batch_t));
+    if (batch == NULL) {
+        exit(1);
+    }
+
+    batch->lines_num = 0;
+    batch->first_line = 1;
+    atomic_init(&batch->next, 0);
+    for (i = 0; i < MAX_WORKERS; ++i) {
+        batch->replies[i] = (replies_t) {NULL, 0, 0, batch->slots};
+    }
+
+    // Regular files are mapped, other input is read as it comes.
+    if (!map_input(fd)) {
+        read_blocks(fd);
+    }
+
+    if (last_session != NULL) {
+        finish_session(last_session);
+    }
+}
@@ -0,0 +1,33 @@
+/**@file
+ * Interface of gamma game batch input reader.
+ *
+ * Input is mapped into memory when it is a regular file and read in large
+ * blocks otherwise. Lines are split in batches, which are parsed by a pool
+ * of worker threads, since parsing does not depend on state of the game.
+ * Lines are then executed in order of input, except that lines of different
+ * numbered games are split into shards by numbers of games and executed
+ * by worker threads in parallel, each shard by a single thread. Replies
+ * are written in order of lines either way.
+ *
+ * @author Antoni Koszowski <a.koszowski@students.mimuw.edu.pl>
+ * @copyright
+ * @date 17.06.2020
+ */
+
+#ifndef GAMMA_GAMMA_INPUT_H
+#define GAMMA_GAMMA_INPUT_H
+
+#include <stdbool.h>
+
+/**@brief Reads and executes input.
+ * Reads input from file descriptor @p fd until its end, executing
+ * commands from consecutive lines, or from binary command records
+ * if @p binary is set. Lines completely read are executed before waiting
+ * for more input, so that a terminal can be used as input.
+ * Terminates the program if memory could not be allocated.
+ * @param fd     - file descriptor of input,
+ * @param binary - whether input consists of binary command records.
+ */
+void read_input(int fd, bool binary);
+
+#endif //GAMMA_GAMMA_INPUT_H
@@ -21,7 +21,7 @@
 /**
  * Onscreen information height.
  */
-#define INFO_HEIGHT 12
+#define INFO_HEIGHT 14
 /**
  * Onscreen information width.
  */
@@ -32,8 +32,12 @@
  */
 struct terminal {
     bool tips;                   ///< controlling whether tips are on/off
-    uint64_t cursor_x;           ///< cursor x-coordinate position
-    uint64_t cursor_y;           ///< cursor y-coordinate position
+    uint32_t cursor_x;           ///< x-coordinate of field under cursor
+    uint32_t cursor_y;           ///< y-coordinate of field under cursor
+    uint32_t view_x;             ///< x-coordinate of lower left visible field
+    uint32_t view_y;             ///< y-coordinate of lower left visible field
+    uint32_t view_width;         ///< number of visible columns of board
+    uint32_t view_height;        ///< number of visible rows of board
     uint32_t screen_rows;        ///< number of screen rows
     uint32_t screen_cols;        ///< number of screen columns
     struct termios orig_config;  ///< original terminal configuration
@@ -49,6 +53,8 @@ const char *tips_off = "\nPress t to see game tips";
  */
 const char *tips_on = "\nPress t to hide game tips"
                       "\n\x1b[44m \x1b[0m: cursor position"
+                      "\n\x1b[42m \x1b[0m: standard move possible"
+                      "\n\x1b[43m \x1b[0m: golden move possible"
                       "\nPress space to make a standard move"
                       "\nPress g or G to make a golden move"
                       "\nPress c or C to skip your move"
@@ -63,6 +69,8 @@ struct game_params {
     uint32_t players_num;   ///< number of players
     uint32_t cur_player;    ///< number of current player
     uint32_t cell_width;    ///< board cell width
+    uint64_t *move_mask;    ///< visible fields of standard moves
+    uint64_t *golden_mask;  ///< visible fields of golden moves
 };
 
 /**
@@ -71,6 +79,39 @@ struct game_params {
 struct screen_buffer {
     char *buf;          ///< content of buffer
     uint64_t len;       ///< length of buffer
+    uint64_t cap;       ///< number of allocated characters
+};
+
+/**
+ * Styles of board cells.
+ */
+enum cell_style {
+    PLAIN_CELL,         ///< cell without highlight
+    MOVE_CELL,          ///< cell of standard move of current player
+    GOLDEN_CELL,        ///< cell of golden move of current player
+    CURSOR_CELL         ///< cell under cursor
+};
+
+/**
+ * Escape codes starting styles of board cells.
+ */
+const char *style_codes[] = {"", "\x1b[42m", "\x1b[43m", "\x1b[44m"};
+
+/**
+ * Structure representing frame drawn in the terminal window,
+ * so that only its changes are drawn. Only visible part of board is kept.
+ */
+struct frame {
+    bool drawn;             ///< whether the frame is on the screen
+    bool board_stale;       ///< whether board changed since it was depicted
+    bool info_stale;        ///< whether information changed since it was made
+    char *board;            ///< current depiction of visible board
+    uint64_t board_size;    ///< size of depictions of visible board
+    char *screen_board;     ///< depiction of visible board on the screen
+    uint8_t *screen_styles; ///< styles of visible cells on the screen
+    struct screen_buffer info;        ///< current information lines
+    struct screen_buffer screen_info; ///< information lines on the screen
+    struct screen_buffer output;      ///< escape codes of the next frame
 };
 
 /**
@@ -102,6 +143,11 @@ struct terminal config;
  */
 struct game_params g_ps;
 
+/**
+ * Structure storing frame drawn in the terminal window.
+ */
+struct frame frame;
+
 /**
  * Disables terminal raw mode.
  */
@@ -146,16 +192,27 @@ static void get_window_size() {
 
 /**
  * Checks whether in terminal with given window size
- * gamma game board can be screened.
+ * information and at least one cell of gamma game board can be screened,
+ * and sets up size of visible part of board.
  */
 static void check_window() {
-    if (config.screen_rows - INFO_HEIGHT < g_ps.height ||
+    if (config.screen_rows <= INFO_HEIGHT ||
         config.screen_cols < INFO_WIDTH ||
-        config.screen_cols < g_ps.width * g_ps.cell_width) {
+        config.screen_cols < g_ps.cell_width) {
         printf("Unfortunately, size of your window is not big enough for given parameters.\n"
                "Try to enlarge the window or change game parameters !!!\n");
         exit(1);
     }
+
+    config.view_width = config.screen_cols / g_ps.cell_width;
+    if (config.view_width > g_ps.width) {
+        config.view_width = g_ps.width;
+    }
+
+    config.view_height = config.screen_rows - INFO_HEIGHT;
+    if (config.view_height > g_ps.height) {
+        config.view_height = g_ps.height;
+    }
 }
 
 /**
@@ -210,25 +267,65 @@ static int read_key() {
  * @param len      - length of appended string.
  */
 static void append(struct screen_buffer *content, const char *s, int len) {
-    char *new = realloc(content->buf, content->len + len);
-    if (new == NULL) {
-        exit(1);
+    uint64_t new_cap;
+    char *new;
+
+    if (content->len + len > content->cap) {
+        new_cap = 2 * content->cap + len;
+
+        new = realloc(content->buf, new_cap);
+        if (new == NULL) {
+            exit(1);
+        }
+
+        content->buf = new;
+        content->cap = new_cap;
     }
 
-    memcpy(&new[content->len], s, len);
-    content->buf = new;
+    memcpy(&content->buf[content->len], s, len);
     content->len += len;
 }
 
 /**
- * Prints gamma game board into the terminal window.
+ * Checks whether visible field with coordinates @p x, @p y is marked
+ * in bitmap @p mask of visible part of board.
+ * @param mask  - bitmap of visible fields,
+ * @param x     - field x-coordinate,
+ * @param y     - field y-coordinate.
+ * @return Value @p true if the field is marked, @p false otherwise.
  */
-static void print_board() {
-    char *board = gamma_board(gamma_game);
-    if (board == NULL) {
+static bool marked(uint64_t *mask, uint32_t x, uint32_t y) {
+    uint64_t bit = (uint64_t) (y - config.view_y) * config.view_width +
+                   (x - config.view_x);
+
+    return (mask[bit / 64] >> (bit % 64)) & 1;
+}
+
+/**
+ * Computes visible fields on which current player can make a move.
+ * Only visible part of board is checked, so it takes time proportional
+ * to the size of the window rather than to the size of board.
+ */
+static void update_masks() {
+    if (!gamma_legal_mask_region(gamma_game, g_ps.cur_player, GAMMA_MOVE,
+                                 config.view_x, config.view_y,
+                                 config.view_width, config.view_height,
+                                 g_ps.move_mask)) {
+        exit(1);
+    }
+    if (!gamma_legal_mask_region(gamma_game, g_ps.cur_player,
+                                 GAMMA_GOLDEN_MOVE,
+                                 config.view_x, config.view_y,
+                                 config.view_width, config.view_height,
+                                 g_ps.golden_mask)) {
         exit(1);
     }
+}
 
+/**
+ * Prints gamma game board into the terminal window.
+ */
+static void print_board() {
     // Clearing the screen.
     if (write(STDOUT_FILENO, "\x1b[2J", 4) == -1) {
     }
@@ -237,9 +334,10 @@ static void print_board() {
         exit(1);
     }
 
-    printf("%s", board);
-
-    free(board);
+    if (!gamma_board_fwrite(gamma_game, stdout)) {
+        exit(1);
+    }
+    fflush(stdout);
 }
 
 /**
@@ -249,7 +347,7 @@ static void print_results() {
     uint32_t i;
     uint64_t b_f;
     char buf[128];
-    struct screen_buffer results = {NULL, 0};
+    struct screen_buffer results = {NULL, 0, 0};
 
     snprintf(buf, sizeof(buf), "\n\x1b[4mGAMMA GAME SUMMARY:\x1b[0m\n"
                                "\nPLAYER ID | BUSY_FIELDS\n");
@@ -276,45 +374,52 @@ static void print_results() {
 static void move_cursor(int key) {
     switch (key) {
         case ARROW_LEFT:
-            if (config.cursor_x != g_ps.cell_width) {
-                config.cursor_x -= g_ps.cell_width;
+            if (config.cursor_x != 0) {
+                config.cursor_x--;
             }
             break;
         case ARROW_RIGHT:
-            if (config.cursor_x != g_ps.width * g_ps.cell_width) {
-                config.cursor_x += g_ps.cell_width;
+            if (config.cursor_x != g_ps.width - 1) {
+                config.cursor_x++;
             }
             break;
         case ARROW_UP:
-            if (config.cursor_y != 1) {
-                config.cursor_y--;
+            if (config.cursor_y != g_ps.height - 1) {
+                config.cursor_y++;
             }
             break;
         case ARROW_DOWN:
-            if (config.cursor_y != g_ps.height) {
-                config.cursor_y++;
+            if (config.cursor_y != 0) {
+                config.cursor_y--;
             }
             break;
     }
+
+    // Visible part of board follows the cursor.
+    if (config.cursor_x < config.view_x) {
+        config.view_x = config.cursor_x;
+        frame.board_stale = true;
+    } else if (config.cursor_x >= config.view_x + config.view_width) {
+        config.view_x = config.cursor_x - config.view_width + 1;
+        frame.board_stale = true;
+    }
+
+    if (config.cursor_y < config.view_y) {
+        config.view_y = config.cursor_y;
+        frame.board_stale = true;
+    } else if (config.cursor_y >= config.view_y + config.view_height) {
+        config.view_y = config.cursor_y - config.view_height + 1;
+        frame.board_stale = true;
+    }
 }
 
 /**
  * Updates gamma game parameters.
  */
 static void update_params() {
-    int counter = g_ps.players_num;
-    uint32_t next_p = (g_ps.cur_player % g_ps.players_num) + 1;
-    bool f_f = (gamma_free_fields(gamma_game, next_p) != 0);
-    bool g_p = gamma_golden_possible(gamma_game, next_p);
+    uint32_t next_p = gamma_next_active_player(gamma_game, g_ps.cur_player);
 
-    while (!f_f && !g_p && counter > 0) {
-        next_p = (next_p % g_ps.players_num) + 1;
-        f_f = gamma_free_fields(gamma_game, next_p);
-        g_p = gamma_golden_possible(gamma_game, next_p);
-        counter--;
-    }
-
-    if (counter == 0) {
+    if (next_p == 0) {
         if (write(STDOUT_FILENO, "\x1b[2J", 4) == -1) {
             exit(1);
         }
@@ -333,6 +438,9 @@ static void update_params() {
         exit(0);
     } else {
         g_ps.cur_player = next_p;
+
+        frame.board_stale = true;
+        frame.info_stale = true;
     }
 }
 
@@ -368,40 +476,161 @@ static void get_info(struct screen_buffer *content) {
 }
 
 /**
- * Sets cursor in terminal window on given position given by appending
- * escape code in to screen buffer pointed by @p content.
- * @param content   - ponter to screen buffer.
+ * Gives style of cell with coordinates @p x, @p y.
+ * @param x     - field x-coordinate,
+ * @param y     - field y-coordinate.
+ * @return Style of the cell.
  */
-static void set_cursor(struct screen_buffer *content) {
-    uint32_t x = config.cursor_x / g_ps.cell_width - 1;
-    uint32_t y = g_ps.height - config.cursor_y;
+static uint8_t cell_style(uint32_t x, uint32_t y) {
+    if (x == config.cursor_x && y == config.cursor_y) {
+        return CURSOR_CELL;
+    } else if (marked(g_ps.move_mask, x, y)) {
+        return MOVE_CELL;
+    } else if (marked(g_ps.golden_mask, x, y)) {
+        return GOLDEN_CELL;
+    }
 
-    char b[128];
-    char *temp = get_cell_content(gamma_game, x, y);
-    snprintf(b, sizeof(b), "\x1b[%lu;%luH\x1b[44m%s\x1b[0m", config.cursor_y,
-             config.cursor_x - g_ps.cell_width + 1, temp);
+    return PLAIN_CELL;
+}
 
-    append(content, b, strlen(b));
+/**
+ * Appends to the next frame escape codes drawing visible cells of the board,
+ * whose content or style differs from the one on the screen.
+ * Cells following each other in a row are drawn without moving the cursor.
+ */
+static void draw_board() {
+    uint64_t row_width = (uint64_t) config.view_width * g_ps.cell_width + 1;
+    uint64_t k, i = 0;
+    uint32_t x, row;
+    uint8_t style;
+    bool placed;
+    char b[64];
+
+    for (row = 0; row < config.view_height; ++row) {
+        placed = false;
+
+        for (x = 0; x < config.view_width; ++x, ++i) {
+            k = row_width * row + (uint64_t) x * g_ps.cell_width;
+            style = cell_style(config.view_x + x,
+                               config.view_y + config.view_height - 1 - row);
+
+            if (frame.drawn && frame.screen_styles[i] == style &&
+                memcmp(&frame.board[k], &frame.screen_board[k],
+                       g_ps.cell_width) == 0) {
+                placed = false;
+                continue;
+            }
 
-    free(temp);
+            if (!placed) {
+                snprintf(b, sizeof(b), "\x1b[%u;%luH", row + 1,
+                         (uint64_t) x * g_ps.cell_width + 1);
+                append(&frame.output, b, strlen(b));
+                placed = true;
+            }
+
+            append(&frame.output, style_codes[style],
+                   strlen(style_codes[style]));
+            append(&frame.output, &frame.board[k], g_ps.cell_width);
+            if (style != PLAIN_CELL) {
+                append(&frame.output, "\x1b[0m", 4);
+            }
+
+            memcpy(&frame.screen_board[k], &frame.board[k], g_ps.cell_width);
+            frame.screen_styles[i] = style;
+        }
+    }
 }
 
 /**
- * Refreshes, actualizes content of the terminal window.
+ * Gives length of the line starting at @p pos in the screen buffer
+ * pointed by @p content, or zero if there is no such line.
+ * @param content   - pointer to the buffer,
+ * @param pos       - position of the line.
+ * @return Length of the line, including the new line character.
+ */
+static uint64_t line_length(struct screen_buffer *content, uint64_t pos) {
+    uint64_t end = pos;
+
+    while (end < content->len && content->buf[end] != '\n') {
+        end++;
+    }
+
+    return end < content->len ? end - pos + 1 : end - pos;
+}
+
+/**
+ * Appends to the next frame escape codes drawing information lines,
+ * which differ from the ones on the screen, and clearing lines
+ * which are not needed anymore.
+ */
+static void draw_info() {
+    uint64_t pos = 0, screen_pos = 0, len, screen_len;
+    uint32_t row = config.view_height + 1;
+    char b[64];
+
+    while (pos < frame.info.len || screen_pos < frame.screen_info.len) {
+        len = line_length(&frame.info, pos);
+        screen_len = line_length(&frame.screen_info, screen_pos);
+
+        if (!frame.drawn || len != screen_len ||
+            memcmp(&frame.info.buf[pos], &frame.screen_info.buf[screen_pos],
+                   len) != 0) {
+            snprintf(b, sizeof(b), "\x1b[%u;1H", row);
+            append(&frame.output, b, strlen(b));
+
+            // Line is cleared after it is drawn, without its new line.
+            if (len > 0 && frame.info.buf[pos + len - 1] == '\n') {
+                append(&frame.output, &frame.info.buf[pos], len - 1);
+            } else {
+                append(&frame.output, &frame.info.buf[pos], len);
+            }
+            append(&frame.output, "\x1b[K", 3);
+        }
+
+        pos += len;
+        screen_pos += screen_len;
+        row++;
+    }
+
+    frame.screen_info.len = 0;
+    append(&frame.screen_info, frame.info.buf, frame.info.len);
+}
+
+/**
+ * Refreshes, actualizes content of the terminal window, drawing only
+ * changes of the frame with a single write.
  */
 static void refresh_screen() {
-    print_board();
+    frame.output.len = 0;
 
-    struct screen_buffer info = {NULL, 0};
+    if (!frame.drawn) {
+        append(&frame.output, "\x1b[2J", 4);
+    }
+
+    if (frame.board_stale) {
+        if (!gamma_board_region(gamma_game, config.view_x, config.view_y,
+                                config.view_width, config.view_height,
+                                frame.board, frame.board_size)) {
+            exit(1);
+        }
+        update_masks();
+        frame.board_stale = false;
+    }
 
-    get_info(&info);
+    if (frame.info_stale) {
+        frame.info.len = 0;
+        get_info(&frame.info);
+        frame.info_stale = false;
+    }
 
-    set_cursor(&info);
+    draw_board();
+    draw_info();
+    frame.drawn = true;
 
-    if (write(STDOUT_FILENO, info.buf, info.len) == -1) {
+    if (frame.output.len > 0 &&
+        write(STDOUT_FILENO, frame.output.buf, frame.output.len) == -1) {
         exit(1);
     }
-    free(info.buf);
 }
 
 /**
@@ -409,8 +638,8 @@ static void refresh_screen() {
  */
 static void process_keypress() {
     int c = read_key();
-    uint32_t x = config.cursor_x / g_ps.cell_width - 1;
-    uint32_t y = g_ps.height - config.cursor_y;
+    uint32_t x = config.cursor_x;
+    uint32_t y = config.cursor_y;
 
     switch (c) {
         case CTRL_KEY('d'):
@@ -451,6 +680,7 @@ static void process_keypress() {
             break;
         case TIPS:
             config.tips = !config.tips;
+            frame.info_stale = true;
             break;
     }
 }
@@ -469,13 +699,40 @@ void init(uint32_t width, uint32_t height, uint32_t players_num) {
     g_ps.cur_player = 1;
     g_ps.cell_width = get_cell_width(players_num);
 
-    config.cursor_x = g_ps.cell_width;
-    config.cursor_y = height;
     config.tips = true;
 
     get_window_size();
 
     check_window();
+
+    // Cursor starts in upper left corner of the board.
+    config.cursor_x = 0;
+    config.cursor_y = height - 1;
+    config.view_x = 0;
+    config.view_y = height - config.view_height;
+
+    frame.board_size = config.view_height *
+                       ((uint64_t) config.view_width * g_ps.cell_width + 1) + 1;
+    frame.board = malloc(sizeof(char) * frame.board_size);
+    frame.screen_board = malloc(sizeof(char) * frame.board_size);
+    frame.screen_styles = malloc(sizeof(uint8_t) * config.view_height *
+                                 config.view_width);
+    if (frame.board == NULL || frame.screen_board == NULL ||
+        frame.screen_styles == NULL) {
+        exit(1);
+    }
+    frame.board_stale = true;
+    frame.info_stale = true;
+
+    g_ps.move_mask = malloc(sizeof(uint64_t) *
+                            (((uint64_t) config.view_width *
+                              config.view_height + 63) / 64));
+    g_ps.golden_mask = malloc(sizeof(uint64_t) *
+                              (((uint64_t) config.view_width *
+                                config.view_height + 63) / 64));
+    if (g_ps.move_mask == NULL || g_ps.golden_mask == NULL) {
+        exit(1);
+    }
 }
 
 void launch_interactive(gamma_t *game_ptr, uint32_t width, uint32_t height,
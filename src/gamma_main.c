@@ -6,43 +6,73 @@
  * @date 17.05.2020
  */
 
-#define _GNU_SOURCE
+#define _POSIX_C_SOURCE 200809L
 
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <unistd.h>
+#include "gamma_input.h"
+#include "gamma_output.h"
 #include "gamma_parser.h"
 
 /**
- * Buffer storing parsed input.
+ * Whether binary protocol is used instead of text one.
  */
-static char *buffer;
+static bool binary = false;
 
-/**
- * Function deallocating buffer.
+/**@brief Sets up program options.
+ * Sets up options given in @p argc arguments @p argv: option @p -n with
+ * number of replies written out together, option @p -p writing out
+ * output after every printed board and option @p -b choosing binary
+ * protocol.
+ * @param argc - number of arguments,
+ * @param argv - arguments.
+ * @return Value @p true if options are correct, @p false otherwise.
  */
-static void free_buffer() {
-    free(buffer);
+static bool set_options(int argc, char *argv[]) {
+    uint64_t every = 0;
+    bool on_board = false;
+    char *ending;
+    int option;
+
+    while ((option = getopt(argc, argv, "n:pb")) != -1) {
+        if (option == 'n' && optarg[0] >= '0' && optarg[0] <= '9') {
+            every = strtoull(optarg, &ending, 10);
+            if (ending[0] != 0) {
+                return false;
+            }
+        } else if (option == 'p') {
+            on_board = true;
+        } else if (option == 'b') {
+            binary = true;
+        } else {
+            return false;
+        }
+    }
+
+    set_flush_policy(every, on_board);
+    set_binary_output(binary);
+
+    return optind == argc;
 }
 
 /**@brief Main function of gamma game.
  * Main function of gamma game, realising simulation.
+ * @param argc - number of arguments,
+ * @param argv - arguments.
  * @return Value @p 0 if game was run successfully.
  */
-int main() {
-    size_t buf_size = 32;
-
-    atexit(free_buffer);
+int main(int argc, char *argv[]) {
+    if (!set_options(argc, argv)) {
+        fprintf(stderr, "usage: %s [-n replies] [-p] [-b]\n", argv[0]);
 
-    buffer = malloc(sizeof(char) * buf_size);
-    if (buffer == NULL) {
-        exit(1);
+        return 1;
     }
 
-    while (getline(&buffer, &buf_size, stdin) != -1) {
-        parse_input(buffer);
-    }
+    read_input(STDIN_FILENO, binary);
 
-    delete_game();
+    delete_sessions();
 
     return 0;
-}
\ No newline at end of file
+}
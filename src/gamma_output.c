@@ -0,0 +1,337 @@
+/**@file
+ * Implementation of gamma game batch output writer.
+ *
+ * @author Antoni Koszowski <a.koszowski@students.mimuw.edu.pl>
+ * @copyright
+ * @date 17.06.2020
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "digits.h"
+#include "gamma_output.h"
+
+/**
+ * Number of bytes gathered before they are written out.
+ */
+#define OUTPUT_SIZE (1u << 20)
+
+/**
+ * Maximal number of signs of a single reply, other than board.
+ */
+#define MAX_REPLY 32
+
+/**
+ * Number of bytes of a binary reply, other than text of board.
+ */
+#define BINARY_REPLY 9
+
+/**
+ * Structure storing buffered output.
+ */
+static struct output {
+    char buf[OUTPUT_SIZE];  ///< gathered output
+    size_t len;             ///< number of gathered bytes
+    int fd;                 ///< descriptor gathered output is meant for
+    uint64_t replies;       ///< number of replies since output was written
+    uint64_t every;         ///< number of replies written out together or 0
+    bool on_board;          ///< whether output is written after board
+    bool binary;            ///< whether replies are binary
+    bool registered;        ///< whether output is written out at exit
+} output = {.fd = STDOUT_FILENO};
+
+/**@brief Writes bytes to a descriptor.
+ * Writes @p len bytes starting at @p data to descriptor @p fd, retrying
+ * interrupted and partial writes.
+ * @param fd   - file descriptor,
+ * @param data - written bytes,
+ * @param len  - number of bytes.
+ * @return Value @p true if all bytes were written, @p false otherwise.
+ */
+static bool write_all(int fd, const char *data, size_t len) {
+    ssize_t written;
+
+    while (len > 0) {
+        written = write(fd, data, len);
+        if (written == -1 && errno == EINTR) {
+            continue;
+        } else if (written <= 0) {
+            return false;
+        }
+
+        data += written;
+        len -= (size_t) written;
+    }
+
+    return true;
+}
+
+/**@brief Writes out buffered output.
+ * Writes out output gathered in the buffer.
+ * @return Value @p true if output was written, @p false otherwise.
+ */
+static bool write_output() {
+    bool written = write_all(output.fd, output.buf, output.len);
+
+    output.len = 0;
+    output.replies = 0;
+
+    return written;
+}
+
+/**
+ * Function writing out output left in the buffer at exit.
+ */
+static void write_at_exit() {
+    write_output();
+}
+
+void flush_output() {
+    if (output.len > 0 && !write_output()) {
+        exit(1);
+    }
+}
+
+/**@brief Makes room for a reply.
+ * Makes room for reply of at most @p len bytes meant for descriptor
+ * @p fd, writing out buffered output if it is meant for another descriptor
+ * or there is not enough room left.
+ * @param fd  - file descriptor,
+ * @param len - number of bytes.
+ */
+static void reserve(int fd, size_t len) {
+    if (!output.registered) {
+        atexit(write_at_exit);
+        output.registered = true;
+    }
+
+    if (output.fd != fd || OUTPUT_SIZE - output.len < len) {
+        flush_output();
+        output.fd = fd;
+    }
+}
+
+/**@brief Finishes a reply.
+ * Counts a reply, writing out output if it completes the number of replies
+ * written out together.
+ */
+static void end_reply() {
+    output.replies++;
+
+    if (output.every != 0 && output.replies >= output.every) {
+        flush_output();
+    }
+}
+
+/**@brief Makes room for gathered reply.
+ * Makes room for @p len more signs of replies pointed by @p r.
+ * Terminates the program if memory could not be allocated.
+ * @param r   - pointer to gathered replies,
+ * @param len - number of signs.
+ */
+static void gather_room(replies_t *r, size_t len) {
+    if (r->cap - r->len >= len) {
+        return;
+    }
+
+    while (r->cap - r->len < len) {
+        r->cap = r->cap == 0 ? OUTPUT_SIZE : r->cap * 2;
+    }
+
+    r->text = realloc(r->text, r->cap);
+    if (r->text == NULL) {
+        exit(1);
+    }
+}
+
+/**@brief Stores reply.
+ * Stores reply @p text of @p len signs, meant for descriptor @p fd,
+ * as reply to line @p slot of the batch gathered in @p r, or writes it
+ * to the buffer if @p r is NULL.
+ * @param r     - pointer to gathered replies or NULL,
+ * @param slot  - index of the line in the batch,
+ * @param fd    - file descriptor,
+ * @param text  - text of the reply,
+ * @param len   - number of signs.
+ */
+static void reply(replies_t *r, uint32_t slot, int fd, const char *text,
+                  size_t len) {
+    if (r == NULL) {
+        reserve(fd, len);
+        memcpy(output.buf + output.len, text, len);
+        output.len += len;
+        end_reply();
+
+        return;
+    }
+
+    gather_room(r, len);
+    memcpy(r->text + r->len, text, len);
+    r->slots[slot] = (reply_t) {r, r->len, len, fd, false};
+    r->len += len;
+}
+
+/**@brief Encodes binary reply.
+ * Writes binary reply of kind @p kind with number @p value to @p out:
+ * byte @p kind followed by 64-bit little-endian number.
+ * @param out   - written reply,
+ * @param kind  - kind of the reply,
+ * @param value - number.
+ */
+static void encode_reply(char out[BINARY_REPLY], char kind, uint64_t value) {
+    int i;
+
+    out[0] = kind;
+    for (i = 0; i < 8; ++i) {
+        out[1 + i] = (char) (value >> (8 * i));
+    }
+}
+
+/**@brief Stores reply with a number.
+ * Stores reply consisting of text @p prefix and decimal number @p value
+ * in a separate line, meant for descriptor @p fd, as reply to line @p slot
+ * of the batch gathered in @p r, or writes it to the buffer if @p r is NULL.
+ * Binary reply of kind @p kind with the number is stored instead
+ * if replies are binary, always meant for standard output.
+ * @param r      - pointer to gathered replies or NULL,
+ * @param slot   - index of the line in the batch,
+ * @param fd     - file descriptor,
+ * @param prefix - text preceding the number,
+ * @param kind   - kind of binary reply,
+ * @param value  - number.
+ */
+static void reply_number(replies_t *r, uint32_t slot, int fd,
+                         const char *prefix, char kind, uint64_t value) {
+    char text[MAX_REPLY], *end = text + sizeof(text) - 1, *pos;
+    size_t len = strlen(prefix);
+
+    if (output.binary) {
+        encode_reply(text, kind, value);
+        reply(r, slot, STDOUT_FILENO, text, BINARY_REPLY);
+
+        return;
+    }
+
+    *end = '\n';
+    pos = format_number(end, value) - len;
+    memcpy(pos, prefix, len);
+
+    reply(r, slot, fd, pos, (size_t) (end + 1 - pos));
+}
+
+void set_flush_policy(uint64_t every, bool on_board) {
+    output.every = every;
+    output.on_board = on_board;
+}
+
+void set_binary_output(bool binary) {
+    output.binary = binary;
+}
+
+void output_value(replies_t *r, uint32_t slot, uint64_t value) {
+    reply_number(r, slot, STDOUT_FILENO, "", REPLY_VALUE, value);
+}
+
+void output_ok(replies_t *r, uint32_t slot, uint64_t line) {
+    reply_number(r, slot, STDOUT_FILENO, "OK ", REPLY_OK, line);
+}
+
+void output_error(replies_t *r, uint32_t slot, uint64_t line) {
+    reply_number(r, slot, STDERR_FILENO, "ERROR ", REPLY_ERROR, line);
+}
+
+/**@brief Finishes printed board.
+ * Counts printed board as a reply and writes out output if it is
+ * written out after every board.
+ */
+static void end_board() {
+    end_reply();
+
+    if (output.on_board) {
+        flush_output();
+    }
+}
+
+void output_board(replies_t *r, uint32_t slot, gamma_t *g) {
+    uint64_t size = gamma_board_size(g);
+    size_t header = output.binary ? BINARY_REPLY : 0;
+
+    if (r != NULL) {
+        if (size >= SIZE_MAX - header) {
+            exit(1);
+        }
+
+        gather_room(r, header + (size_t) size + 1);
+        if (output.binary) {
+            encode_reply(r->text + r->len, REPLY_BOARD, size);
+        }
+        if (!gamma_board_render(g, r->text + r->len + header,
+                                (size_t) size + 1)) {
+            exit(1);
+        }
+        r->slots[slot] = (reply_t) {r, r->len, header + (size_t) size,
+                                    STDOUT_FILENO, true};
+        r->len += header + size;
+
+        return;
+    }
+
+    // Binary board is preceded by its length.
+    reserve(STDOUT_FILENO, header);
+    if (output.binary) {
+        encode_reply(output.buf + output.len, REPLY_BOARD, size);
+        output.len += header;
+    }
+
+    // Boards that fit are gathered like other replies, larger ones
+    // are streamed after output gathered so far.
+    if (size < OUTPUT_SIZE - output.len) {
+        if (!gamma_board_render(g, output.buf + output.len,
+                                OUTPUT_SIZE - output.len)) {
+            exit(1);
+        }
+        output.len += size;
+    } else {
+        flush_output();
+        if (!gamma_board_write(g, STDOUT_FILENO)) {
+            exit(1);
+        }
+    }
+
+    end_board();
+}
+
+void write_replies(const reply_t *slots, uint32_t lines_num) {
+    uint32_t i;
+    const reply_t *cur;
+
+    for (i = 0; i < lines_num; ++i) {
+        cur = &slots[i];
+        if (cur->from == NULL) {
+            continue;
+        }
+
+        // Replies that do not fit in the buffer are written on their own.
+        reserve(cur->fd, cur->len <= OUTPUT_SIZE ? cur->len : 0);
+        if (cur->len <= OUTPUT_SIZE) {
+            memcpy(output.buf + output.len, cur->from->text + cur->start,
+                   cur->len);
+            output.len += cur->len;
+        } else {
+            flush_output();
+            if (!write_all(cur->fd, cur->from->text + cur->start, cur->len)) {
+                exit(1);
+            }
+        }
+
+        if (cur->board) {
+            end_board();
+        } else {
+            end_reply();
+        }
+    }
+}
@@ -0,0 +1,152 @@
+/**@file
+ * Interface of gamma game batch output writer.
+ *
+ * Replies and errors are gathered in one large buffer, together with
+ * the descriptor they are meant for, and written with a single system call
+ * when the buffer is full, when another descriptor is written to, when more
+ * input has to be waited for, or at the end of input. Since the buffer
+ * is written out whenever output switches between standard output
+ * and standard error, both of them keep the order of commands.
+ * Additionally the buffer can be written out after every given number
+ * of replies or after every printed board.
+ * Threads executing lines of a batch in parallel gather their replies
+ * apart and replies are written to the buffer in order of lines afterwards.
+ *
+ * @author Antoni Koszowski <a.koszowski@students.mimuw.edu.pl>
+ * @copyright
+ * @date 17.06.2020
+ */
+
+#ifndef GAMMA_GAMMA_OUTPUT_H
+#define GAMMA_GAMMA_OUTPUT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "gamma.h"
+
+/**
+ * Kind of binary reply with result of a command.
+ */
+#define REPLY_VALUE 'v'
+
+/**
+ * Kind of binary reply confirming a command.
+ */
+#define REPLY_OK 'o'
+
+/**
+ * Kind of binary reply reporting an error.
+ */
+#define REPLY_ERROR 'e'
+
+/**
+ * Kind of binary reply with printed board.
+ */
+#define REPLY_BOARD 'p'
+
+/**
+ * Structure gathering replies of one thread to lines of a batch, which are
+ * written out in order of lines once the whole batch is executed.
+ */
+typedef struct replies replies_t;
+
+/**
+ * Structure storing reply to a line of a batch.
+ */
+typedef struct reply {
+    const replies_t *from;  ///< replies gathering the reply, NULL if none
+    size_t start;           ///< position of text of the reply
+    size_t len;             ///< number of signs of the reply
+    int fd;                 ///< descriptor the reply is meant for
+    bool board;             ///< whether the reply is a printed board
+} reply_t;
+
+/**
+ * Structure gathering replies of one thread to lines of a batch.
+ */
+struct replies {
+    char *text;             ///< texts of replies
+    size_t len;             ///< number of gathered signs
+    size_t cap;             ///< number of allocated signs
+    reply_t *slots;         ///< replies to lines of the batch
+};
+
+/**@brief Sets up when output is written out.
+ * Sets up that buffered output is additionally written out after every
+ * @p every replies, unless it is zero, and after every printed board
+ * if @p on_board is set.
+ * @param every    - number of replies written out together or zero,
+ * @param on_board - whether output is written out after printed board.
+ */
+void set_flush_policy(uint64_t every, bool on_board);
+
+/**@brief Sets up binary replies.
+ * Sets up whether replies are binary, if @p binary is set, or text.
+ * Every binary reply is written to standard output as a byte of its kind
+ * followed by 64-bit little-endian number: result of command, number
+ * of command confirmed or number of erroneous command, or number of signs
+ * of printed board followed by its text.
+ * @param binary - whether replies are binary.
+ */
+void set_binary_output(bool binary);
+
+/**@brief Writes a number.
+ * Writes decimal number @p value in a separate line of standard output,
+ * as reply to line @p slot of the batch gathered in @p r, or directly
+ * to the buffer if @p r is NULL.
+ * @param r     - pointer to gathered replies or NULL,
+ * @param slot  - index of the line in the batch,
+ * @param value - written number.
+ */
+void output_value(replies_t *r, uint32_t slot, uint64_t value);
+
+/**@brief Confirms a command.
+ * Writes confirmation of correct command from line @p line
+ * to standard output, as reply to line @p slot of the batch gathered
+ * in @p r, or directly to the buffer if @p r is NULL.
+ * @param r     - pointer to gathered replies or NULL,
+ * @param slot  - index of the line in the batch,
+ * @param line  - number of the line.
+ */
+void output_ok(replies_t *r, uint32_t slot, uint64_t line);
+
+/**@brief Reports an error.
+ * Writes report of error in line @p line to standard error,
+ * as reply to line @p slot of the batch gathered in @p r, or directly
+ * to the buffer if @p r is NULL.
+ * @param r     - pointer to gathered replies or NULL,
+ * @param slot  - index of the line in the batch,
+ * @param line  - number of the line.
+ */
+void output_error(replies_t *r, uint32_t slot, uint64_t line);
+
+/**@brief Prints board.
+ * Writes string depicting the state of board in game pointed by @p g
+ * to standard output, as reply to line @p slot of the batch gathered
+ * in @p r, or directly if @p r is NULL. Boards written directly, which are
+ * too large for the buffer, are streamed after output buffered before them.
+ * Terminates the program if memory could not be allocated or output could
+ * not be written.
+ * @param r     - pointer to gathered replies or NULL,
+ * @param slot  - index of the line in the batch,
+ * @param g     - pointer to structure storing the state of game.
+ */
+void output_board(replies_t *r, uint32_t slot, gamma_t *g);
+
+/**@brief Writes replies to lines of a batch.
+ * Writes replies to @p lines_num lines of a batch, stored in @p slots,
+ * to the buffer in order of lines.
+ * Terminates the program if output could not be written.
+ * @param slots     - replies to lines of the batch,
+ * @param lines_num - number of lines of the batch.
+ */
+void write_replies(const reply_t *slots, uint32_t lines_num);
+
+/**@brief Writes out buffered output.
+ * Writes out output gathered in the buffer.
+ * Terminates the program if output could not be written.
+ */
+void flush_output();
+
+#endif //GAMMA_GAMMA_OUTPUT_H
@@ -6,155 +6,174 @@
  * @date 17.05.2020
  */
 
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
 #include "gamma_parser.h"
 #include "gamma_interactive.h"
+#include "gamma_output.h"
 #include "gamma.h"
 
 /**
- * Maximal number of considered parameters.
+ * Maximal number of moves executed at once.
  */
-#define MAX_PARAMS 4
+#define MOVES_BATCH 4096
 
 /**
- * Pointer to structure storing gamma game.
+ * Initial number of entries of table of sessions.
  */
-static gamma_t *gamma_game = NULL;
+#define SESSIONS_MIN 64
 
 /**
- * Number of currently parsed input line.
+ * Structure storing state of a single game played through batch input.
  */
-static uint64_t cur_line = 0;
+struct session {
+    bool tagged;                    ///< whether the game has a number
+    uint32_t game_id;               ///< number of the game
+    gamma_t *gamma_game;            ///< pointer to the game or NULL
+    gamma_move_record_t *pending_moves; ///< moves waiting for execution
+    bool *pending_results;          ///< results of moves waiting for execution
+    uint32_t *pending_slots;        ///< lines of the batch of waiting moves
+    replies_t *pending_replies;     ///< replies to lines of waiting moves
+    uint64_t pending_num;           ///< number of moves waiting for execution
+    uint64_t pending_cap;           ///< number of allocated waiting moves
+};
 
 /**
- * Array storing whitespaces ASCII representation.
+ * Session of game played through lines without number of game.
  */
-static const char *delim = " \t\v\r\f\n";
+static session_t untagged_session = {.tagged = false};
+
+/**
+ * Table of sessions of numbered games, addressed by their numbers.
+ */
+static session_t **sessions = NULL;
+
+/**
+ * Number of entries of table of sessions.
+ */
+static uint32_t sessions_cap = 0;
+
 /**
- * Array storing meaningful command signs.
+ * Number of sessions of numbered games.
  */
-static const char *proper_signs = "IBmgbfqp";
+static uint32_t sessions_num = 0;
 
 /**@brief Gives status of game.
- * Gives information whether game is active or not.
+ * Gives information whether game of session pointed by @p s
+ * is active or not.
+ * @param s - pointer to the session.
  * @return Value @p true if game is active, @p false otherwise.
  */
-static bool is_active() {
-    if (gamma_game != NULL) {
+static bool is_active(session_t *s) {
+    if (s->gamma_game != NULL) {
         return true;
     } else {
         return false;
     }
 }
 
-/**@brief Checks for comment line.
- * Gives information whether parsed @p input_line is a comment.
- * @param input_line - checked input line.
- * @return Value @p true if input line is a comment, @p false otherwise.
+/**@brief Executes waiting moves.
+ * Executes moves of session pointed by @p s waiting for execution
+ * and replies with their results.
+ * @param s - pointer to the session.
  */
-static bool comment_line(char *input_line) {
-    if (input_line[0] == '#') {
-        return true;
-    }
+static void flush_moves(session_t *s) {
+    uint64_t i;
 
-    return false;
-}
+    if (s->pending_num == 0) {
+        return;
+    }
 
-/**@brief Checks for empty line.
- * Gives information whether @p input_line is empty.
- * @param input_line - checked input line.
- * @return Value @p if input line is empty, @p false otherwise.
- */
-static bool empty_line(char *input_line) {
-    return input_line[0] == '\n';
-}
+    gamma_move_batch(s->gamma_game, s->pending_moves, s->pending_num,
+                     s->pending_results);
 
-/**@brief Checks for '\n' ending.
- * Gives information whether @p input_line has '\n' ending.
- * @param input_line  - checked input line.
- * @return Value @p true if input line has '\n' ending, @p false otherwise.
- */
-static bool endl_ending(char *input_line) {
-    size_t i = strlen(input_line) - 1;
+    for (i = 0; i < s->pending_num; ++i) {
+        output_value(s->pending_replies, s->pending_slots[i],
+                     s->pending_results[i]);
+    }
 
-    return input_line[i] == '\n';
+    s->pending_num = 0;
 }
 
-/**@brief Returns first sign of input line.
- * Returns first sign of @p input_line,
- * and gives information about its propriety.
- * @param input_line - input line which first sign is returned.
- * @return First sign of input line - if it is proper, 0 otherwise.
+/**@brief Makes room for waiting move.
+ * Makes room for one more move waiting for execution in session pointed
+ * by @p s, executing waiting moves if there are too many of them.
+ * Terminates the program if memory could not be allocated.
+ * @param s - pointer to the session.
  */
-static char get_first_sign(char *input_line) {
-    size_t i, len;
-    bool is_proper = false;
-
-    len = strlen(proper_signs);
-    for (i = 0; i < len && !is_proper; ++i) {
-        if (input_line[0] == proper_signs[i]) {
-            is_proper = true;
-        }
+static void reserve_move(session_t *s) {
+    if (s->pending_num == MOVES_BATCH) {
+        flush_moves(s);
     }
 
-    if (!is_proper || strlen(input_line) == 1) {
-        return 0;
+    if (s->pending_num < s->pending_cap) {
+        return;
     }
 
-    len = strlen(delim);
-    for (i = 0; i < len; ++i) {
-        if (input_line[1] == delim[i]) {
-            return input_line[0];
-        }
+    // Short games do not need room for a whole batch of moves.
+    s->pending_cap = s->pending_cap == 0 ? 16 : s->pending_cap * 2;
+    s->pending_moves = realloc(s->pending_moves,
+                               sizeof(gamma_move_record_t) * s->pending_cap);
+    s->pending_results = realloc(s->pending_results,
+                                 sizeof(bool) * s->pending_cap);
+    s->pending_slots = realloc(s->pending_slots,
+                               sizeof(uint32_t) * s->pending_cap);
+    if (s->pending_moves == NULL || s->pending_results == NULL ||
+        s->pending_slots == NULL) {
+        exit(1);
     }
-
-    return 0;
 }
 
-/**@brief Checks whether given signs are printable.
- * Checks whether @p token contains printable sign (ASCII 33 - 255).
- * @param token - array of signs.
- * @return Value @p true if there is some sign out of range,
- *         @p false otherwise.
+/**@brief Adds move to waiting moves.
+ * Adds move of player @p player_id on field (@p x, @p y) to moves
+ * of session pointed by @p s waiting for execution, executing them
+ * if there is no room for it. Result of the move is a reply to line
+ * @p slot of the batch gathered in @p r.
+ * @param s         - pointer to the session,
+ * @param r         - pointer to gathered replies or NULL,
+ * @param slot      - index of the line in the batch,
+ * @param player_id - player identifier,
+ * @param x         - number of column,
+ * @param y         - number of row.
  */
-static bool out_of_range(char *token) {
-    size_t i, len = strlen(token);
-
-    for (i = 0; i < len; ++i) {
-        if ((unsigned char) token[i] < '0' || (unsigned char) token[i] > '9') {
-            return true;
-        }
+static void add_move(session_t *s, replies_t *r, uint32_t slot,
+                     uint32_t player_id, uint32_t x, uint32_t y) {
+    // Waiting moves reply to lines of a single batch at once.
+    if (s->pending_num > 0 && s->pending_replies != r) {
+        flush_moves(s);
     }
 
-    return false;
+    reserve_move(s);
+
+    s->pending_moves[s->pending_num].player_id = player_id;
+    s->pending_moves[s->pending_num].x = x;
+    s->pending_moves[s->pending_num].y = y;
+    s->pending_moves[s->pending_num].kind = GAMMA_MOVE;
+    s->pending_slots[s->pending_num] = slot;
+    s->pending_replies = r;
+    s->pending_num++;
 }
 
-/**@brief Converts correct char parameters into unsigned integer.
- * If given @p token contains transformable parameter
- * it is converted into unsigned integer pointed by @p param.
- * otherwise gives information that it is illegal.
- * @param[in] token - array containing char parameter,
- * @param[in] param - pointer where value of converted chars is stored.
- * @return Value @p true if char parameter was converted properly,
- *         @p false otherwise.
+/**
+ * Structure describing origin of executed command.
  */
-static bool got_param(char *token, uint32_t *param) {
-    if (out_of_range(token) || token[0] == '-') {
-        return false;
-    }
-
-    char *ending;
-    uint64_t cur_num = strtoul(token, &ending, 10);
-
-    if (ending[0] == 0 && cur_num <= UINT32_MAX) {
-        *param = (uint32_t) cur_num;
-        return true;
-    }
-
-    return false;
+typedef struct origin {
+    replies_t *r;           ///< pointer to gathered replies or NULL
+    uint32_t slot;          ///< index of the line in the batch
+    uint64_t line;          ///< number of the line
+} origin_t;
+
+/**@brief Reports error in a line.
+ * Executes waiting moves of session pointed by @p s, so that outputs stay
+ * in order of input lines, and reports error in line of command
+ * originating from @p o.
+ * @param s - pointer to the session,
+ * @param o - pointer to origin of the command.
+ */
+static void print_error(session_t *s, const origin_t *o) {
+    flush_moves(s);
+    output_error(o->r, o->slot, o->line);
 }
 
 /**@brief Checks if first parameter is equal zero.
@@ -162,7 +181,7 @@ static bool got_param(char *token, uint32_t *param) {
  * @param params - array containing parameters/
  * @return  Value @p true if first parameter is zero, @p false otherwise.
  */
-static bool param_zero(uint32_t params[MAX_PARAMS]) {
+static bool param_zero(const uint32_t params[MAX_PARAMS]) {
     int i;
 
     for (i = 0; i < MAX_PARAMS; ++i) {
@@ -176,114 +195,388 @@ static bool param_zero(uint32_t params[MAX_PARAMS]) {
 
 /**@brief Activates choosen mode.
  * If given command is proper, basing on @p first_sign, @p params,
- * @p p_number and such action is possible appropriate mode is activated.
+ * @p p_number and such action is possible appropriate mode is activated
+ * in session pointed by @p s. Interactive mode can be activated only
+ * for game without number.
+ * @param s          - pointer to the session,
+ * @param o          - pointer to origin of the command,
  * @param first_sign - first sign parameter,
  * @param params     - next parameters,
  * @param p_number   - number of parameters.
  */
-static void choose_mode(char first_sign, uint32_t params[], uint32_t p_number) {
+static void choose_mode(session_t *s, const origin_t *o, char first_sign,
+                        const uint32_t params[], uint32_t p_number) {
     if (p_number != 4) {
-        fprintf(stderr, "ERROR %lu\n", cur_line);
+        print_error(s, o);
         return;
     } else if (param_zero(params)) {
-        fprintf(stderr, "ERROR %lu\n", cur_line);
+        print_error(s, o);
         return;
     }
 
-    if (first_sign == 'I') {
-        gamma_game = gamma_new(params[0], params[1], params[2], params[3]);
-        if (gamma_game == NULL) {
-            fprintf(stderr, "ERROR %lu\n", cur_line);
+    if (first_sign == 'I' && s->tagged) {
+        print_error(s, o);
+    } else if (first_sign == 'I') {
+        s->gamma_game = gamma_new(params[0], params[1], params[2], params[3]);
+        if (s->gamma_game == NULL) {
+            print_error(s, o);
         } else {
-            launch_interactive(gamma_game, params[0], params[1], params[2]);
+            // Interactive mode writes to the terminal on its own.
+            flush_output();
+            launch_interactive(s->gamma_game, params[0], params[1], params[2]);
         }
     } else if (first_sign == 'B') {
-        gamma_game = gamma_new(params[0], params[1], params[2], params[3]);
-        if (gamma_game == NULL) {
-            fprintf(stderr, "ERROR %lu\n", cur_line);
+        s->gamma_game = gamma_new(params[0], params[1], params[2], params[3]);
+        if (s->gamma_game == NULL) {
+            print_error(s, o);
         } else {
-            printf("OK %lu\n", cur_line);
+            output_ok(o->r, o->slot, o->line);
         }
     }
 }
 
 /**@brief Chooses command option.
  * Checks whether given command is appropriate, basing on information from
- * @p first_sign, @p params, @p p_number, if so it is executed.
+ * @p first_sign, @p params, @p p_number, if so it is executed
+ * in session pointed by @p s.
+ * @param s          - pointer to the session,
+ * @param o          - pointer to origin of the command,
  * @param first_sign - first sign parameter,
  * @param params     - next parameters,
  * @param p_number   - number of parameters.
  */
-static void
-choose_option(char first_sign, uint32_t params[], uint32_t p_number) {
-    if (!is_active()) {
-        choose_mode(first_sign, params, p_number);
+static void choose_option(session_t *s, const origin_t *o, char first_sign,
+                          const uint32_t params[], uint32_t p_number) {
+    if (!is_active(s)) {
+        choose_mode(s, o, first_sign, params, p_number);
+        return;
+    }
+
+    // Consecutive moves are executed together, before any other output.
+    if (first_sign == 'm' && p_number == 3) {
+        add_move(s, o->r, o->slot, params[0], params[1], params[2]);
+        return;
+    }
+
+    flush_moves(s);
+
+    gamma_t *g = s->gamma_game;
+
+    if (first_sign == 'g' && p_number == 3) {
+        output_value(o->r, o->slot,
+                     gamma_golden_move(g, params[0], params[1], params[2]));
+    } else if (first_sign == 'b' && p_number == 1) {
+        output_value(o->r, o->slot, gamma_busy_fields(g, params[0]));
+    } else if (first_sign == 'f' && p_number == 1) {
+        output_value(o->r, o->slot, gamma_free_fields(g, params[0]));
+    } else if (first_sign == 'q' && p_number == 1) {
+        output_value(o->r, o->slot, gamma_golden_possible(g, params[0]));
+    } else if (first_sign == 'p' && p_number == 0) {
+        output_board(o->r, o->slot, g);
+    } else if (first_sign == 'd' && p_number == 0) {
+        // Numbered game ends, its number can be used for a new one.
+        gamma_delete(g);
+        s->gamma_game = NULL;
+        output_ok(o->r, o->slot, o->line);
     } else {
-        if (first_sign == 'm' && p_number == 3) {
-            printf("%d\n",
-                   gamma_move(gamma_game, params[0], params[1], params[2]));
-        } else if (first_sign == 'g' && p_number == 3) {
-            printf("%d\n", gamma_golden_move(gamma_game, params[0], params[1],
-                                             params[2]));
-        } else if (first_sign == 'b' && p_number == 1) {
-            printf("%lu\n", gamma_busy_fields(gamma_game, params[0]));
-        } else if (first_sign == 'f' && p_number == 1) {
-            printf("%lu\n", gamma_free_fields(gamma_game, params[0]));
-        } else if (first_sign == 'q' && p_number == 1) {
-            printf("%d\n", gamma_golden_possible(gamma_game, params[0]));
-        } else if (first_sign == 'p' && p_number == 0) {
-            char *board = gamma_board(gamma_game);
-            if (board == NULL) {
-                exit(1);
-            } else {
-                printf("%s", board);
-                free(board);
-            }
-        } else {
-            fprintf(stderr, "ERROR %lu\n", cur_line);
+        print_error(s, o);
+    }
+}
+
+/**@brief Checks for whitespace.
+ * Gives information whether @p c is a whitespace separating parameters.
+ * @param c - checked sign.
+ * @return Value @p true if sign is a whitespace, @p false otherwise.
+ */
+static bool delimiter(char c) {
+    return c == ' ' || c == '\t' || c == '\v' || c == '\r' || c == '\f' ||
+           c == '\n';
+}
+
+/**@brief Checks for command sign.
+ * Gives information whether @p c is a meaningful command sign.
+ * @param c - checked sign.
+ * @return Value @p true if sign starts a command, @p false otherwise.
+ */
+static bool command_sign(char c) {
+    return c == 'I' || c == 'B' || c == 'm' || c == 'g' || c == 'b' ||
+           c == 'f' || c == 'q' || c == 'p';
+}
+
+/**@brief Converts decimal parameter into unsigned integer.
+ * Converts parameter starting at @p *pos, which consists only of digits
+ * and ends with a whitespace before @p end, into unsigned integer pointed
+ * by @p param, and moves @p *pos past it.
+ * @param[in,out] pos - pointer to position of parameter,
+ * @param[in] end     - end of the line,
+ * @param[out] param  - pointer where value of the parameter is stored.
+ * @return Value @p true if parameter was converted properly,
+ *         @p false otherwise.
+ */
+static bool read_param(const char **pos, const char *end, uint32_t *param) {
+    const char *c = *pos;
+    uint64_t value = 0;
+
+    // Value is checked before every digit, so it never overflows 64 bits.
+    while (c < end && *c == '0') {
+        c++;
+    }
+
+    for (; c < end && !delimiter(*c); ++c) {
+        if (*c < '0' || *c > '9' || value > UINT32_MAX) {
+            return false;
         }
+
+        value = value * 10 + (uint64_t) (*c - '0');
+    }
+
+    if (value > UINT32_MAX) {
+        return false;
     }
+
+    *param = (uint32_t) value;
+    *pos = c;
+
+    return true;
 }
 
-void parse_input(char *input_line) {
-    uint32_t p_number = 0, params[MAX_PARAMS];
-    char first_sign, *token;
+void parse_line(const char *line, size_t len, command_t *cmd) {
+    const char *pos = line + 1, *end = line + len;
 
-    cur_line++;
+    cmd->tagged = false;
+    cmd->game_id = 0;
+    cmd->params_num = 0;
 
     // Checking preconditions.
-    if (comment_line(input_line) || empty_line(input_line)) {
+    if (line[0] == '#' || line[0] == '\n') {
+        cmd->kind = LINE_SKIPPED;
         return;
     }
 
-    first_sign = get_first_sign(input_line);
-
-    if (!endl_ending(input_line)) {
-        fprintf(stderr, "ERROR %lu\n", cur_line);
+    cmd->kind = LINE_INVALID;
+    if (line[len - 1] != '\n') {
         return;
-    } else if (first_sign == 0) {
-        fprintf(stderr, "ERROR %lu\n", cur_line);
+    }
+
+    // Number of game is followed by a command, as in line without number.
+    if (line[0] == '@') {
+        if (*pos < '0' || *pos > '9' ||
+            !read_param(&pos, end, &cmd->game_id)) {
+            return;
+        }
+
+        // Number ends with a whitespace, since line ends with '\n'.
+        cmd->tagged = true;
+        while (*pos != '\n' && delimiter(*pos)) {
+            pos++;
+        }
+        if (*pos == '\n') {
+            return;
+        }
+
+        line = pos++;
+    }
+
+    if (!(command_sign(line[0]) || (cmd->tagged && line[0] == 'd')) ||
+        !delimiter(line[1])) {
         return;
     }
 
-    token = strtok(input_line, delim);
+    cmd->sign = line[0];
 
     // Checking parameters.
-    while ((token = strtok(0, delim))) {
-        if (p_number == 4) {
-            fprintf(stderr, "ERROR %lu\n", cur_line);
-            return;
+    while (true) {
+        while (pos < end && delimiter(*pos)) {
+            pos++;
         }
 
-        if (!(got_param(token, &params[p_number++]))) {
-            fprintf(stderr, "ERROR %lu\n", cur_line);
+        if (pos == end) {
+            break;
+        } else if (cmd->params_num == MAX_PARAMS) {
+            return;
+        } else if (!read_param(&pos, end, &cmd->params[cmd->params_num++])) {
             return;
         }
     }
 
-    choose_option(first_sign, params, p_number);
+    cmd->kind = LINE_COMMAND;
+}
+
+/**@brief Reads 32-bit number.
+ * Reads 32-bit little-endian number stored in bytes @p bytes.
+ * @param bytes - bytes of the number.
+ * @return Value of the number.
+ */
+static uint32_t read_number(const unsigned char *bytes) {
+    return (uint32_t) bytes[0] | (uint32_t) bytes[1] << 8 |
+           (uint32_t) bytes[2] << 16 | (uint32_t) bytes[3] << 24;
+}
+
+/**@brief Gives number of parameters of a command.
+ * Gives number of parameters of command @p sign, which may be 'd'
+ * only for numbered game, as indicated by @p tagged.
+ * @param sign   - command sign,
+ * @param tagged - whether command is meant for numbered game.
+ * @return Number of parameters or a bigger number than @ref MAX_PARAMS
+ * if there is no such command.
+ */
+static uint32_t command_params(char sign, bool tagged) {
+    if (sign == 'B') {
+        return 4;
+    } else if (sign == 'm' || sign == 'g') {
+        return 3;
+    } else if (sign == 'b' || sign == 'f' || sign == 'q') {
+        return 1;
+    } else if (sign == 'p' || (sign == 'd' && tagged)) {
+        return 0;
+    }
+
+    return MAX_PARAMS + 1;
+}
+
+void decode_record(const char *record, size_t len, command_t *cmd) {
+    const unsigned char *bytes = (const unsigned char *) record;
+    uint32_t i;
+
+    cmd->kind = LINE_INVALID;
+    cmd->tagged = false;
+    cmd->game_id = 0;
+    cmd->params_num = 0;
+
+    if (len != RECORD_SIZE || (bytes[1] & ~1u) != 0 || bytes[2] != 0 ||
+        bytes[3] != 0) {
+        return;
+    }
+
+    if (bytes[1] != 0) {
+        cmd->tagged = true;
+        cmd->game_id = read_number(bytes + 4);
+    }
+
+    cmd->sign = record[0];
+    cmd->params_num = command_params(cmd->sign, cmd->tagged);
+    if (cmd->params_num > MAX_PARAMS) {
+        cmd->params_num = 0;
+        return;
+    }
+
+    for (i = 0; i < MAX_PARAMS; ++i) {
+        cmd->params[i] = read_number(bytes + 8 + 4 * i);
+    }
+
+    cmd->kind = LINE_COMMAND;
+}
+
+/**@brief Gives position of session in the table.
+ * Gives index of entry of table of sessions, which holds session of game
+ * number @p game_id or is empty if there is no such session.
+ * @param game_id - number of the game.
+ * @return Index of the entry.
+ */
+static uint32_t session_entry(uint32_t game_id) {
+    uint32_t i = (uint32_t) (game_id * 2654435761u) & (sessions_cap - 1);
+
+    while (sessions[i] != NULL && sessions[i]->game_id != game_id) {
+        i = (i + 1) & (sessions_cap - 1);
+    }
+
+    return i;
 }
 
-void delete_game() {
-    gamma_delete(gamma_game);
+/**@brief Enlarges table of sessions.
+ * Doubles number of entries of table of sessions, moving sessions
+ * to their new entries.
+ * Terminates the program if memory could not be allocated.
+ */
+static void grow_sessions() {
+    session_t **old = sessions;
+    uint32_t i, old_cap = sessions_cap;
+
+    sessions_cap = old_cap == 0 ? SESSIONS_MIN : old_cap * 2;
+    sessions = calloc(sessions_cap, sizeof(session_t *));
+    if (sessions == NULL) {
+        exit(1);
+    }
+
+    for (i = 0; i < old_cap; ++i) {
+        if (old[i] != NULL) {
+            sessions[session_entry(old[i]->game_id)] = old[i];
+        }
+    }
+
+    free(old);
+}
+
+session_t *find_session(const command_t *cmd) {
+    uint32_t i;
+
+    if (!cmd->tagged) {
+        return &untagged_session;
+    }
+
+    // Table is kept at most half full.
+    if (2 * (sessions_num + 1) > sessions_cap) {
+        grow_sessions();
+    }
+
+    i = session_entry(cmd->game_id);
+    if (sessions[i] == NULL) {
+        sessions[i] = calloc(1, sizeof(session_t));
+        if (sessions[i] == NULL) {
+            exit(1);
+        }
+
+        sessions[i]->tagged = true;
+        sessions[i]->game_id = cmd->game_id;
+        sessions_num++;
+    }
+
+    return sessions[i];
+}
+
+void execute_command(session_t *s, const command_t *cmd, uint64_t line,
+                     replies_t *r, uint32_t slot) {
+    origin_t o = {r, slot, line};
+
+    if (cmd->kind == LINE_SKIPPED) {
+        return;
+    } else if (cmd->kind == LINE_INVALID) {
+        print_error(s, &o);
+        return;
+    }
+
+    choose_option(s, &o, cmd->sign, cmd->params, cmd->params_num);
+}
+
+void finish_session(session_t *s) {
+    flush_moves(s);
+}
+
+/**@brief Deletes a session.
+ * Executes moves waiting for execution in session pointed by @p s
+ * and deletes from memory its game and waiting moves.
+ * @param s - pointer to the session.
+ */
+static void delete_session(session_t *s) {
+    flush_moves(s);
+    gamma_delete(s->gamma_game);
+    free(s->pending_moves);
+    free(s->pending_results);
+    free(s->pending_slots);
+}
+
+void delete_sessions() {
+    uint32_t i;
+
+    delete_session(&untagged_session);
+
+    for (i = 0; i < sessions_cap; ++i) {
+        if (sessions[i] != NULL) {
+            delete_session(sessions[i]);
+            free(sessions[i]);
+        }
+    }
+
+    free(sessions);
+    flush_output();
 }
@@ -9,16 +9,115 @@
 #ifndef GAMMA_GAMMA_PARSER_H
 #define GAMMA_GAMMA_PARSER_H
 
-/**@brief Parses and interprets input.
- * Parses input lines and then interprets it.
- * In case that command was matched it is realized.
- * @param input_line - input line to be parsed.
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "gamma_output.h"
+
+/**
+ * Maximal number of considered parameters.
+ */
+#define MAX_PARAMS 4
+
+/**
+ * Number of bytes of a binary command record.
+ * A record consists of command sign, flags, whose lowest bit is set
+ * for numbered game and others are zero, two zero bytes, number of game
+ * and @ref MAX_PARAMS parameters, each of them a 32-bit little-endian
+ * number. Parameters not used by the command are ignored.
+ */
+#define RECORD_SIZE (8 + 4 * MAX_PARAMS)
+
+/**
+ * Kinds of input lines.
+ */
+typedef enum line_kind {
+    LINE_SKIPPED,   ///< comment or empty line
+    LINE_INVALID,   ///< line which is not a proper command
+    LINE_COMMAND    ///< command with its parameters
+} line_kind_t;
+
+/**
+ * Structure storing parsed input line.
+ * Line may start with '@' followed by number of game the command is meant
+ * for and a whitespace. Games with numbers are played apart from each
+ * other and from game played through lines without number, they start
+ * with command 'B' and end with command 'd'.
+ */
+typedef struct command {
+    line_kind_t kind;               ///< kind of the line
+    char sign;                      ///< first sign of the command
+    bool tagged;                    ///< whether line has number of game
+    uint32_t game_id;               ///< number of game or zero
+    uint32_t params_num;            ///< number of parameters
+    uint32_t params[MAX_PARAMS];    ///< parameters of the command
+} command_t;
+
+/**
+ * Structure storing state of a single game played through batch input.
+ */
+typedef struct session session_t;
+
+/**@brief Parses input line.
+ * Parses input line @p line of @p len signs, including its '\n' ending,
+ * and stores it in structure pointed by @p cmd. Parsing does not depend
+ * on state of the game, so lines can be parsed in any order
+ * and by many threads at once.
+ * @param line - input line to be parsed,
+ * @param len  - positive number of signs of the line,
+ * @param cmd  - pointer where parsed line is stored.
+ */
+void parse_line(const char *line, size_t len, command_t *cmd);
+
+/**@brief Decodes binary command record.
+ * Decodes command record @p record of @p len bytes and stores it
+ * in structure pointed by @p cmd, like a parsed line. Records of other
+ * size than @ref RECORD_SIZE are invalid, as well as interactive mode.
+ * @param record - decoded record,
+ * @param len    - positive number of bytes of the record,
+ * @param cmd    - pointer where decoded record is stored.
+ */
+void decode_record(const char *record, size_t len, command_t *cmd);
+
+/**@brief Gives session of a game.
+ * Gives session of game the line parsed into structure pointed by @p cmd
+ * is meant for, creating it if it does not exist yet. Sessions must not
+ * be looked for while commands are executed.
+ * Terminates the program if memory could not be allocated.
+ * @param cmd - pointer to parsed input line.
+ * @return Pointer to the session.
+ */
+session_t *find_session(const command_t *cmd);
+
+/**@brief Interprets parsed input line.
+ * Interprets input line number @p line, parsed into structure pointed
+ * by @p cmd, in session pointed by @p s. In case that command was matched
+ * it is realized, otherwise error with number of the line is reported.
+ * Replies to the line are gathered in @p r as replies to line @p slot
+ * of the batch, or written directly if @p r is NULL.
+ * Consecutive moves are executed together, as soon as another command
+ * or error follows them or the session is finished. Different sessions
+ * can execute commands at once in different threads.
+ * @param s    - pointer to the session,
+ * @param cmd  - pointer to parsed input line,
+ * @param line - number of the line,
+ * @param r    - pointer to gathered replies or NULL,
+ * @param slot - index of the line in the batch.
+ */
+void execute_command(session_t *s, const command_t *cmd, uint64_t line,
+                     replies_t *r, uint32_t slot);
+
+/**@brief Finishes commands of a session.
+ * Executes moves waiting for execution in session pointed by @p s,
+ * replying to their lines.
+ * @param s - pointer to the session.
  */
-void parse_input(char *input_line);
+void finish_session(session_t *s);
 
-/**@brief Deletes gamma game.
- * Deletes from memory structure storing gamma game.
+/**@brief Deletes all games.
+ * Executes moves waiting for execution, deletes from memory all sessions
+ * with their games and writes out buffered output.
  */
-void delete_game();
+void delete_sessions();
 
 #endif //GAMMA_GAMMA_PARSER_H
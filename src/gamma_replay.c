@@ -0,0 +1,796 @@
+/**@file
+ * Implementation of recording and replaying gamma games.
+ *
+ * @author Antoni Koszowski <a.koszowski@students.mimuw.edu.pl>
+ * @copyright
+ * @date 17.06.2020
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include "gamma_replay.h"
+
+/**
+ * Signs starting replay file.
+ */
+#define REPLAY_MAGIC "GMRP"
+
+/**
+ * Signs ending replay file, after offset of index.
+ */
+#define INDEX_MAGIC "GMRI"
+
+/**
+ * Number of signs of both magic strings.
+ */
+#define MAGIC_SIZE 4
+
+/**
+ * Version of format of replay file.
+ */
+#define REPLAY_VERSION 2
+
+/**
+ * Number of bytes of offset of index, written at the end of file.
+ */
+#define OFFSET_SIZE 8
+
+/**
+ * Tag of record starting a checkpoint. Tags of moves are greater than
+ * other tags.
+ */
+#define TAG_CHECKPOINT 0
+
+/**
+ * Tag of record ending recorded moves.
+ */
+#define TAG_END 1
+
+/**
+ * Tag of record storing players out of game, written before an attempted
+ * move if statuses in game were refreshed since the previous record.
+ */
+#define TAG_STATUS 2
+
+/**
+ * Base of tags of moves. Standard move of a player is tagged with the base
+ * plus twice his identifier, and golden move with one more.
+ */
+#define TAG_MOVE 1
+
+/**
+ * Structure representing a checkpoint in index.
+ */
+typedef struct checkpoint {
+    uint64_t move;          ///< number of moves before the checkpoint
+    uint64_t offset;        ///< offset of the checkpoint from start of file
+} checkpoint_t;
+
+/**
+ * Structure recording moves of a game.
+ */
+struct recorder {
+    gamma_t *g;             ///< pointer to the recorded game
+    FILE *f;                ///< file written to
+    bool failed;            ///< whether writing to the file failed
+    uint32_t width;         ///< width of the board
+    uint32_t height;        ///< height of the board
+    uint32_t players_num;   ///< number of players
+    uint32_t every;         ///< number of moves between checkpoints
+    uint64_t written;       ///< number of bytes written
+    uint64_t moves;         ///< number of recorded moves
+    uint64_t last_field;    ///< index of field of the previous move
+    uint32_t *owners;       ///< scratch space for owners of fields
+    bool *golden_used;      ///< scratch space for golden moves used
+    bool *in_game;          ///< scratch space for statuses in game
+    uint64_t status_version; ///< version of statuses in game last written
+    checkpoint_t *index;    ///< array of written checkpoints
+    uint64_t index_num;     ///< number of written checkpoints
+    uint64_t index_cap;     ///< capacity of the array of checkpoints
+};
+
+/**
+ * Structure reading recorded game.
+ */
+struct replay {
+    FILE *f;                ///< file read from
+    off_t base;             ///< position of start of recording in the file
+    uint32_t width;         ///< width of the board
+    uint32_t height;        ///< height of the board
+    uint32_t players_num;   ///< number of players
+    uint32_t areas;         ///< maximal number of areas of a player
+    uint64_t moves;         ///< number of recorded moves
+    checkpoint_t *index;    ///< array of checkpoints
+    uint64_t index_num;     ///< number of checkpoints
+};
+
+/**@brief Writes a byte.
+ * Writes byte @p c to file of recording pointed by @p r, marking
+ * the recording as failed if it was not written.
+ * @param[in,out] r       – pointer to the recording structure,
+ * @param[in] c           – the byte.
+ */
+static void put_byte(recorder_t *r, unsigned char c) {
+    if (putc(c, r->f) == EOF) {
+        r->failed = true;
+    }
+
+    r->written++;
+}
+
+/**@brief Writes magic string.
+ * Writes @ref MAGIC_SIZE signs of @p magic to file of recording pointed
+ * by @p r.
+ * @param[in,out] r       – pointer to the recording structure,
+ * @param[in] magic       – signs to be written.
+ */
+static void put_magic(recorder_t *r, const char *magic) {
+    uint32_t i;
+
+    for (i = 0; i < MAGIC_SIZE; ++i) {
+        put_byte(r, (unsigned char) magic[i]);
+    }
+}
+
+/**@brief Writes a number.
+ * Writes number @p value to file of recording pointed by @p r, seven bits
+ * per byte, starting from the lowest ones. The highest bit of byte is set
+ * if more bytes follow.
+ * @param[in,out] r       – pointer to the recording structure,
+ * @param[in] value       – the number.
+ */
+static void put_number(recorder_t *r, uint64_t value) {
+    while (value >= 0x80) {
+        put_byte(r, (unsigned char) (value | 0x80));
+        value >>= 7;
+    }
+
+    put_byte(r, (unsigned char) value);
+}
+
+/**@brief Reads a number.
+ * Reads number written like by @ref put_number from file @p f.
+ * @param[in,out] f       – the file,
+ * @param[out] value      – pointer to the number.
+ * @return Value @p true if the number was read, @p false if the file ended
+ * or the number does not fit in 64 bits.
+ */
+static bool get_number(FILE *f, uint64_t *value) {
+    uint64_t result = 0;
+    unsigned shift = 0;
+    int c;
+
+    do {
+        c = getc(f);
+        if (c == EOF || shift > 63 || (shift == 63 && (c & 0x7e) != 0)) {
+            return false;
+        }
+
+        result |= (uint64_t) (c & 0x7f) << shift;
+        shift += 7;
+    } while (c & 0x80);
+
+    *value = result;
+
+    return true;
+}
+
+/**@brief Reads a 32-bit number.
+ * Reads number written like by @ref put_number from file @p f, which
+ * has to fit in 32 bits.
+ * @param[in,out] f       – the file,
+ * @param[out] value      – pointer to the number.
+ * @return Value @p true if the number was read, @p false otherwise.
+ */
+static bool get_number32(FILE *f, uint32_t *value) {
+    uint64_t result;
+
+    if (!get_number(f, &result) || result > UINT32_MAX) {
+        return false;
+    }
+
+    *value = (uint32_t) result;
+
+    return true;
+}
+
+/**@brief Encodes difference of fields.
+ * Gives difference between field indices @p f and @p prev, as a number
+ * which is small when the difference is small in either direction.
+ * @param[in] f           – index of the field,
+ * @param[in] prev        – index of the previous field.
+ * @return Encoded difference.
+ */
+static uint64_t encode_delta(uint64_t f, uint64_t prev) {
+    uint64_t delta = f - prev;
+
+    return (delta << 1) ^ (0 - (delta >> 63));
+}
+
+/**@brief Decodes difference of fields.
+ * Gives index of field, which difference from @p prev was encoded
+ * by @ref encode_delta as @p code.
+ * @param[in] code        – encoded difference,
+ * @param[in] prev        – index of the previous field.
+ * @return Index of the field.
+ */
+static uint64_t decode_delta(uint64_t code, uint64_t prev) {
+    return prev + ((code >> 1) ^ (0 - (code & 1)));
+}
+
+/**@brief Writes players with a flag.
+ * Writes number of players whose flag in @p flags equals @p value,
+ * followed by these players, each as difference from the previous one,
+ * to file of recording pointed by @p r.
+ * @param[in,out] r       – pointer to the recording structure,
+ * @param[in] flags       – array of flags of players,
+ * @param[in] value       – value of flag of written players.
+ */
+static void put_players(recorder_t *r, const bool *flags, bool value) {
+    uint32_t player_id, prev_id = 0;
+    uint64_t players_num = 0;
+
+    for (player_id = 1; player_id <= r->players_num; ++player_id) {
+        players_num += flags[player_id - 1] == value;
+    }
+
+    put_number(r, players_num);
+    for (player_id = 1; player_id <= r->players_num; ++player_id) {
+        if (flags[player_id - 1] == value) {
+            put_number(r, player_id - prev_id);
+            prev_id = player_id;
+        }
+    }
+}
+
+/**@brief Writes a checkpoint.
+ * Writes state of recorded game as a checkpoint and adds it to index
+ * of recording pointed by @p r. Owners of fields are written as pairs
+ * of length of run of equal owners and the owner, followed by players
+ * who used golden move and players out of game.
+ * Terminates the program if memory could not be allocated.
+ * @param[in,out] r       – pointer to the recording structure.
+ */
+static void write_checkpoint(recorder_t *r) {
+    uint64_t i, run;
+    uint64_t fields = (uint64_t) r->width * r->height;
+    checkpoint_t *index;
+
+    if (r->index_num == r->index_cap) {
+        r->index_cap = r->index_cap == 0 ? 16 : 2 * r->index_cap;
+        index = realloc(r->index, sizeof(checkpoint_t) * r->index_cap);
+        if (index == NULL) {
+            exit(1);
+        }
+
+        r->index = index;
+    }
+
+    r->index[r->index_num].move = r->moves;
+    r->index[r->index_num].offset = r->written;
+    r->index_num++;
+
+    gamma_state(r->g, r->owners, r->golden_used, r->in_game);
+    r->status_version = gamma_status_version(r->g);
+
+    put_number(r, TAG_CHECKPOINT);
+    for (i = 0; i < fields; i += run) {
+        run = 1;
+        while (i + run < fields && r->owners[i + run] == r->owners[i]) {
+            ++run;
+        }
+
+        put_number(r, run);
+        put_number(r, r->owners[i]);
+    }
+
+    put_players(r, r->golden_used, true);
+    put_players(r, r->in_game, false);
+
+    r->last_field = 0;
+}
+
+recorder_t *gamma_record_start(gamma_t *g, FILE *f, uint32_t checkpoint_every) {
+    uint32_t width, height, players_num, areas;
+    recorder_t *r;
+
+    if (f == NULL || !gamma_params(g, &width, &height, &players_num, &areas)) {
+        return NULL;
+    }
+
+    r = calloc(1, sizeof(recorder_t));
+    if (r == NULL) {
+        return NULL;
+    }
+
+    r->g = g;
+    r->f = f;
+    r->width = width;
+    r->height = height;
+    r->players_num = players_num;
+    r->every = checkpoint_every;
+    r->owners = malloc(sizeof(uint32_t) * (size_t) width * height);
+    r->golden_used = malloc(sizeof(bool) * players_num);
+    r->in_game = malloc(sizeof(bool) * players_num);
+    if (r->owners == NULL || r->golden_used == NULL || r->in_game == NULL) {
+        free(r->owners);
+        free(r->golden_used);
+        free(r->in_game);
+        free(r);
+
+        return NULL;
+    }
+
+    put_magic(r, REPLAY_MAGIC);
+    put_number(r, REPLAY_VERSION);
+    put_number(r, width);
+    put_number(r, height);
+    put_number(r, players_num);
+    put_number(r, areas);
+    put_number(r, checkpoint_every);
+
+    write_checkpoint(r);
+
+    if (r->failed) {
+        free(r->owners);
+        free(r->golden_used);
+        free(r->in_game);
+        free(r->index);
+        free(r);
+
+        return NULL;
+    }
+
+    return r;
+}
+
+/**@brief Writes statuses in game if they changed.
+ * Writes players out of game in recorded game, if statuses in game were
+ * refreshed since they were last written to file of recording pointed
+ * by @p r, for example by a query or a move which was not executed.
+ * @param[in,out] r       – pointer to the recording structure.
+ */
+static void write_statuses(recorder_t *r) {
+    if (gamma_status_version(r->g) == r->status_version) {
+        return;
+    }
+
+    gamma_statuses(r->g, r->in_game);
+    put_number(r, TAG_STATUS);
+    put_players(r, r->in_game, false);
+    r->status_version = gamma_status_version(r->g);
+}
+
+/**@brief Records executed move.
+ * Records move of player @p player on field (@p x, @p y), golden if
+ * @p golden is set, and writes a checkpoint if it is due.
+ * @param[in,out] r       – pointer to the recording structure,
+ * @param[in] player      – player identifier,
+ * @param[in] x           – column number,
+ * @param[in] y           – row number,
+ * @param[in] golden      – whether the move was golden.
+ */
+static void record_move(recorder_t *r, uint32_t player, uint32_t x,
+                        uint32_t y, bool golden) {
+    uint64_t f = (uint64_t) y * r->width + x;
+
+    put_number(r, TAG_MOVE + 2 * (uint64_t) player + golden);
+    put_number(r, encode_delta(f, r->last_field));
+    r->last_field = f;
+    r->moves++;
+
+    // Statuses refreshed by the move itself are refreshed again by replay.
+    r->status_version = gamma_status_version(r->g);
+
+    if (r->every != 0 && r->moves % r->every == 0) {
+        write_checkpoint(r);
+    }
+}
+
+bool gamma_record_move(recorder_t *r, uint32_t player, uint32_t x, uint32_t y) {
+    if (r == NULL) {
+        return false;
+    }
+
+    write_statuses(r);
+    if (!gamma_move(r->g, player, x, y)) {
+        return false;
+    }
+
+    record_move(r, player, x, y, false);
+
+    return true;
+}
+
+bool gamma_record_golden_move(recorder_t *r, uint32_t player,
+                              uint32_t x, uint32_t y) {
+    if (r == NULL) {
+        return false;
+    }
+
+    write_statuses(r);
+    if (!gamma_golden_move(r->g, player, x, y)) {
+        return false;
+    }
+
+    record_move(r, player, x, y, true);
+
+    return true;
+}
+
+bool gamma_record_finish(recorder_t *r) {
+    uint64_t i, index_offset, prev_move = 0, prev_offset = 0;
+    bool written;
+
+    if (r == NULL) {
+        return false;
+    }
+
+    write_statuses(r);
+    put_number(r, TAG_END);
+
+    index_offset = r->written;
+    put_number(r, r->moves);
+    put_number(r, r->index_num);
+    for (i = 0; i < r->index_num; ++i) {
+        put_number(r, r->index[i].move - prev_move);
+        put_number(r, r->index[i].offset - prev_offset);
+        prev_move = r->index[i].move;
+        prev_offset = r->index[i].offset;
+    }
+
+    for (i = 0; i < OFFSET_SIZE; ++i) {
+        put_byte(r, (unsigned char) (index_offset >> (8 * i)));
+    }
+
+    put_magic(r, INDEX_MAGIC);
+
+    written = !r->failed && fflush(r->f) == 0;
+
+    free(r->owners);
+    free(r->golden_used);
+    free(r->in_game);
+    free(r->index);
+    free(r);
+
+    return written;
+}
+
+/**@brief Reads magic string.
+ * Reads @ref MAGIC_SIZE signs from file @p f and compares them with
+ * @p magic.
+ * @param[in,out] f       – the file,
+ * @param[in] magic       – expected signs.
+ * @return Value @p true if the signs were read and are equal to @p magic,
+ * @p false otherwise.
+ */
+static bool get_magic(FILE *f, const char *magic) {
+    char signs[MAGIC_SIZE];
+
+    return fread(signs, 1, MAGIC_SIZE, f) == MAGIC_SIZE &&
+           memcmp(signs, magic, MAGIC_SIZE) == 0;
+}
+
+/**@brief Reads index of checkpoints.
+ * Reads offset of index from the end of file of replay pointed by @p r,
+ * and then the index. Checkpoints have to be in order of moves and
+ * offsets, and the first one has to precede all moves.
+ * @param[in,out] r       – pointer to the reading structure.
+ * @return Value @p true if correct index was read, @p false otherwise.
+ */
+static bool read_index(replay_t *r) {
+    unsigned char bytes[OFFSET_SIZE];
+    uint64_t i, index_offset = 0, move, offset;
+
+    if (fseeko(r->f, -(off_t) (OFFSET_SIZE + MAGIC_SIZE), SEEK_END) != 0 ||
+        fread(bytes, 1, OFFSET_SIZE, r->f) != OFFSET_SIZE ||
+        !get_magic(r->f, INDEX_MAGIC)) {
+        return false;
+    }
+
+    for (i = 0; i < OFFSET_SIZE; ++i) {
+        index_offset |= (uint64_t) bytes[i] << (8 * i);
+    }
+
+    if (index_offset > INT64_MAX - (uint64_t) r->base ||
+        fseeko(r->f, r->base + (off_t) index_offset, SEEK_SET) != 0 ||
+        !get_number(r->f, &r->moves) || !get_number(r->f, &r->index_num) ||
+        r->index_num == 0 || r->index_num > index_offset ||
+        r->index_num - 1 > r->moves) {
+        return false;
+    }
+
+    r->index = malloc(sizeof(checkpoint_t) * r->index_num);
+    if (r->index == NULL) {
+        return false;
+    }
+
+    for (i = 0; i < r->index_num; ++i) {
+        if (!get_number(r->f, &move) || !get_number(r->f, &offset)) {
+            return false;
+        }
+
+        if (i == 0) {
+            if (move != 0) {
+                return false;
+            }
+
+            r->index[i].move = move;
+            r->index[i].offset = offset;
+        } else {
+            if (move == 0 || offset == 0 ||
+                move > r->moves - r->index[i - 1].move ||
+                offset >= index_offset - r->index[i - 1].offset) {
+                return false;
+            }
+
+            r->index[i].move = r->index[i - 1].move + move;
+            r->index[i].offset = r->index[i - 1].offset + offset;
+        }
+    }
+
+    return r->index[0].offset < index_offset;
+}
+
+replay_t *gamma_replay_open(FILE *f) {
+    uint32_t version, every;
+    replay_t *r;
+
+    if (f == NULL) {
+        return NULL;
+    }
+
+    r = calloc(1, sizeof(replay_t));
+    if (r == NULL) {
+        return NULL;
+    }
+
+    r->f = f;
+    r->base = ftello(f);
+
+    if (r->base < 0 || !get_magic(f, REPLAY_MAGIC) ||
+        !get_number32(f, &version) || version != REPLAY_VERSION ||
+        !get_number32(f, &r->width) || !get_number32(f, &r->height) ||
+        !get_number32(f, &r->players_num) || !get_number32(f, &r->areas) ||
+        !get_number32(f, &every) || !read_index(r)) {
+        gamma_replay_close(r);
+
+        return NULL;
+    }
+
+    return r;
+}
+
+uint64_t gamma_replay_length(replay_t *r) {
+    return r == NULL ? 0 : r->moves;
+}
+
+/**@brief Finds the nearest checkpoint.
+ * Finds the last checkpoint in index of replay pointed by @p r,
+ * which is not later than move @p n.
+ * @param[in] r           – pointer to the reading structure,
+ * @param[in] n           – number of moves.
+ * @return Pointer to the checkpoint.
+ */
+static checkpoint_t *find_checkpoint(replay_t *r, uint64_t n) {
+    uint64_t low = 0, high = r->index_num - 1, mid;
+
+    while (low < high) {
+        mid = low + (high - low + 1) / 2;
+        if (r->index[mid].move <= n) {
+            low = mid;
+        } else {
+            high = mid - 1;
+        }
+    }
+
+    return &r->index[low];
+}
+
+/**@brief Reads owners of fields of a checkpoint.
+ * Reads runs of owners of fields written by @ref write_checkpoint
+ * from file of replay pointed by @p r into array @p owners.
+ * @param[in,out] r       – pointer to the reading structure,
+ * @param[out] owners     – array of owners of fields.
+ * @return Value @p true if owners of all fields were read, @p false
+ * otherwise.
+ */
+static bool read_owners(replay_t *r, uint32_t *owners) {
+    uint64_t i, j, run, owner, fields = (uint64_t) r->width * r->height;
+
+    for (i = 0; i < fields; i += run) {
+        if (!get_number(r->f, &run) || !get_number(r->f, &owner) ||
+            run == 0 || run > fields - i || owner > r->players_num) {
+            return false;
+        }
+
+        for (j = i; j < i + run; ++j) {
+            owners[j] = (uint32_t) owner;
+        }
+    }
+
+    return true;
+}
+
+/**@brief Reads players with a flag.
+ * Reads players written by @ref put_players from file of replay pointed
+ * by @p r, and sets their flags in @p flags to @p value.
+ * @param[in,out] r       – pointer to the reading structure,
+ * @param[out] flags      – array of flags of players, set up beforehand
+ *                          to the opposite value,
+ * @param[in] value       – value of flag of read players.
+ * @return Value @p true if the players were read, @p false otherwise.
+ */
+static bool read_players(replay_t *r, bool *flags, bool value) {
+    uint64_t i, players_num, delta, player_id = 0;
+
+    if (!get_number(r->f, &players_num) || players_num > r->players_num) {
+        return false;
+    }
+
+    for (i = 0; i < players_num; ++i) {
+        if (!get_number(r->f, &delta) || delta == 0 ||
+            delta > r->players_num - player_id) {
+            return false;
+        }
+
+        player_id += delta;
+        flags[player_id - 1] = value;
+    }
+
+    return true;
+}
+
+/**@brief Reads a checkpoint.
+ * Reads checkpoint written by @ref write_checkpoint from current position
+ * in file of replay pointed by @p r and creates game in its state.
+ * @param[in,out] r       – pointer to the reading structure.
+ * @return Pointer to the created game or NULL if memory was not allocated
+ * or the checkpoint is not correct.
+ */
+static gamma_t *read_checkpoint(replay_t *r) {
+    uint64_t tag, fields = (uint64_t) r->width * r->height;
+    uint32_t *owners, player_id;
+    bool *golden_used, *in_game;
+    gamma_t *g = NULL;
+
+    if (!get_number(r->f, &tag) || tag != TAG_CHECKPOINT ||
+        fields > SIZE_MAX / sizeof(uint32_t)) {
+        return NULL;
+    }
+
+    owners = malloc(sizeof(uint32_t) * fields);
+    golden_used = calloc(r->players_num, sizeof(bool));
+    in_game = malloc(sizeof(bool) * r->players_num);
+
+    for (player_id = 0; in_game != NULL && player_id < r->players_num;
+         ++player_id) {
+        in_game[player_id] = true;
+    }
+
+    if (owners != NULL && golden_used != NULL && in_game != NULL &&
+        read_owners(r, owners) && read_players(r, golden_used, true) &&
+        read_players(r, in_game, false)) {
+        g = gamma_restore(r->width, r->height, r->players_num, r->areas,
+                          owners, golden_used, in_game);
+    }
+
+    free(owners);
+    free(golden_used);
+    free(in_game);
+
+    return g;
+}
+
+/**@brief Reads statuses in game.
+ * Reads players out of game written by @ref write_statuses from current
+ * position in file of replay pointed by @p r, and sets up statuses in game
+ * pointed by @p g accordingly.
+ * @param[in,out] r       – pointer to the reading structure,
+ * @param[in,out] g       – pointer to the replayed game.
+ * @return Value @p true if statuses were read, @p false if memory was not
+ * allocated or the record is not correct.
+ */
+static bool read_statuses(replay_t *r, gamma_t *g) {
+    uint32_t player_id;
+    bool read;
+    bool *in_game = malloc(sizeof(bool) * r->players_num);
+
+    if (in_game == NULL) {
+        return false;
+    }
+
+    for (player_id = 0; player_id < r->players_num; ++player_id) {
+        in_game[player_id] = true;
+    }
+
+    read = read_players(r, in_game, false) && gamma_set_statuses(g, in_game);
+    free(in_game);
+
+    return read;
+}
+
+gamma_t *gamma_replay_seek(replay_t *r, uint64_t n) {
+    uint64_t i, tag, code, f, prev = 0;
+    uint64_t fields;
+    checkpoint_t *c;
+    uint32_t player;
+    bool read, executed;
+    gamma_t *g;
+
+    if (r == NULL || n > r->moves) {
+        return NULL;
+    }
+
+    c = find_checkpoint(r, n);
+    if (c->offset > INT64_MAX - (uint64_t) r->base ||
+        fseeko(r->f, r->base + (off_t) c->offset, SEEK_SET) != 0) {
+        return NULL;
+    }
+
+    g = read_checkpoint(r);
+    if (g == NULL) {
+        return NULL;
+    }
+
+    fields = (uint64_t) r->width * r->height;
+    for (i = c->move; i < n; ++i) {
+        read = get_number(r->f, &tag);
+        while (read && tag == TAG_STATUS) {
+            read = read_statuses(r, g) && get_number(r->f, &tag);
+        }
+
+        if (!read || tag < TAG_MOVE + 2 || (tag - TAG_MOVE) / 2 > r->players_num ||
+            !get_number(r->f, &code)) {
+            gamma_delete(g);
+
+            return NULL;
+        }
+
+        f = decode_delta(code, prev);
+        prev = f;
+        player = (uint32_t) ((tag - TAG_MOVE) / 2);
+
+        if (f >= fields) {
+            executed = false;
+        } else if ((tag - TAG_MOVE) % 2 == 1) {
+            executed = gamma_golden_move(g, player, (uint32_t) (f % r->width),
+                                         (uint32_t) (f / r->width));
+        } else {
+            executed = gamma_move(g, player, (uint32_t) (f % r->width),
+                                  (uint32_t) (f / r->width));
+        }
+
+        if (!executed) {
+            gamma_delete(g);
+
+            return NULL;
+        }
+    }
+
+    // Statuses refreshed after the last move are written before the next.
+    read = true;
+    while (read && get_number(r->f, &tag) && tag == TAG_STATUS) {
+        read = read_statuses(r, g);
+    }
+
+    if (!read) {
+        gamma_delete(g);
+
+        return NULL;
+    }
+
+    return g;
+}
+
+void gamma_replay_close(replay_t *r) {
+    if (r == NULL) {
+        return;
+    }
+
+    free(r->index);
+    free(r);
+}
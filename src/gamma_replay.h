@@ -0,0 +1,125 @@
+/**@file
+ * Interface of recording and replaying gamma games.
+ *
+ * Replay file starts with header holding parameters of the game, followed
+ * by records of moves and checkpoints, and ends with index of checkpoints.
+ * Numbers are written as variable-length integers, seven bits per byte.
+ * A move is written as player identifier with mark of golden move,
+ * and difference between indices of its field and field of the previous
+ * move. A checkpoint, written every given number of moves, stores whole
+ * state of game, with owners of fields compressed as runs of equal owners,
+ * players who used golden move and players out of game. Status in game is
+ * refreshed also by queries and moves which were not executed, so players
+ * out of game are written again before an attempted move whenever
+ * it changed.
+ * Moving to any move of the game loads the nearest preceding checkpoint
+ * and replays only the moves after it, executing them like the recorded
+ * game, so the resulting state is exactly the same.
+ *
+ * @author Antoni Koszowski <a.koszowski@students.mimuw.edu.pl>
+ * @copyright
+ * @date 17.06.2020
+ */
+
+#ifndef GAMMA_REPLAY_H
+#define GAMMA_REPLAY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "gamma.h"
+
+/**
+ * Structure recording moves of a game.
+ */
+typedef struct recorder recorder_t;
+
+/**
+ * Structure reading recorded game.
+ */
+typedef struct replay replay_t;
+
+/** @brief Starts recording of game.
+ * Allocates memory for a new structure recording moves of game pointed
+ * by @p g into file @p f, from its current position, and writes header
+ * and checkpoint of current state of game. Checkpoint is written after
+ * every @p checkpoint_every moves, or only at the start if it is zero.
+ * @param[in] g                – pointer to structure storing the state
+ *                               of game,
+ * @param[in,out] f            – file opened for writing,
+ * @param[in] checkpoint_every – number of moves between checkpoints.
+ * @return Pointer to the created structure or NULL if memory was not
+ * allocated, one of the pointers is NULL or header could not be written.
+ */
+recorder_t *gamma_record_start(gamma_t *g, FILE *f, uint32_t checkpoint_every);
+
+/** @brief Executes and records a move.
+ * Executes move like @ref gamma_move in recorded game, and records
+ * it if it was executed.
+ * @param[in,out] r       – pointer to the recording structure,
+ * @param[in] player      – player identifier,
+ * @param[in] x           – column number,
+ * @param[in] y           – row number.
+ * @return Value @p true if the move was executed, @p false otherwise.
+ */
+bool gamma_record_move(recorder_t *r, uint32_t player, uint32_t x, uint32_t y);
+
+/** @brief Executes and records a golden move.
+ * Executes move like @ref gamma_golden_move in recorded game, and records
+ * it if it was executed.
+ * @param[in,out] r       – pointer to the recording structure,
+ * @param[in] player      – player identifier,
+ * @param[in] x           – column number,
+ * @param[in] y           – row number.
+ * @return Value @p true if the move was executed, @p false otherwise.
+ */
+bool gamma_record_golden_move(recorder_t *r, uint32_t player,
+                              uint32_t x, uint32_t y);
+
+/** @brief Finishes recording of game.
+ * Writes end of recorded moves and index of checkpoints, and deletes
+ * the recording structure from memory. File and game are not closed.
+ * Nothing happens if the pointer's value is NULL.
+ * @param[in] r           – pointer to the recording structure.
+ * @return Value @p true if the whole recording was written, @p false
+ * if writing failed at some point or the pointer is NULL.
+ */
+bool gamma_record_finish(recorder_t *r);
+
+/** @brief Opens recorded game.
+ * Allocates memory for a new structure reading game recorded in file
+ * @p f, starting at its current position, and reads its header and index.
+ * @param[in,out] f       – file opened for reading, which can be positioned.
+ * @return Pointer to the created structure or NULL if memory was not
+ * allocated or file does not contain correct recording.
+ */
+replay_t *gamma_replay_open(FILE *f);
+
+/** @brief Gives number of recorded moves.
+ * @param[in] r           – pointer to the reading structure.
+ * @return Number of moves recorded in the file, or zero if the pointer
+ * is NULL.
+ */
+uint64_t gamma_replay_length(replay_t *r);
+
+/** @brief Gives state of recorded game after given move.
+ * Creates game in state of recorded game after @p n moves, just before
+ * the next move was made, from the nearest checkpoint not later than
+ * move @p n, replaying moves after it.
+ * Journal of the created game is not kept.
+ * @param[in,out] r       – pointer to the reading structure,
+ * @param[in] n           – number of moves.
+ * @return Pointer to the created game, to be deleted with @ref gamma_delete,
+ * or NULL if memory was not allocated, @p n is greater than number
+ * of recorded moves or the recording is not correct.
+ */
+gamma_t *gamma_replay_seek(replay_t *r, uint64_t n);
+
+/** @brief Closes recorded game.
+ * Deletes the reading structure from memory. File is not closed.
+ * Nothing happens if the pointer's value is NULL.
+ * @param[in] r           – pointer to the reading structure.
+ */
+void gamma_replay_close(replay_t *r);
+
+#endif /* GAMMA_REPLAY_H */
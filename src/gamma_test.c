@@ -11,11 +11,15 @@
 #undef NDEBUG
 #endif
 
+#define _POSIX_C_SOURCE 200809L
+
 #include "gamma.h"
+#include "gamma_replay.h"
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 /**
  * Tak ma wyglądać plansza po wykonaniu wszystkich testów.
@@ -32,6 +36,748 @@ static const char board[] =
   "1221......\n"
   "1.........\n";
 
+/** @brief Rozgrywa partię, w której gracz wypada z gry.
+ * Na planszy 5x1 dla 3 graczy, z co najwyżej 2 obszarami każdego z nich,
+ * gracze 1 i 3 wykonują złote ruchy, a gracz 1 wypada z gry po zapytaniu
+ * o jego wolne pola lub o możliwość złotego ruchu, gdy @p golden_query.
+ * Ruchy są zapisywane przez @p r, jeśli nie jest NULL.
+ * Na końcu wolne jest tylko pole (4, 0).
+ * @param[in,out] g        – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in,out] r        – wskaźnik na strukturę zapisującą ruchy lub NULL,
+ * @param[in] golden_query – czy gracz 1 wypada z gry po zapytaniu
+ *                           o możliwość złotego ruchu.
+ */
+static void knock_out(gamma_t *g, recorder_t *r, bool golden_query) {
+  static const gamma_move_record_t moves[] = {
+    {1, 0, 0, GAMMA_MOVE},
+    {2, 1, 0, GAMMA_MOVE},
+    {2, 2, 0, GAMMA_MOVE},
+    {1, 2, 0, GAMMA_MOVE},
+    {3, 3, 0, GAMMA_MOVE},
+    {1, 2, 0, GAMMA_GOLDEN_MOVE},
+    {3, 0, 0, GAMMA_GOLDEN_MOVE},
+  };
+  const gamma_move_record_t *m;
+  uint32_t i;
+  bool executed;
+
+  for (i = 0; i < sizeof(moves) / sizeof(moves[0]); ++i) {
+    m = &moves[i];
+    if (m->kind == GAMMA_MOVE) {
+      executed = r != NULL ? gamma_record_move(r, m->player_id, m->x, m->y)
+                           : gamma_move(g, m->player_id, m->x, m->y);
+    } else {
+      executed = r != NULL ?
+                 gamma_record_golden_move(r, m->player_id, m->x, m->y) :
+                 gamma_golden_move(g, m->player_id, m->x, m->y);
+    }
+    // Pole (2, 0) jest już zajęte przez gracza 2.
+    assert(executed == (i != 3));
+
+    if (m->kind == GAMMA_GOLDEN_MOVE && m->player_id == 1) {
+      // Gracz 1 ma wszystkie obszary i nie ma wolnych pól obok nich,
+      // a tylko zapytanie odświeża jego stan.
+      if (golden_query) {
+        assert(!gamma_golden_possible(g, 1));
+      } else {
+        assert(gamma_free_fields(g, 1) == 0);
+      }
+    }
+  }
+}
+
+/** @brief Testuje cofanie i powtarzanie ruchów.
+ * Sprawdza, czy zapytania o stan gry wykonane pomiędzy cofnięciem
+ * a powtórzeniem ruchu nie uniemożliwiają jego powtórzenia.
+ */
+static void test_undo_redo(void) {
+  gamma_t *g;
+  char *before, *after;
+
+  g = gamma_new(5, 1, 3, 2);
+  assert(g != NULL);
+  assert(!gamma_undo(g));
+  assert(gamma_journal(g, true));
+  assert(!gamma_undo(g));
+  assert(!gamma_redo(g));
+
+  assert(gamma_move(g, 1, 0, 0));
+  assert(gamma_move(g, 2, 1, 0));
+  assert(gamma_move(g, 3, 2, 0));
+  assert(gamma_move(g, 3, 3, 0));
+  assert(gamma_golden_move(g, 1, 2, 0));
+  before = gamma_board(g);
+  assert(before);
+  assert(gamma_move(g, 2, 4, 0));
+  after = gamma_board(g);
+  assert(after);
+
+  assert(gamma_undo(g));
+  assert(gamma_free_fields(g, 1) == 0);
+  assert(gamma_busy_fields(g, 2) == 1);
+  assert(!gamma_move(g, 1, 4, 0));
+  char *p = gamma_board(g);
+  assert(strcmp(p, before) == 0);
+  free(p);
+
+  assert(gamma_redo(g));
+  assert(!gamma_redo(g));
+  assert(gamma_busy_fields(g, 2) == 2);
+  assert(gamma_free_fields(g, 3) == 0);
+  p = gamma_board(g);
+  assert(strcmp(p, after) == 0);
+  free(p);
+
+  assert(gamma_undo(g));
+  assert(gamma_undo(g));
+  assert(gamma_free_fields(g, 3) == 1);
+  assert(gamma_busy_fields(g, 1) == 1);
+  assert(gamma_redo(g));
+  p = gamma_board(g);
+  assert(strcmp(p, before) == 0);
+  free(p);
+
+  // Wykonany ruch uniemożliwia powtórzenie cofniętych ruchów.
+  assert(gamma_undo(g));
+  assert(gamma_move(g, 1, 4, 0));
+  assert(!gamma_redo(g));
+  assert(gamma_undo(g));
+  assert(gamma_busy_fields(g, 1) == 1);
+
+  free(before);
+  free(after);
+  gamma_delete(g);
+}
+
+/** @brief Testuje wykonywanie ciągu ruchów.
+ * Sprawdza, czy ciąg ruchów daje te same wyniki i ten sam stan gry,
+ * co wykonanie ruchów po kolei.
+ */
+static void test_move_batch(void) {
+  static const gamma_move_record_t moves[] = {
+    {1, 0, 0, GAMMA_MOVE},
+    {2, 1, 0, GAMMA_MOVE},
+    {3, 2, 0, GAMMA_MOVE},
+    {3, 3, 0, GAMMA_MOVE},
+    {1, 2, 0, GAMMA_GOLDEN_MOVE},
+    {2, 4, 0, GAMMA_MOVE},
+    {1, 4, 0, GAMMA_MOVE},
+    {4, 0, 0, GAMMA_MOVE},
+    {2, 5, 0, GAMMA_MOVE},
+    {3, 0, 0, GAMMA_GOLDEN_MOVE},
+  };
+  const uint64_t n = sizeof(moves) / sizeof(moves[0]);
+  bool results[sizeof(moves) / sizeof(moves[0])];
+  gamma_t *g, *h;
+  uint64_t i;
+  bool executed;
+
+  g = gamma_new(5, 1, 3, 2);
+  h = gamma_new(5, 1, 3, 2);
+  assert(g != NULL && h != NULL);
+  assert(!gamma_move_batch(NULL, moves, n, results));
+  assert(!gamma_move_batch(g, NULL, n, results));
+  assert(gamma_move_batch(g, moves, 0, NULL));
+  assert(gamma_move_batch(g, moves, n, results));
+
+  for (i = 0; i < n; ++i) {
+    if (moves[i].kind == GAMMA_MOVE) {
+      executed = gamma_move(h, moves[i].player_id, moves[i].x, moves[i].y);
+    } else {
+      executed = gamma_golden_move(h, moves[i].player_id,
+                                   moves[i].x, moves[i].y);
+    }
+    assert(results[i] == executed);
+  }
+  assert(results[4] && !results[6] && !results[7] && !results[8]);
+
+  char *p = gamma_board(g), *q = gamma_board(h);
+  assert(p && q);
+  assert(strcmp(p, q) == 0);
+  assert(gamma_hash(g) == gamma_hash(h));
+  for (i = 1; i <= 3; ++i) {
+    assert(gamma_busy_fields(g, i) == gamma_busy_fields(h, i));
+    assert(gamma_free_fields(g, i) == gamma_free_fields(h, i));
+    assert(gamma_golden_possible(g, i) == gamma_golden_possible(h, i));
+  }
+  free(p);
+  free(q);
+
+  gamma_delete(g);
+  gamma_delete(h);
+}
+
+/** @brief Sprawdza, czy pole jest zaznaczone w mapie bitowej.
+ * @param[in] mask      – mapa bitowa,
+ * @param[in] bit       – numer bitu pola.
+ * @return Wartość @p true, gdy pole jest zaznaczone.
+ */
+static bool marked(const uint64_t *mask, uint64_t bit) {
+  return (mask[bit / 64] >> (bit % 64)) & 1;
+}
+
+/** @brief Testuje mapy bitowe pól, na których gracz może wykonać ruch.
+ * Porównuje mapy całej planszy i jej prostokątów ze sprawdzaniem
+ * poszczególnych pól.
+ */
+static void test_legal_mask(void) {
+  uint64_t all[2], part[2];
+  uint32_t x, y, x0, y0, w, h, player;
+  gamma_t *g;
+
+  g = gamma_new(10, 8, 3, 2);
+  assert(g != NULL);
+  assert(gamma_move(g, 1, 0, 0));
+  assert(gamma_move(g, 1, 1, 0));
+  assert(gamma_move(g, 1, 5, 5));
+  assert(gamma_move(g, 2, 2, 0));
+  assert(gamma_move(g, 2, 2, 1));
+  assert(gamma_move(g, 2, 2, 2));
+  assert(gamma_move(g, 3, 9, 7));
+
+  assert(!gamma_legal_mask(g, 0, GAMMA_MOVE, all));
+  assert(!gamma_legal_mask(g, 1, GAMMA_MOVE, NULL));
+  assert(!gamma_legal_mask_region(g, 1, GAMMA_MOVE, 5, 0, 6, 1, part));
+  assert(!gamma_legal_mask_region(g, 1, GAMMA_MOVE, 0, 0, 0, 1, part));
+
+  for (player = 1; player <= 3; ++player) {
+    assert(gamma_legal_mask(g, player, GAMMA_MOVE, all));
+    for (y = 0; y < 8; ++y) {
+      for (x = 0; x < 10; ++x) {
+        gamma_t *c = gamma_clone(g);
+        assert(c != NULL);
+        assert(marked(all, y * 10 + x) == gamma_move(c, player, x, y));
+        gamma_delete(c);
+      }
+    }
+
+    assert(gamma_legal_mask(g, player, GAMMA_GOLDEN_MOVE, all));
+    for (y = 0; y < 8; ++y) {
+      for (x = 0; x < 10; ++x) {
+        assert(marked(all, y * 10 + x) ==
+               check_golden_move(g, player, x, y));
+      }
+    }
+
+    for (x0 = 0, y0 = 0, w = 10, h = 8; w > 2; x0++, y0++, w -= 3, h -= 2) {
+      assert(gamma_legal_mask_region(g, player, GAMMA_GOLDEN_MOVE,
+                                     x0, y0, w, h, part));
+      for (y = 0; y < h; ++y) {
+        for (x = 0; x < w; ++x) {
+          assert(marked(part, y * w + x) ==
+                 marked(all, (y0 + y) * 10 + x0 + x));
+        }
+      }
+    }
+  }
+
+  gamma_delete(g);
+}
+
+/** @brief Testuje skróty stanu gry.
+ * Sprawdza, czy równe stany mają równe skróty, a stany symetryczne
+ * równe skróty kanoniczne.
+ */
+static void test_hash(void) {
+  gamma_t *g, *h, *r;
+
+  g = gamma_new(6, 4, 2, 3);
+  h = gamma_new(6, 4, 2, 3);
+  r = gamma_new(6, 4, 2, 3);
+  assert(g != NULL && h != NULL && r != NULL);
+  assert(gamma_hash(NULL) == 0);
+  assert(gamma_hash(g) == gamma_hash(h));
+  assert(gamma_canonical_hash(g) == gamma_canonical_hash(h));
+
+  // Te same pola zajęte w innej kolejności.
+  assert(gamma_move(g, 1, 0, 0));
+  assert(gamma_move(g, 2, 1, 3));
+  assert(gamma_move(g, 1, 4, 1));
+  assert(gamma_move(h, 1, 4, 1));
+  assert(gamma_move(h, 1, 0, 0));
+  assert(gamma_move(h, 2, 1, 3));
+  assert(gamma_hash(g) == gamma_hash(h));
+  assert(gamma_canonical_hash(g) == gamma_canonical_hash(h));
+
+  // Odbicie planszy względem pionowej osi.
+  assert(gamma_move(r, 1, 5, 0));
+  assert(gamma_move(r, 2, 4, 3));
+  assert(gamma_move(r, 1, 1, 1));
+  assert(gamma_hash(g) != gamma_hash(r));
+  assert(gamma_canonical_hash(g) == gamma_canonical_hash(r));
+
+  // Złoty ruch zmienia skrót, nawet gdy plansza wygląda tak samo.
+  uint64_t before = gamma_hash(g), canonical = gamma_canonical_hash(g);
+  assert(gamma_golden_move(g, 2, 4, 1));
+  assert(gamma_hash(g) != before);
+  assert(gamma_canonical_hash(g) != canonical);
+  assert(gamma_golden_move(h, 2, 4, 1));
+  assert(gamma_golden_move(r, 2, 1, 1));
+  assert(gamma_hash(g) == gamma_hash(h));
+  assert(gamma_canonical_hash(g) == gamma_canonical_hash(r));
+
+  assert(gamma_journal(g, true));
+  assert(gamma_move(g, 1, 3, 2));
+  assert(gamma_undo(g));
+  assert(gamma_hash(g) == gamma_hash(h));
+  assert(gamma_canonical_hash(g) == gamma_canonical_hash(h));
+
+  gamma_delete(g);
+  gamma_delete(h);
+  gamma_delete(r);
+}
+
+/** @brief Testuje wybór następnego gracza.
+ * Sprawdza, czy gracz, który wypadł z gry po zapytaniu o wolne pola
+ * lub o możliwość złotego ruchu, nie jest wskazywany jako mogący wykonać
+ * ruch, gdy po złotym ruchu ma mniej obszarów niż może.
+ */
+static void test_next_active_player(void) {
+  gamma_t *g;
+  int query;
+
+  for (query = 0; query < 2; ++query) {
+    g = gamma_new(5, 1, 3, 2);
+    assert(g != NULL);
+    assert(gamma_next_active_player(g, 0) == 1);
+    assert(gamma_next_active_player(g, 3) == 1);
+    assert(gamma_next_active_player(g, 1) == 2);
+    assert(gamma_next_active_player(g, 4) == 0);
+
+    knock_out(g, NULL, query == 1);
+
+    // Gracz 1 ma teraz jeden obszar, ale nadal nie może wykonać ruchu.
+    assert(!gamma_move(g, 1, 4, 0));
+    assert(gamma_next_active_player(g, 0) == 2);
+    assert(gamma_next_active_player(g, 3) == 2);
+    assert(!gamma_is_over(g));
+
+    // Plansza jest pełna, tylko gracz 2 ma jeszcze złoty ruch.
+    assert(gamma_move(g, 2, 4, 0));
+    assert(gamma_next_active_player(g, 0) == 2);
+    assert(gamma_golden_move(g, 2, 0, 0));
+    assert(gamma_is_over(g));
+    assert(gamma_next_active_player(g, 0) == 0);
+
+    gamma_delete(g);
+  }
+}
+
+/** @brief Testuje nieudany złoty ruch.
+ * Sprawdza, czy nieudana próba złotego ruchu, tak jak w pierwotnej wersji
+ * silnika, odświeża stan gracza, który przez to wypada z gry.
+ */
+static void test_failed_golden_move(void) {
+  gamma_t *g = gamma_new(3, 3, 3, 1);
+  assert(g != NULL);
+
+  assert(gamma_move(g, 2, 0, 0));
+  assert(gamma_golden_move(g, 1, 0, 0));
+  assert(gamma_move(g, 3, 1, 0));
+  assert(gamma_move(g, 2, 0, 1));
+  assert(!gamma_golden_move(g, 1, 1, 0));
+  assert(gamma_golden_move(g, 2, 0, 0));
+  assert(gamma_busy_fields(g, 1) == 0);
+  assert(!gamma_move(g, 1, 2, 2));
+  assert(gamma_next_active_player(g, 0) == 2);
+
+  gamma_delete(g);
+}
+
+/** @brief Porównuje sprawdzanie złotych ruchów z przeszukiwaniem planszy.
+ * Sprawdza, czy gra @p g, która może mieć indeks punktów artykulacji,
+ * ocenia wszystkie złote ruchy tak jak jej kopia, która przeszukuje obszary,
+ * i czy sprawdzanie nie zmienia stanu gry.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] width   – szerokość planszy,
+ * @param[in] height  – wysokość planszy,
+ * @param[in] players – liczba graczy.
+ */
+static void same_golden_checks(gamma_t *g, uint32_t width, uint32_t height,
+                               uint32_t players) {
+  uint32_t x, y, player;
+  uint64_t hash = gamma_hash(g);
+  gamma_t *c = gamma_clone(g);
+  assert(c != NULL);
+
+  for (player = 1; player <= players; ++player) {
+    for (y = 0; y < height; ++y) {
+      for (x = 0; x < width; ++x) {
+        assert(check_golden_move(g, player, x, y) ==
+               check_golden_move(c, player, x, y));
+      }
+    }
+  }
+
+  assert(gamma_hash(g) == hash);
+  gamma_delete(c);
+}
+
+/** @brief Testuje dzielenie obszarów złotymi ruchami.
+ * Sprawdza, czy złote ruchy rozpoznają cykle i podziały obszarów bez
+ * przeszukiwania planszy, czy oddzielony obszar może być później połączony
+ * z resztą oraz czy cofanie ruchów zachowuje spójność obszarów.
+ */
+static void test_golden_split(void) {
+  static const uint32_t cross[][2] = {
+    {2, 2}, {2, 1}, {2, 0}, {2, 3}, {2, 4}, {1, 2}, {0, 2}, {3, 2}, {4, 2},
+    {1, 1}, {3, 1}, {1, 3}, {3, 3},
+  };
+  uint32_t i;
+  uint64_t mask[1];
+  gamma_t *g = gamma_new(5, 5, 3, 2);
+  assert(g != NULL);
+  assert(gamma_journal(g, true));
+
+  for (i = 0; i < sizeof(cross) / sizeof(cross[0]); ++i) {
+    assert(gamma_move(g, 1, cross[i][0], cross[i][1]));
+  }
+  assert(gamma_move(g, 2, 0, 0));
+  assert(gamma_move(g, 3, 4, 4));
+
+  // Środek leży na cyklu, koniec ramienia nie dzieli obszaru.
+  assert(check_golden_move(g, 2, 2, 2));
+  assert(gamma_golden_move(g, 3, 2, 0));
+  assert(check_golden_move(g, 2, 2, 2));
+  same_golden_checks(g, 5, 5, 3);
+
+  // Indeks punktów artykulacji przestaje obejmować obszary gracza 1,
+  // gdy pole (0, 2) zostaje oddzielone od reszty jego obszaru.
+  assert(gamma_legal_mask(g, 2, GAMMA_GOLDEN_MOVE, mask));
+  same_golden_checks(g, 5, 5, 3);
+  assert(gamma_golden_move(g, 2, 1, 2));
+  assert(gamma_busy_fields(g, 1) == 11);
+  assert(!gamma_move(g, 1, 4, 0));
+  same_golden_checks(g, 5, 5, 3);
+  assert(gamma_move(g, 1, 0, 1));
+  assert(gamma_move(g, 1, 4, 0));
+  assert(!gamma_move(g, 1, 0, 4));
+  same_golden_checks(g, 5, 5, 3);
+
+  assert(gamma_undo(g));
+  assert(gamma_undo(g));
+  assert(gamma_busy_fields(g, 1) == 11);
+  assert(!gamma_move(g, 1, 4, 0));
+  same_golden_checks(g, 5, 5, 3);
+  assert(gamma_undo(g));
+  assert(gamma_busy_fields(g, 1) == 12);
+  assert(gamma_move(g, 1, 4, 0));
+  same_golden_checks(g, 5, 5, 3);
+
+  gamma_delete(g);
+}
+
+/** @brief Testuje opis prostokąta planszy.
+ * Sprawdza, czy opis prostokąta planszy zgadza się z fragmentem opisu
+ * całej planszy i czy nie jest zapisywany do zbyt małego bufora.
+ */
+static void test_board_region(void) {
+  char buf[16];
+  gamma_t *g = gamma_new(4, 3, 2, 2);
+  assert(g != NULL);
+
+  assert(gamma_move(g, 1, 1, 1));
+  assert(gamma_move(g, 2, 2, 2));
+  assert(gamma_board_region(g, 1, 1, 2, 2, buf, 7));
+  assert(strcmp(buf, ".2\n1.\n") == 0);
+  assert(!gamma_board_region(g, 1, 1, 2, 2, buf, 6));
+  assert(!gamma_board_region(g, 3, 1, 2, 2, buf, sizeof(buf)));
+  assert(gamma_board_region(g, 0, 0, 4, 3, buf, sizeof(buf)));
+  assert(strcmp(buf, "..2.\n.1..\n....\n") == 0);
+
+  gamma_delete(g);
+}
+
+/** @brief Testuje odtwarzanie zapisanej gry.
+ * Sprawdza, czy stan gry odtworzony z zapisu, także pomiędzy punktami
+ * kontrolnymi i przy punkcie kontrolnym po każdym ruchu, zgadza się
+ * ze stanem odtworzonym od początku gry i ze stanem gry, która była
+ * zapisywana, również gdy gracz wypadł z gry po zapytaniu o jego wolne
+ * pola, oraz czy zapis z uszkodzonym położeniem indeksu jest odrzucany.
+ */
+static void test_replay(void) {
+  static const uint32_t checkpoints[] = {0, 1, 2, 4};
+  static const unsigned char bad_offsets[][8] = {
+    {0, 0, 0, 0, 0, 0, 0, 0},
+    {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x7F},
+  };
+  unsigned char offset[8];
+  uint64_t hashes[6];
+  uint32_t i, every;
+  uint64_t n;
+  gamma_t *g, *s;
+  recorder_t *r;
+  replay_t *rp;
+  FILE *f;
+
+  for (i = 0; i < sizeof(checkpoints) / sizeof(checkpoints[0]); ++i) {
+    every = checkpoints[i];
+    g = gamma_new(5, 1, 3, 2);
+    f = tmpfile();
+    assert(g != NULL && f != NULL);
+    r = gamma_record_start(g, f, every);
+    assert(r != NULL);
+    knock_out(g, r, false);
+    assert(gamma_record_finish(r));
+
+    rewind(f);
+    rp = gamma_replay_open(f);
+    assert(rp != NULL);
+    assert(gamma_replay_length(rp) == 6);
+    assert(gamma_replay_seek(rp, 7) == NULL);
+
+    // Stany odtwarzane od punktów kontrolnych, także wstecz, są takie same
+    // jak odtworzone od początku gry.
+    for (n = 6; n-- > 0;) {
+      s = gamma_replay_seek(rp, n);
+      assert(s != NULL);
+      assert(gamma_busy_fields(s, 1) == (n == 0 ? 0 : n < 5 ? 1 : 2));
+      if (every == 0) {
+        hashes[n] = gamma_hash(s);
+      }
+      assert(gamma_hash(s) == hashes[n]);
+      gamma_delete(s);
+    }
+
+    s = gamma_replay_seek(rp, 6);
+    assert(s != NULL);
+    assert(gamma_hash(s) == gamma_hash(g));
+    assert(gamma_next_active_player(s, 0) == gamma_next_active_player(g, 0));
+    assert(!gamma_move(s, 1, 4, 0));
+    assert(!gamma_move(g, 1, 4, 0));
+    assert(gamma_move(s, 2, 4, 0));
+    gamma_delete(s);
+    gamma_replay_close(rp);
+
+    // Położenie indeksu zapisane jest na 8 bajtach przed sygnaturą końca.
+    assert(fseeko(f, -12, SEEK_END) == 0);
+    assert(fread(offset, 1, 8, f) == 8);
+    for (n = 0; n < 2; ++n) {
+      assert(fseeko(f, -12, SEEK_END) == 0);
+      assert(fwrite(bad_offsets[n], 1, 8, f) == 8 && fflush(f) == 0);
+      rewind(f);
+      assert(gamma_replay_open(f) == NULL);
+    }
+
+    // Położenie przesunięte o bajt wskazuje na środek indeksu,
+    // a przywrócone pozwala znów otworzyć zapis.
+    for (n = 0; n < 2; ++n) {
+      offset[0] += n == 0 ? 1 : -1;
+      assert(fseeko(f, -12, SEEK_END) == 0);
+      assert(fwrite(offset, 1, 8, f) == 8 && fflush(f) == 0);
+      rewind(f);
+      rp = gamma_replay_open(f);
+      assert((rp != NULL) == (n == 1));
+      gamma_replay_close(rp);
+    }
+
+    fclose(f);
+    gamma_delete(g);
+  }
+}
+
+/** @brief Zapisuje i wczytuje stan gry.
+ * Zapisuje stan gry @p g do potoku i wczytuje go z powrotem.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry.
+ * @return Wskaźnik na wczytaną grę lub NULL, gdy się nie udało.
+ */
+static gamma_t *save_load(gamma_t *g) {
+  int fds[2];
+  gamma_t *h;
+
+  assert(pipe(fds) == 0);
+  assert(gamma_save(g, fds[1]));
+  close(fds[1]);
+  h = gamma_load(fds[0]);
+  close(fds[0]);
+
+  return h;
+}
+
+/** @brief Zapisuje stan gry do pliku tymczasowego.
+ * Zapisuje stan gry @p g do nowego pliku tymczasowego i przewija go
+ * na początek.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[out] size   – liczba bajtów zapisu.
+ * @return Wskaźnik na plik z zapisem.
+ */
+static FILE *save_file(gamma_t *g, off_t *size) {
+  FILE *f = tmpfile();
+
+  assert(f != NULL);
+  assert(gamma_save(g, fileno(f)));
+  *size = lseek(fileno(f), 0, SEEK_CUR);
+  assert(*size > 0 && lseek(fileno(f), 0, SEEK_SET) == 0);
+
+  return f;
+}
+
+/** @brief Testuje zapis i odczyt stanu gry.
+ * Sprawdza, czy wczytana gra ma te same pola, liczniki i skrót co zapisana,
+ * także gdy gracz wypadł z gry, oraz czy uszkodzony zapis jest odrzucany.
+ */
+static void test_save_load(void) {
+  unsigned char snapshot[32 + 13 * 3 + 5];
+  int fds[2];
+  uint32_t player;
+  off_t size, cut;
+  uint32_t i;
+  gamma_t *g, *h;
+  char *p, *q;
+  FILE *f;
+
+  g = gamma_new(5, 1, 3, 2);
+  assert(g != NULL);
+  assert(!gamma_save(NULL, 1));
+  assert(!gamma_save(g, -1));
+  assert(gamma_load(-1) == NULL);
+
+  knock_out(g, NULL, false);
+
+  h = save_load(g);
+  assert(h != NULL);
+  p = gamma_board(g);
+  q = gamma_board(h);
+  assert(p != NULL && q != NULL && strcmp(p, q) == 0);
+  free(p);
+  free(q);
+  assert(gamma_hash(h) == gamma_hash(g));
+  for (player = 1; player <= 3; ++player) {
+    assert(gamma_busy_fields(h, player) == gamma_busy_fields(g, player));
+    assert(gamma_free_fields(h, player) == gamma_free_fields(g, player));
+    assert(gamma_golden_possible(h, player) ==
+           gamma_golden_possible(g, player));
+  }
+  assert(gamma_next_active_player(h, 0) == gamma_next_active_player(g, 0));
+  assert(!gamma_move(h, 1, 4, 0));
+  assert(gamma_move(h, 2, 4, 0));
+  gamma_delete(h);
+
+  // Niepełny zapis o złej sygnaturze.
+  assert(pipe(fds) == 0);
+  assert(write(fds[1], "GMSN", 4) == 4);
+  close(fds[1]);
+  assert(gamma_load(fds[0]) == NULL);
+  close(fds[0]);
+
+  // Zapis ucięty za poprawnym 32-bajtowym nagłówkiem oraz przed ostatnim
+  // polem, z pliku i z potoku, którego długości nie da się sprawdzić.
+  f = save_file(g, &size);
+  assert(size == 32 + 13 * 3 + 5);
+  assert(fread(snapshot, 1, size, f) == (size_t) size);
+  for (i = 0; i < 2; ++i) {
+    cut = i == 0 ? 33 : size - 1;
+    assert(ftruncate(fileno(f), cut) == 0);
+    assert(lseek(fileno(f), 0, SEEK_SET) == 0);
+    assert(gamma_load(fileno(f)) == NULL);
+
+    assert(pipe(fds) == 0);
+    assert(write(fds[1], snapshot, cut) == cut);
+    close(fds[1]);
+    assert(gamma_load(fds[0]) == NULL);
+    close(fds[0]);
+  }
+  fclose(f);
+
+  gamma_delete(g);
+
+  g = gamma_new(40, 30, 300, 4);
+  assert(g != NULL);
+  for (player = 1; player <= 300; ++player) {
+    assert(gamma_move(g, player, player % 40, player / 40 * 3));
+  }
+  assert(gamma_golden_move(g, 1, 2, 0));
+
+  h = save_load(g);
+  assert(h != NULL);
+  assert(gamma_hash(h) == gamma_hash(g));
+  assert(gamma_busy_fields(h, 1) == 2 && gamma_busy_fields(h, 2) == 0);
+  assert(gamma_free_fields(h, 41) == gamma_free_fields(g, 41));
+  gamma_delete(h);
+  gamma_delete(g);
+
+  // Właściciele pól zajmują po 4 bajty, a gracz 65537 zapisany
+  // na 2 bajtach byłby wczytany jako gracz 1.
+  g = gamma_new(20, 20, 70000, 1);
+  assert(g != NULL);
+  assert(gamma_move(g, 65537, 1, 0));
+  assert(gamma_move(g, 70000, 19, 19));
+  assert(gamma_golden_move(g, 1, 1, 0));
+  assert(gamma_move(g, 65537, 2, 0));
+  f = save_file(g, &size);
+  assert(size == 32 + 13 * 70000 + 4 * 20 * 20);
+  h = gamma_load(fileno(f));
+  assert(h != NULL);
+  assert(gamma_hash(h) == gamma_hash(g));
+  assert(gamma_busy_fields(h, 1) == 1 && gamma_busy_fields(h, 65537) == 1);
+  assert(gamma_busy_fields(h, 70000) == 1);
+  assert(!gamma_golden_possible(h, 1));
+  assert(!gamma_move(h, 65537, 4, 0) && gamma_move(h, 1, 0, 0));
+  gamma_delete(h);
+  fclose(f);
+  gamma_delete(g);
+}
+
+/** @brief Testuje kopiowanie gry.
+ * Sprawdza, czy kopia gry ma ten sam stan co oryginał i czy ruchy
+ * wykonane na jednej z nich nie zmieniają drugiej.
+ */
+static void test_clone(void) {
+  gamma_t *g, *c;
+  char *p, *q;
+  uint64_t hash;
+
+  assert(gamma_clone(NULL) == NULL);
+  g = gamma_new(70, 70, 3, 2);
+  assert(g != NULL);
+  assert(gamma_move(g, 1, 0, 0));
+  assert(gamma_move(g, 2, 69, 69));
+  assert(gamma_move(g, 3, 35, 35));
+
+  c = gamma_clone(g);
+  assert(c != NULL);
+  hash = gamma_hash(g);
+  assert(gamma_hash(c) == hash);
+
+  // Pola obu gier leżą w różnych kafelkach tablicy.
+  assert(gamma_move(c, 1, 1, 0));
+  assert(gamma_move(c, 2, 68, 69));
+  assert(gamma_golden_move(c, 3, 0, 0));
+  assert(gamma_hash(g) == hash);
+  assert(gamma_busy_fields(g, 1) == 1 && gamma_busy_fields(c, 1) == 1);
+  assert(gamma_busy_fields(g, 3) == 1 && gamma_busy_fields(c, 3) == 2);
+  assert(gamma_golden_possible(g, 3));
+
+  assert(gamma_move(g, 1, 0, 1));
+  assert(gamma_busy_fields(c, 1) == 1);
+  assert(gamma_move(c, 1, 0, 1));
+  assert(gamma_move(g, 2, 68, 69));
+  assert(gamma_golden_move(g, 3, 1, 0) == false);
+  assert(gamma_move(g, 1, 1, 0));
+  assert(gamma_golden_move(g, 3, 0, 0));
+  assert(gamma_hash(g) == gamma_hash(c));
+
+  p = gamma_board(g);
+  q = gamma_board(c);
+  assert(p != NULL && q != NULL && strcmp(p, q) == 0);
+  free(p);
+  free(q);
+
+  gamma_delete(g);
+  assert(gamma_move(c, 2, 67, 69));
+
+  // Jedyna gra zmienia kafelki w miejscu, a nowa kopia znów je dzieli.
+  g = gamma_clone(c);
+  assert(g != NULL);
+  hash = gamma_hash(c);
+  assert(gamma_move(g, 2, 66, 69));
+  assert(gamma_hash(c) == hash && gamma_busy_fields(c, 2) == 3);
+  assert(gamma_busy_fields(g, 2) == 4);
+  gamma_delete(g);
+  assert(gamma_move(c, 2, 66, 69) && gamma_busy_fields(c, 2) == 4);
+  gamma_delete(c);
+}
+
 /** @brief Testuje silnik gry gamma.
  * Przeprowadza przykładowe testy silnika gry gamma.
  * @return Zero, gdy wszystkie testy przebiegły poprawnie,
@@ -94,5 +840,17 @@ int main() {
   free(p);
 
   gamma_delete(g);
+
+  test_undo_redo();
+  test_move_batch();
+  test_legal_mask();
+  test_clone();
+  test_hash();
+  test_next_active_player();
+  test_failed_golden_move();
+  test_golden_split();
+  test_board_region();
+  test_replay();
+  test_save_load();
   return 0;
 }
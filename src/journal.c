@@ -0,0 +1,201 @@
+/**@file
+ * Implementation of journal of changes of gamma game state.
+ *
+ * @author Antoni Koszowski <a.koszowski@students.mimuw.edu.pl>
+ * @copyright
+ * @date 17.06.2020
+ */
+
+#include <stdlib.h>
+#include "journal.h"
+
+/**
+ * Structure storing journal of changes.
+ * Changes of done steps are followed by changes of steps that can be
+ * redone, and then by pending changes of a move that is not ended yet.
+ */
+struct journal {
+    change_t *changes;      ///< recorded changes
+    uint64_t changes_num;   ///< number of recorded changes
+    uint64_t changes_cap;   ///< number of allocated changes
+    uint64_t *ends;         ///< numbers of changes up to the end of steps
+    uint64_t steps_num;     ///< number of steps that can be undone
+    uint64_t steps_total;   ///< number of steps including undone ones
+    uint64_t steps_cap;     ///< number of allocated steps
+};
+
+journal_t *alloc_journal(void) {
+    return calloc(1, sizeof(struct journal));
+}
+
+void delete_journal(journal_t *j) {
+    if (j == NULL) {
+        return;
+    }
+
+    free(j->changes);
+    free(j->ends);
+    free(j);
+}
+
+/**@brief Gives number of changes of done steps.
+ * Gives number of changes belonging to steps that can be undone
+ * in journal pointed by @p j.
+ * @param[in] j           – pointer to the journal.
+ * @return Number of changes of done steps.
+ */
+static uint64_t done_changes(journal_t *j) {
+    return j->steps_num == 0 ? 0 : j->ends[j->steps_num - 1];
+}
+
+/**@brief Gives number of changes of all steps.
+ * Gives number of changes belonging to steps that can be undone or redone
+ * in journal pointed by @p j, after which pending changes are stored.
+ * @param[in] j           – pointer to the journal.
+ * @return Number of changes of all steps.
+ */
+static uint64_t steps_changes(journal_t *j) {
+    return j->steps_total == 0 ? 0 : j->ends[j->steps_total - 1];
+}
+
+/**@brief Makes room for a change.
+ * Makes sure journal pointed by @p j can hold one more change.
+ * Terminates the program if memory could not be allocated.
+ * @param[in,out] j       – pointer to the journal.
+ */
+static void reserve_change(journal_t *j) {
+    uint64_t new_cap;
+    change_t *new_changes;
+
+    if (j->changes_num == j->changes_cap) {
+        new_cap = j->changes_cap < 32 ? 64 : 2 * j->changes_cap;
+
+        new_changes = realloc(j->changes, sizeof(change_t) * new_cap);
+        if (new_changes == NULL) {
+            exit(1);
+        }
+
+        j->changes = new_changes;
+        j->changes_cap = new_cap;
+    }
+}
+
+/**@brief Fills a change.
+ * Sets up change pointed by @p c.
+ * @param[out] c          – pointer to the change,
+ * @param[in] kind        – kind of the changed value,
+ * @param[in] index       – index of the changed value,
+ * @param[in] value       – value before the change.
+ */
+static void set_change(change_t *c, change_kind_t kind, uint32_t index,
+                       uint64_t value) {
+    c->kind = kind;
+    c->index = index;
+    c->value = value;
+}
+
+void record_change(journal_t *j, change_kind_t kind, uint32_t index,
+                   uint64_t value) {
+    reserve_change(j);
+    set_change(&j->changes[j->changes_num++], kind, index, value);
+}
+
+void record_derived(journal_t *j, change_kind_t kind, uint32_t index,
+                    uint64_t value) {
+    uint64_t i, at;
+
+    // Nothing is undone past the first step, so there is no need to keep it.
+    if (j->steps_num == 0) {
+        return;
+    }
+
+    // Change joins the last done step, ahead of steps that can be redone
+    // and pending changes.
+    reserve_change(j);
+    at = done_changes(j);
+    for (i = j->changes_num; i > at; --i) {
+        j->changes[i] = j->changes[i - 1];
+    }
+    set_change(&j->changes[at], kind, index, value);
+    j->changes_num++;
+
+    for (i = j->steps_num - 1; i < j->steps_total; ++i) {
+        j->ends[i]++;
+    }
+}
+
+void close_step(journal_t *j) {
+    uint64_t i, from, to, new_cap, *new_ends;
+
+    // State differs from the one undone steps were recorded for.
+    if (j->steps_total > j->steps_num) {
+        from = steps_changes(j);
+        to = done_changes(j);
+
+        for (i = from; i < j->changes_num; ++i) {
+            j->changes[to + i - from] = j->changes[i];
+        }
+
+        j->changes_num = to + j->changes_num - from;
+        j->steps_total = j->steps_num;
+    }
+
+    if (j->steps_num == j->steps_cap) {
+        new_cap = j->steps_cap < 32 ? 64 : 2 * j->steps_cap;
+
+        new_ends = realloc(j->ends, sizeof(uint64_t) * new_cap);
+        if (new_ends == NULL) {
+            exit(1);
+        }
+
+        j->ends = new_ends;
+        j->steps_cap = new_cap;
+    }
+
+    j->ends[j->steps_num++] = j->changes_num;
+    j->steps_total = j->steps_num;
+}
+
+void discard_changes(journal_t *j, restore_t restore, void *data) {
+    uint64_t i;
+
+    for (i = j->changes_num; i > steps_changes(j); --i) {
+        restore(data, &j->changes[i - 1]);
+    }
+
+    j->changes_num = steps_changes(j);
+}
+
+bool undo_step(journal_t *j, restore_t restore, void *data) {
+    uint64_t i;
+
+    discard_changes(j, restore, data);
+
+    if (j->steps_num == 0) {
+        return false;
+    }
+
+    j->steps_num--;
+    for (i = j->ends[j->steps_num]; i > done_changes(j); --i) {
+        restore(data, &j->changes[i - 1]);
+    }
+
+    return true;
+}
+
+bool redo_step(journal_t *j, restore_t restore, void *data) {
+    uint64_t i;
+
+    discard_changes(j, restore, data);
+
+    if (j->steps_total == j->steps_num) {
+        return false;
+    }
+
+    for (i = done_changes(j); i < j->ends[j->steps_num]; ++i) {
+        restore(data, &j->changes[i]);
+    }
+    j->steps_num++;
+
+    return true;
+}
@@ -0,0 +1,142 @@
+/**@file
+ * Interface of journal of changes of gamma game state.
+ *
+ * Every change of the state is recorded as its kind, index of the changed
+ * value and the value before the change. Changes are grouped in steps, one
+ * step per executed move. Undoing and redoing a step swaps recorded values
+ * with current ones, so the same record serves both directions. Changes
+ * of a move that was not executed are discarded, so neither failed moves
+ * nor queries prevent redoing undone steps.
+ *
+ * @author Antoni Koszowski <a.koszowski@students.mimuw.edu.pl>
+ * @copyright
+ * @date 17.06.2020
+ */
+
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Kinds of recorded values.
+ */
+typedef enum change_kind {
+    CHANGE_OWNER,           ///< owner of the field with given index
+    CHANGE_NODE,            ///< find&union node of the field
+    CHANGE_REP,             ///< representative of find&union node
+    CHANGE_RANK,            ///< rank of find&union node
+    CHANGE_NODES_NUM,       ///< number of find&union nodes in use
+    CHANGE_IN_GAME,         ///< status in game of player with given number
+    CHANGE_GOLDEN_USED,     ///< whether player used golden move
+    CHANGE_BUSY_AREAS,      ///< number of player's areas
+    CHANGE_BUSY_FIELDS,     ///< number of player's fields
+    CHANGE_BORDER_FIELDS,   ///< number of free fields adjacent to player
+    CHANGE_FREE_FIELDS      ///< number of free fields on board
+} change_kind_t;
+
+/**
+ * Structure representing a single recorded change.
+ */
+typedef struct change {
+    change_kind_t kind;     ///< kind of the changed value
+    uint32_t index;         ///< index of the field, node or player
+    uint64_t value;         ///< value to be restored
+} change_t;
+
+/**
+ * Function restoring recorded value, given data passed to the journal
+ * and pointer to the change, where the replaced value has to be stored.
+ */
+typedef void (*restore_t)(void *data, change_t *c);
+
+/**
+ * Structure storing journal of changes.
+ */
+typedef struct journal journal_t;
+
+/** @brief Creates an empty journal.
+ * Allocates memory for a new journal of changes.
+ * @return Pointer to the newly created structure or NULL in case of
+ * memory was not allocated.
+ */
+journal_t *alloc_journal(void);
+
+/**@brief Deletes a journal.
+ * Deletes from memory journal pointed by @p j.
+ * Nothing happens if the pointer's value is NULL.
+ * @param[in] j           – pointer to structure that will be removed.
+ */
+void delete_journal(journal_t *j);
+
+/**@brief Records a change.
+ * Records in journal pointed by @p j that value of kind @p kind with index
+ * @p index had value @p value before it was changed. The change is pending
+ * until the step is ended or the changes are discarded.
+ * Terminates the program if memory could not be allocated.
+ * @param[in,out] j       – pointer to the journal,
+ * @param[in] kind        – kind of the changed value,
+ * @param[in] index       – index of the changed value,
+ * @param[in] value       – value before the change.
+ */
+void record_change(journal_t *j, change_kind_t kind, uint32_t index,
+                   uint64_t value);
+
+/**@brief Records a change of derived value.
+ * Records like @ref record_change a change of value computed from the rest
+ * of the state, which may happen outside of moves, e.g. while answering
+ * a query. The change becomes part of the last done step at once, so it
+ * is kept even if pending changes are discarded. Change is not recorded
+ * if there is no done step, since nothing could be undone past it.
+ * Terminates the program if memory could not be allocated.
+ * @param[in,out] j       – pointer to the journal,
+ * @param[in] kind        – kind of the changed value,
+ * @param[in] index       – index of the changed value,
+ * @param[in] value       – value before the change.
+ */
+void record_derived(journal_t *j, change_kind_t kind, uint32_t index,
+                    uint64_t value);
+
+/**@brief Ends a step.
+ * Groups changes recorded in journal pointed by @p j since the end
+ * of the previous step into a new step. Steps that could be redone
+ * are forgotten.
+ * Terminates the program if memory could not be allocated.
+ * @param[in,out] j       – pointer to the journal.
+ */
+void close_step(journal_t *j);
+
+/**@brief Discards pending changes.
+ * Restores, using function @p restore with data @p data, values changed
+ * since the end of the last step recorded in journal pointed by @p j,
+ * and forgets these changes.
+ * @param[in,out] j       – pointer to the journal,
+ * @param[in] restore     – function restoring values,
+ * @param[in] data        – data passed to the function.
+ */
+void discard_changes(journal_t *j, restore_t restore, void *data);
+
+/**@brief Undoes the last step.
+ * Discards pending changes and restores, using function @p restore with
+ * data @p data, values changed by the last step recorded in journal
+ * pointed by @p j. The step can be redone afterwards.
+ * @param[in,out] j       – pointer to the journal,
+ * @param[in] restore     – function restoring values,
+ * @param[in] data        – data passed to the function.
+ * @return Value @p true if a step was undone, @p false if there was none.
+ */
+bool undo_step(journal_t *j, restore_t restore, void *data);
+
+/**@brief Redoes the last undone step.
+ * Discards pending changes and restores, using function @p restore with
+ * data @p data, values changed by the last step undone in journal pointed
+ * by @p j.
+ * @param[in,out] j       – pointer to the journal,
+ * @param[in] restore     – function restoring values,
+ * @param[in] data        – data passed to the function.
+ * @return Value @p true if a step was redone, @p false if there was none.
+ */
+bool redo_step(journal_t *j, restore_t restore, void *data);
+
+#endif /* JOURNAL_H */
@@ -0,0 +1,168 @@
+/**@file
+ * Implementation of set of players who may still move in gamma game.
+ *
+ * @author Antoni Koszowski <a.koszowski@students.mimuw.edu.pl>
+ * @copyright
+ * @date 17.06.2020
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "live_set.h"
+
+/**@brief Gives number of words of bits of players.
+ * Gives number of words storing one bit for each of @p players_num players,
+ * numbered from one.
+ * @param[in] players_num – number of players.
+ * @return Number of words.
+ */
+static uint64_t words_num(uint32_t players_num) {
+    return ((uint64_t) players_num + 1 + 63) / 64;
+}
+
+live_set_t *alloc_live_set(uint32_t players_num, uint32_t max_areas) {
+    uint32_t i;
+
+    live_set_t *ls = malloc(sizeof(struct live_set));
+    if (ls == NULL) {
+        return NULL;
+    }
+
+    ls->open = calloc(words_num(players_num), sizeof(uint64_t));
+    ls->live = calloc(words_num(players_num), sizeof(uint64_t));
+    if (ls->open == NULL || ls->live == NULL) {
+        delete_live_set(ls);
+
+        return NULL;
+    }
+
+    ls->players_num = players_num;
+    ls->max_areas = max_areas;
+    ls->open_num = players_num;
+    ls->live_num = players_num;
+
+    // Every player may move at the beginning.
+    for (i = 1; i <= players_num; ++i) {
+        ls->open[i / 64] |= (uint64_t) 1 << (i % 64);
+        ls->live[i / 64] |= (uint64_t) 1 << (i % 64);
+    }
+
+    return ls;
+}
+
+live_set_t *clone_live_set(const live_set_t *ls) {
+    uint64_t words = words_num(ls->players_num);
+
+    live_set_t *copy = malloc(sizeof(struct live_set));
+    if (copy == NULL) {
+        return NULL;
+    }
+
+    *copy = *ls;
+    copy->open = malloc(sizeof(uint64_t) * words);
+    copy->live = malloc(sizeof(uint64_t) * words);
+    if (copy->open == NULL || copy->live == NULL) {
+        delete_live_set(copy);
+
+        return NULL;
+    }
+
+    memcpy(copy->open, ls->open, sizeof(uint64_t) * words);
+    memcpy(copy->live, ls->live, sizeof(uint64_t) * words);
+
+    return copy;
+}
+
+void delete_live_set(live_set_t *ls) {
+    if (ls == NULL) {
+        return;
+    }
+
+    free(ls->open);
+    free(ls->live);
+    free(ls);
+}
+
+/**@brief Sets up membership in a set of bits.
+ * Sets up bit of player @p player_id in @p bits to @p member, updating
+ * number of members pointed by @p num.
+ * @param[in,out] bits    – bits of players,
+ * @param[in,out] num     – pointer to number of members,
+ * @param[in] player_id   – player identifier,
+ * @param[in] member      – whether player is a member.
+ */
+static void set_member(uint64_t *bits, uint32_t *num, uint32_t player_id,
+                       bool member) {
+    uint64_t bit = (uint64_t) 1 << (player_id % 64);
+    bool was_member = (bits[player_id / 64] & bit) != 0;
+
+    if (member && !was_member) {
+        bits[player_id / 64] |= bit;
+        (*num)++;
+    } else if (!member && was_member) {
+        bits[player_id / 64] &= ~bit;
+        (*num)--;
+    }
+}
+
+void update_live_set(live_set_t *ls, uint32_t player_id, const player_t *p) {
+    bool open;
+
+    // Player with all areas taken moves next to them, status in game is
+    // refreshed before such a move. Otherwise it is kept from the last
+    // refresh, so player dropped out of game can not start a new area.
+    if (p->busy_areas < ls->max_areas) {
+        open = p->in_game;
+    } else {
+        open = p->border_fields > 0;
+    }
+
+    set_member(ls->open, &ls->open_num, player_id, open);
+    set_member(ls->live, &ls->live_num, player_id, open || !p->golden_used);
+}
+
+bool open_player(const live_set_t *ls, uint32_t player_id) {
+    return (ls->open[player_id / 64] >> (player_id % 64)) & 1;
+}
+
+/**@brief Gives the first live player in a range.
+ * Gives the smallest live player in set pointed by @p ls, whose identifier
+ * is not smaller than @p from and not bigger than @p to.
+ * @param[in] ls          – pointer to the set,
+ * @param[in] from        – the smallest identifier,
+ * @param[in] to          – the biggest identifier.
+ * @return Identifier of the live player or zero if there is none.
+ */
+static uint32_t first_live(const live_set_t *ls, uint64_t from, uint64_t to) {
+    uint64_t word, bits, found;
+
+    for (word = from / 64; word <= to / 64; ++word) {
+        bits = ls->live[word];
+        if (word == from / 64) {
+            bits &= UINT64_MAX << (from % 64);
+        }
+
+        if (bits != 0) {
+            found = word * 64 + (uint64_t) __builtin_ctzll(bits);
+
+            return found <= to ? (uint32_t) found : 0;
+        }
+    }
+
+    return 0;
+}
+
+uint32_t next_live_player(const live_set_t *ls, uint32_t after) {
+    uint32_t found;
+
+    if (ls->live_num == 0) {
+        return 0;
+    }
+
+    found = first_live(ls, (uint64_t) after + 1, ls->players_num);
+    if (found == 0) {
+        found = first_live(ls, 1, after);
+    }
+
+    return found;
+}
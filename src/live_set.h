@@ -0,0 +1,91 @@
+/**@file
+ * Interface of set of players who may still move in gamma game.
+ *
+ * A player may make a standard move if he has fewer areas than allowed and
+ * is still in game, or all his areas are taken and there are free fields
+ * adjacent to them. A player is live if he may make a standard move or
+ * he has not used golden move yet. Players who are not live will never
+ * move again, other players can move as long as there is a free field
+ * or a feasible target of golden move for them.
+ * Membership is updated whenever a value it depends on changes.
+ *
+ * @author Antoni Koszowski <a.koszowski@students.mimuw.edu.pl>
+ * @copyright
+ * @date 17.06.2020
+ */
+
+#ifndef LIVE_SET_H
+#define LIVE_SET_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "player.h"
+
+/**
+ * Structure storing set of live players.
+ */
+typedef struct live_set {
+    uint32_t players_num;   ///< number of players
+    uint32_t max_areas;     ///< maximal number of areas of a player
+    uint32_t open_num;      ///< number of players who may make standard move
+    uint32_t live_num;      ///< number of live players
+    uint64_t *open;         ///< bits of players who may make standard move
+    uint64_t *live;         ///< bits of live players
+} live_set_t;
+
+/**@brief Creates a set of live players.
+ * Allocates memory for a new set of @p players_num players, who may
+ * occupy at most @p max_areas areas, all of them live.
+ * @param[in] players_num – number of players,
+ * @param[in] max_areas   – maximal number of areas of a player.
+ * @return Pointer to the newly created structure or NULL in case of
+ * memory was not allocated.
+ */
+live_set_t *alloc_live_set(uint32_t players_num, uint32_t max_areas);
+
+/**@brief Copies a set of live players.
+ * Allocates memory for a copy of set pointed by @p ls.
+ * @param[in] ls          – pointer to the copied set.
+ * @return Pointer to the newly created structure or NULL in case of
+ * memory was not allocated.
+ */
+live_set_t *clone_live_set(const live_set_t *ls);
+
+/**@brief Deletes a set of live players.
+ * Deletes from memory set pointed by @p ls.
+ * Nothing happens if the pointer's value is NULL.
+ * @param[in] ls          – pointer to structure that will be removed.
+ */
+void delete_live_set(live_set_t *ls);
+
+/**@brief Updates membership of the player.
+ * Updates membership of player @p player_id, whose state is pointed
+ * by @p p, in set pointed by @p ls.
+ * @param[in,out] ls      – pointer to the set,
+ * @param[in] player_id   – player identifier,
+ * @param[in] p           – pointer to state of the player.
+ */
+void update_live_set(live_set_t *ls, uint32_t player_id, const player_t *p);
+
+/**@brief Checks whether the player may make a standard move.
+ * Checks whether player @p player_id has fewer areas than allowed and
+ * is in game, or has all areas taken and there are free fields adjacent
+ * to them, according to set pointed by @p ls.
+ * @param[in] ls          – pointer to the set,
+ * @param[in] player_id   – player identifier.
+ * @return Value @p true if player may make a standard move, @p false
+ * otherwise.
+ */
+bool open_player(const live_set_t *ls, uint32_t player_id);
+
+/**@brief Gives the next live player.
+ * Gives the first live player in set pointed by @p ls following player
+ * @p after in order of identifiers, wrapping around after the last one,
+ * so that player @p after is given last.
+ * @param[in] ls          – pointer to the set,
+ * @param[in] after       – player identifier or zero to start from the first.
+ * @return Identifier of the next live player or zero if there is none.
+ */
+uint32_t next_live_player(const live_set_t *ls, uint32_t after);
+
+#endif /* LIVE_SET_H */
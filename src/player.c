@@ -38,12 +38,30 @@ player_t **alloc_players(uint32_t players_num) {
         p[i]->golden_used = false;
         p[i]->busy_areas = 0;
         p[i]->free_fields = 0;
+        p[i]->border_fields = 0;
         p[i]->busy_fields = 0;
+        p[i]->golden_version = 0;
+        p[i]->golden_possible = false;
     }
 
     return p;
 }
 
+player_t **copy_players(player_t **p, uint32_t players_num) {
+    uint32_t i;
+    player_t **copy = alloc_players(players_num);
+
+    if (copy == NULL) {
+        return NULL;
+    }
+
+    for (i = 0; i <= players_num; ++i) {
+        *copy[i] = *p[i];
+    }
+
+    return copy;
+}
+
 void delete_players(player_t **p, uint32_t players_num) {
     uint32_t i = players_num;
 
@@ -16,11 +16,14 @@
  * Structure representing single player in gamma game.
  */
 typedef struct player {
-    bool in_game;         ///< depending on that if player can execute some move
-    bool golden_used;     ///< depending on that if player used his golden move
-    uint32_t busy_areas;  ///< number of occupied areas
-    uint64_t busy_fields; ///< number of occupied fields
-    uint64_t free_fields; ///< number of fields which player can still capture
+    bool in_game;           ///< depending on that if player can execute some move
+    bool golden_used;       ///< depending on that if player used his golden move
+    uint32_t busy_areas;    ///< number of occupied areas
+    uint64_t busy_fields;   ///< number of occupied fields
+    uint64_t free_fields;   ///< number of fields which player can still capture
+    uint64_t border_fields; ///< number of free fields adjacent to player's areas
+    uint64_t golden_version; ///< version of game golden_possible is valid for
+    bool golden_possible;   ///< whether golden move was possible in that version
 } player_t;
 
 /** @brief Creates an array storing state of players.
@@ -32,6 +35,16 @@ typedef struct player {
  */
 player_t **alloc_players(uint32_t players_num);
 
+/** @brief Copies an array storing state of players.
+ * Allocates memory for a new array storing state of @p players_num players,
+ * the same as state stored in array @p p.
+ * @param[in] p           – pointer to the copied array,
+ * @param[in] players_num – number of players, whom array is representing.
+ * @return  Pointer to the newly created array or NULL in case of
+ * memory was not allocated.
+ */
+player_t **copy_players(player_t **p, uint32_t players_num);
+
 /**@brief Deletes an array storing state of players.
  * Deletes from memory the array pointed by @p p
  * containing state of @p players_num players.
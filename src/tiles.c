@@ -0,0 +1,104 @@
+/**@file
+ * Implementation of reference-counted tiles of gamma game board.
+ *
+ * @author Antoni Koszowski <a.koszowski@students.mimuw.edu.pl>
+ * @copyright
+ * @date 17.06.2020
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "tiles.h"
+
+tile_t *alloc_tile(size_t elem_size) {
+    tile_t *t = malloc(sizeof(struct tile) + elem_size * TILE_SIZE);
+
+    if (t != NULL) {
+        atomic_init(&t->refs, 1);
+    }
+
+    return t;
+}
+
+tile_t *share_tile(tile_t *t) {
+    atomic_fetch_add_explicit(&t->refs, 1, memory_order_relaxed);
+
+    return t;
+}
+
+void drop_tile(tile_t *t) {
+    if (t == NULL) {
+        return;
+    }
+
+    if (atomic_fetch_sub_explicit(&t->refs, 1, memory_order_acq_rel) == 1) {
+        free(t);
+    }
+}
+
+void *own_tile(tile_t **t, size_t elem_size) {
+    tile_t *copy;
+
+    if (atomic_load_explicit(&(*t)->refs, memory_order_acquire) == 1) {
+        return (*t)->data;
+    }
+
+    copy = alloc_tile(elem_size);
+    if (copy == NULL) {
+        exit(1);
+    }
+
+    memcpy(copy->data, (*t)->data, elem_size * TILE_SIZE);
+    drop_tile(*t);
+    *t = copy;
+
+    return copy->data;
+}
+
+tile_t **alloc_tiles(uint32_t tiles_num, size_t elem_size) {
+    uint32_t i;
+    tile_t **tiles = calloc(tiles_num, sizeof(tile_t *));
+
+    if (tiles == NULL) {
+        return NULL;
+    }
+
+    for (i = 0; i < tiles_num; ++i) {
+        tiles[i] = alloc_tile(elem_size);
+        if (tiles[i] == NULL) {
+            delete_tiles(tiles, i);
+
+            return NULL;
+        }
+    }
+
+    return tiles;
+}
+
+tile_t **share_tiles(tile_t **tiles, uint32_t tiles_num) {
+    uint32_t i;
+    tile_t **shared = malloc(sizeof(tile_t *) * tiles_num);
+
+    if (shared == NULL) {
+        return NULL;
+    }
+
+    for (i = 0; i < tiles_num; ++i) {
+        shared[i] = share_tile(tiles[i]);
+    }
+
+    return shared;
+}
+
+void delete_tiles(tile_t **tiles, uint32_t tiles_num) {
+    uint32_t i;
+
+    if (tiles == NULL) {
+        return;
+    }
+
+    for (i = 0; i < tiles_num; ++i) {
+        drop_tile(tiles[i]);
+    }
+    free(tiles);
+}
@@ -0,0 +1,106 @@
+/**@file
+ * Interface of reference-counted tiles of gamma game board.
+ *
+ * Arrays describing the board are split into tiles of fixed number
+ * of elements. Copies of the board share tiles, counting references
+ * to them, and a shared tile is copied only when it is about to be changed.
+ *
+ * @author Antoni Koszowski <a.koszowski@students.mimuw.edu.pl>
+ * @copyright
+ * @date 17.06.2020
+ */
+
+#ifndef TILES_H
+#define TILES_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Binary logarithm of number of elements in a tile.
+ */
+#define TILE_BITS 12
+
+/**
+ * Number of elements in a tile.
+ */
+#define TILE_SIZE (1u << TILE_BITS)
+
+/**
+ * Mask giving position of element in its tile.
+ */
+#define TILE_MASK (TILE_SIZE - 1)
+
+/**
+ * Structure representing a tile of an array.
+ */
+typedef struct tile {
+    atomic_uint refs;           ///< number of arrays sharing the tile
+    _Alignas(8) unsigned char data[]; ///< elements of the tile
+} tile_t;
+
+/** @brief Creates a tile.
+ * Allocates memory for a new tile of elements of size @p elem_size,
+ * referenced by one array. Elements are not initialized.
+ * @param[in] elem_size   – size of an element.
+ * @return Pointer to the newly created tile or NULL in case of
+ * memory was not allocated.
+ */
+tile_t *alloc_tile(size_t elem_size);
+
+/**@brief Shares a tile.
+ * Adds a reference to tile pointed by @p t.
+ * @param[in,out] t       – pointer to the tile.
+ * @return Pointer to the tile.
+ */
+tile_t *share_tile(tile_t *t);
+
+/**@brief Drops a reference to a tile.
+ * Drops a reference to tile pointed by @p t, deleting it from memory
+ * if it is not referenced anymore.
+ * Nothing happens if the pointer's value is NULL.
+ * @param[in] t           – pointer to the tile.
+ */
+void drop_tile(tile_t *t);
+
+/**@brief Gives elements of the tile that can be changed.
+ * Replaces tile pointed by @p *t, shared by other arrays, with its own
+ * copy, and gives its elements of size @p elem_size.
+ * Terminates the program if memory could not be allocated.
+ * @param[in,out] t       – pointer to pointer to the tile,
+ * @param[in] elem_size   – size of an element.
+ * @return Pointer to elements of the tile.
+ */
+void *own_tile(tile_t **t, size_t elem_size);
+
+/** @brief Creates an array of tiles.
+ * Allocates memory for array of pointers to @p tiles_num tiles, each
+ * of them being a new tile of elements of size @p elem_size.
+ * @param[in] tiles_num   – number of tiles,
+ * @param[in] elem_size   – size of an element.
+ * @return Pointer to the newly created array or NULL in case of
+ * memory was not allocated.
+ */
+tile_t **alloc_tiles(uint32_t tiles_num, size_t elem_size);
+
+/** @brief Shares an array of tiles.
+ * Allocates memory for a new array of pointers to @p tiles_num tiles,
+ * sharing tiles of array @p tiles.
+ * @param[in] tiles       – array of tiles,
+ * @param[in] tiles_num   – number of tiles.
+ * @return Pointer to the newly created array or NULL in case of
+ * memory was not allocated.
+ */
+tile_t **share_tiles(tile_t **tiles, uint32_t tiles_num);
+
+/**@brief Deletes an array of tiles.
+ * Drops references to @p tiles_num tiles of array @p tiles and deletes
+ * the array from memory.
+ * Nothing happens if the pointer's value is NULL.
+ * @param[in] tiles       – array of tiles,
+ * @param[in] tiles_num   – number of tiles.
+ */
+void delete_tiles(tile_t **tiles, uint32_t tiles_num);
+
+#endif /* TILES_H */
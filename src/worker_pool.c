@@ -0,0 +1,56 @@
+/**@file
+ * Implementation of pool of worker threads.
+ *
+ * @author Antoni Koszowski <a.koszowski@students.mimuw.edu.pl>
+ * @copyright
+ * @date 17.06.2020
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <unistd.h>
+#include "worker_pool.h"
+
+uint32_t pool_size(uint64_t tasks, uint64_t per_worker, uint64_t limit) {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    uint64_t workers = tasks / per_worker;
+
+    if (cores < 1) {
+        cores = 1;
+    }
+
+    if (workers > (uint64_t) cores) {
+        workers = (uint64_t) cores;
+    }
+    if (workers > limit) {
+        workers = limit;
+    }
+    if (workers > MAX_WORKERS) {
+        workers = MAX_WORKERS;
+    }
+
+    return workers < 1 ? 1 : (uint32_t) workers;
+}
+
+void run_pool(void *(*work)(void *), void *arg, uint32_t workers) {
+    pthread_t threads[MAX_WORKERS];
+    uint32_t i, started = 0;
+
+    if (workers > MAX_WORKERS) {
+        workers = MAX_WORKERS;
+    }
+
+    // Threads that could not be started are replaced by the calling thread.
+    for (i = 1; i < workers; ++i) {
+        if (pthread_create(&threads[started], NULL, work, arg) == 0) {
+            started++;
+        }
+    }
+
+    work(arg);
+
+    for (i = 0; i < started; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+}
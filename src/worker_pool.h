@@ -0,0 +1,45 @@
+/**@file
+ * Interface of pool of worker threads.
+ *
+ * Work is run by a number of threads, including the calling thread,
+ * which hand out tasks among themselves through the shared argument.
+ * Threads that could not be started are replaced by the calling thread,
+ * so work must not depend on number of threads running it.
+ *
+ * @author Antoni Koszowski <a.koszowski@students.mimuw.edu.pl>
+ * @copyright
+ * @date 17.06.2020
+ */
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <stdint.h>
+
+/**
+ * Maximal number of worker threads, including the calling thread.
+ */
+#define MAX_WORKERS 64
+
+/**@brief Gives number of workers for the work.
+ * Gives number of threads that should run work of @p tasks tasks,
+ * including the calling thread, given that each of them should get
+ * at least @p per_worker tasks. The number is at least 1 and at most
+ * @p limit, number of online cores and @ref MAX_WORKERS.
+ * @param[in] tasks       – number of tasks,
+ * @param[in] per_worker  – positive number of tasks per worker,
+ * @param[in] limit       – maximal number of workers.
+ * @return Number of workers.
+ */
+uint32_t pool_size(uint64_t tasks, uint64_t per_worker, uint64_t limit);
+
+/**@brief Runs work in a pool of threads.
+ * Runs function @p work with argument @p arg in @p workers threads,
+ * including the calling thread, and waits until all of them finish.
+ * @param[in] work        – function run by the threads,
+ * @param[in,out] arg     – argument shared by the threads,
+ * @param[in] workers     – number of threads, at most @ref MAX_WORKERS.
+ */
+void run_pool(void *(*work)(void *), void *arg, uint32_t workers);
+
+#endif /* WORKER_POOL_H */
@@ -0,0 +1,127 @@
+/**@file
+ * Implementation of Zobrist hashing of gamma game board.
+ *
+ * @author Antoni Koszowski <a.koszowski@students.mimuw.edu.pl>
+ * @copyright
+ * @date 17.06.2020
+ */
+
+#include "zobrist.h"
+
+/**
+ * Number of symmetries of a board which is not square.
+ */
+#define RECT_SYMMETRIES 4
+
+/**
+ * Value distinguishing keys of golden moves from keys of fields.
+ */
+#define GOLDEN_SALT UINT64_C(0xd6e8feb86659fd93)
+
+/**@brief Mixes bits of the number.
+ * Gives pseudorandom number determined by @p v, using finalizer
+ * of SplitMix64 generator.
+ * @param[in] v           – mixed number.
+ * @return Mixed number.
+ */
+static uint64_t mix(uint64_t v) {
+    v += UINT64_C(0x9e3779b97f4a7c15);
+    v = (v ^ (v >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+    v = (v ^ (v >> 27)) * UINT64_C(0x94d049bb133111eb);
+
+    return v ^ (v >> 31);
+}
+
+/**@brief Gives key of a piece on the field.
+ * Gives key of piece of player @p owner_id on field with coordinates
+ * @p x, @p y.
+ * @param[in] x           – field x-coordinate,
+ * @param[in] y           – field y-coordinate,
+ * @param[in] owner_id    – owner of the field.
+ * @return Key of the piece.
+ */
+static uint64_t field_key(uint32_t x, uint32_t y, uint32_t owner_id) {
+    return mix(mix(((uint64_t) y << 32) | x) ^ owner_id);
+}
+
+/**@brief Gives number of symmetries of the board.
+ * @param[in] z           – pointer to the hash of the board.
+ * @return Number of symmetries of the board, the identity included.
+ */
+static uint32_t symmetries_num(const zobrist_t *z) {
+    return z->width == z->height ? SYMMETRIES : RECT_SYMMETRIES;
+}
+
+void init_zobrist(zobrist_t *z, uint32_t width, uint32_t height) {
+    z->width = width;
+    z->height = height;
+    z->hash = 0;
+}
+
+void change_field(zobrist_t *z, uint32_t x, uint32_t y, uint32_t old_id,
+                  uint32_t owner_id) {
+    uint64_t place;
+
+    if (old_id == owner_id) {
+        return;
+    }
+
+    // Both keys share mixed coordinates of the field.
+    place = mix(((uint64_t) y << 32) | x);
+    if (old_id != 0) {
+        z->hash ^= mix(place ^ old_id);
+    }
+    if (owner_id != 0) {
+        z->hash ^= mix(place ^ owner_id);
+    }
+}
+
+void add_row(zobrist_t *z, uint32_t y, const uint32_t *owners,
+             uint32_t width) {
+    uint64_t hash = 0;
+    uint32_t x;
+
+    for (x = 0; x < width; ++x) {
+        if (owners[x] != 0) {
+            hash ^= field_key(x, y, owners[x]);
+        }
+    }
+
+    z->hash ^= hash;
+}
+
+void toggle_golden(zobrist_t *z, uint32_t player_id) {
+    z->hash ^= mix(GOLDEN_SALT ^ player_id);
+}
+
+void add_symmetric(const zobrist_t *z, uint64_t *hashes, uint32_t x,
+                   uint32_t y, uint32_t owner_id) {
+    uint32_t i, tx, ty;
+
+    // Symmetries are reflections of columns and rows, followed
+    // by transposition in case of square boards.
+    for (i = 0; i < symmetries_num(z); ++i) {
+        tx = i & 1 ? z->width - 1 - x : x;
+        ty = i & 2 ? z->height - 1 - y : y;
+
+        if (i & 4) {
+            hashes[i] ^= field_key(ty, tx, owner_id);
+        } else {
+            hashes[i] ^= field_key(tx, ty, owner_id);
+        }
+    }
+}
+
+uint64_t canonical_zobrist(const zobrist_t *z, const uint64_t *hashes) {
+    // Keys of golden moves do not depend on symmetries.
+    uint64_t golden = z->hash ^ hashes[0], hash = z->hash;
+    uint32_t i;
+
+    for (i = 1; i < symmetries_num(z); ++i) {
+        if ((hashes[i] ^ golden) < hash) {
+            hash = hashes[i] ^ golden;
+        }
+    }
+
+    return hash;
+}
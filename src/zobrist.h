@@ -0,0 +1,101 @@
+/**@file
+ * Interface of Zobrist hashing of gamma game board.
+ *
+ * Hash of the board is exclusive or of keys of occupied fields, one key
+ * per field and its owner, and keys of players who used golden move.
+ * Keys are computed from coordinates of the field and identifier of the owner
+ * instead of being kept in a table, which would grow with number of players.
+ * Only the plain hash is kept up to date by moves. Hashes of the board
+ * transformed by each symmetry of the board, whose smallest one does not
+ * depend on which of symmetric positions is stored, are computed on demand
+ * from owners of all fields.
+ *
+ * @author Antoni Koszowski <a.koszowski@students.mimuw.edu.pl>
+ * @copyright
+ * @date 17.06.2020
+ */
+
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <stdint.h>
+
+/**
+ * Maximal number of symmetries of a board, reached by square boards.
+ */
+#define SYMMETRIES 8
+
+/**
+ * Structure storing hash of the board.
+ */
+typedef struct zobrist {
+    uint32_t width;                 ///< width of the board
+    uint32_t height;                ///< height of the board
+    uint64_t hash;                  ///< hash of owners and golden moves
+} zobrist_t;
+
+/**@brief Initializes hash of an empty board.
+ * Initializes structure pointed by @p z, so that it stores hash
+ * of an empty board of width @p width and height @p height.
+ * @param[out] z          – pointer to the structure,
+ * @param[in] width       – width of the board,
+ * @param[in] height      – height of the board.
+ */
+void init_zobrist(zobrist_t *z, uint32_t width, uint32_t height);
+
+/**@brief Changes owner of the field.
+ * Replaces in hash pointed by @p z piece of player @p old_id on field
+ * with coordinates @p x, @p y with piece of player @p owner_id. Free field
+ * has no piece, that is when the identifier is zero.
+ * @param[in,out] z       – pointer to the hash,
+ * @param[in] x           – field x-coordinate,
+ * @param[in] y           – field y-coordinate,
+ * @param[in] old_id      – former owner of the field,
+ * @param[in] owner_id    – new owner of the field.
+ */
+void change_field(zobrist_t *z, uint32_t x, uint32_t y, uint32_t old_id,
+                  uint32_t owner_id);
+
+/**@brief Adds pieces of the whole row.
+ * Adds to hash pointed by @p z pieces of players from array @p owners
+ * of @p width owners of fields of row @p y, which were free before.
+ * @param[in,out] z       – pointer to the hash,
+ * @param[in] y           – row y-coordinate,
+ * @param[in] owners      – owners of fields of the row,
+ * @param[in] width       – number of fields of the row.
+ */
+void add_row(zobrist_t *z, uint32_t y, const uint32_t *owners,
+             uint32_t width);
+
+/**@brief Toggles golden move of the player.
+ * Adds to hash pointed by @p z the fact that player @p player_id used
+ * golden move, or removes it if it was added before.
+ * @param[in,out] z       – pointer to the hash,
+ * @param[in] player_id   – player identifier.
+ */
+void toggle_golden(zobrist_t *z, uint32_t player_id);
+
+/**@brief Adds a piece to hashes of transformed boards.
+ * Adds piece of player @p owner_id on field with coordinates @p x, @p y
+ * to array @p hashes of @ref SYMMETRIES hashes of owners of fields of the
+ * board described by @p z, transformed by each of its symmetries.
+ * @param[in] z           – pointer to the hash,
+ * @param[in,out] hashes  – hashes of transformed boards,
+ * @param[in] x           – field x-coordinate,
+ * @param[in] y           – field y-coordinate,
+ * @param[in] owner_id    – positive owner of the field.
+ */
+void add_symmetric(const zobrist_t *z, uint64_t *hashes, uint32_t x,
+                   uint32_t y, uint32_t owner_id);
+
+/**@brief Gives hash not depending on symmetries.
+ * Gives the smallest of hashes of the board described by @p z transformed
+ * by its symmetries, whose owners of fields are hashed in @p hashes with
+ * @ref add_symmetric for all fields, and golden moves like in @p z.
+ * @param[in] z           – pointer to the hash,
+ * @param[in] hashes      – hashes of transformed boards.
+ * @return Canonical hash of the board.
+ */
+uint64_t canonical_zobrist(const zobrist_t *z, const uint64_t *hashes);
+
+#endif /* ZOBRIST_H */